@@ -0,0 +1,218 @@
+﻿/*
+    ██████╗ ███████╗ ██████╗██████╗ ██████╗ 
+    ██╔══██╗██╔════╝██╔════╝██╔══██╗██╔══██╗
+    ██████╔╝█████╗  ██║     ██████╔╝██████╔╝
+    ██╔══██╗██╔══╝  ██║     ██╔═══╝ ██╔═══╝ 
+    ██║  ██║███████╗╚██████╗██║     ██║     
+    ╚═╝  ╚═╝╚══════╝ ╚═════╝╚═╝     ╚═╝     
+* @license : <license placeholder>
+*/
+
+#ifdef __NT__
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#pragma comment (lib, "psapi.lib")
+#else
+#include <sys/resource.h>
+#endif
+
+#include "Bench.h"
+#include "VtableScanner.h"
+#include "ScanState.h"
+#include "Profiler.h"
+#include "IDACalls.h"
+#include <algorithm>
+
+
+// Pipeline phases, in scan order
+static const Bench::phase_t PHASES[] = {
+    { "candidates", { "getVtableMethodsCount", NULL } },
+    { "col",        { "validateCOL", NULL } },
+    { "hierarchy",  { "hierarchy", NULL } },
+    { "slots",      { "slots", NULL } },
+    { "writers",    { "writers", NULL } },
+    { "sizes",      { "sizes", NULL } },
+    { "types",      { "types", NULL } },
+    { "commit",     { "doAddrList", "record" } },
+};
+
+
+bool
+Bench::option (
+    const char *key,
+    qstring *out
+) {
+    const char *options = get_plugin_options ("RECPP");
+    if (options == NULL) {
+        return false;
+    }
+
+    size_t keyLen = strlen (key);
+    for (const char *p = options; *p != '\0'; )
+    {
+        const char *end = strchr (p, ';');
+        if (end == NULL) {
+            end = p + strlen (p);
+        }
+
+        if (strncmp (p, key, keyLen) == 0 && p[keyLen] == '=') {
+            out->clear ();
+            out->append (p + keyLen + 1, end - p - keyLen - 1);
+            return true;
+        }
+
+        p = *end == ';' ? end + 1 : end;
+    }
+
+    return false;
+}
+
+bool
+Bench::requested (
+    void
+) {
+    qstring path;
+    return option ("bench", &path) && !path.empty ();
+}
+
+void
+Bench::memory_kb (
+    uint64 *current,
+    uint64 *peak
+) {
+#ifdef __NT__
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (GetProcessMemoryInfo (GetCurrentProcess (), &pmc, sizeof (pmc))) {
+        *current = pmc.WorkingSetSize / 1024;
+        *peak = pmc.PeakWorkingSetSize / 1024;
+        return;
+    }
+#else
+    struct rusage usage;
+    if (getrusage (RUSAGE_SELF, &usage) == 0) {
+        *current = 0;
+        *peak = usage.ru_maxrss;
+        return;
+    }
+#endif
+
+    *current = *peak = 0;
+}
+
+bool
+Bench::score (
+    const char *manifest,
+    const std::vector<Vtable *> &vtables,
+    uint64 *expected,
+    uint64 *matched
+) {
+    FILE *fp = qfopen (manifest, "r");
+    if (fp == NULL) {
+        return false;
+    }
+
+    std::vector<ea_t> found;
+    for (size_t i = 0; i < vtables.size (); i++) {
+        found.push_back (vtables[i]->getAddress ());
+    }
+    std::sort (found.begin (), found.end ());
+
+    // vftable <class> 0x<address> ...
+    *expected = *matched = 0;
+    char line[1024];
+    while (qfgets (line, sizeof (line), fp) != NULL)
+    {
+        char cls[256];
+        unsigned int address;
+
+        if (strncmp (line, "vftable ", 8) != 0 || sscanf (line + 8, "%255s %x", cls, &address) != 2) {
+            continue;
+        }
+
+        (*expected)++;
+        if (std::binary_search (found.begin (), found.end (), (ea_t) address)) {
+            (*matched)++;
+        }
+    }
+
+    qfclose (fp);
+    return true;
+}
+
+int
+Bench::run (
+    DecMap *decMap
+) {
+    qstring resultPath, manifest;
+    option ("bench", &resultPath);
+    option ("manifest", &manifest);
+
+    // Everything is measured from a cold state
+    ScanState *state = ScanState::get ();
+    state->invalidate ();
+    Profiler::get ()->reset ();
+    IDACalls::reset ();
+
+    uint64 rssBefore, peakBefore;
+    memory_kb (&rssBefore, &peakBefore);
+
+    VtableScanner *scanner = new VtableScanner (decMap);
+    uint64 start = get_nsec_stamp ();
+
+    bool ok = scanner->scan ();
+    if (ok) {
+        PROFILE_SCOPE ("record");
+        state->record (scanner->getVtables ());
+    }
+
+    uint64 elapsed = get_nsec_stamp () - start;
+    uint64 rssAfter, peakAfter;
+    memory_kb (&rssAfter, &peakAfter);
+
+    FILE *fp = qfopen (resultPath.c_str (), "w");
+    if (fp == NULL) {
+        msg ("RECPP: cannot write %s\n", resultPath.c_str ());
+        delete scanner;
+        return 2;
+    }
+
+    qfprintf (fp, "# RECPP benchmark\n");
+    qfprintf (fp, "input %s\n", get_path (PATH_TYPE_IDB));
+    qfprintf (fp, "profiling %d\n", PROFILER_ENABLED ? 1 : 0);
+    qfprintf (fp, "phase total %" FMT_64 "u 1 %" FMT_64 "u\n", elapsed, (uint64) scanner->getVtables ().size ());
+
+    for (size_t i = 0; PROFILER_ENABLED && i < qnumber (PHASES); i++)
+    {
+        uint64 ns = 0, calls = 0, items = 0;
+
+        for (int k = 0; k < BENCH_PHASE_NODES && PHASES[i].nodes[k] != NULL; k++) {
+            uint64 n, c, it;
+            Profiler::get ()->sum (PHASES[i].nodes[k], &n, &c, &it);
+            ns += n;
+            calls += c;
+            items += it;
+        }
+
+        qfprintf (fp, "phase %s %" FMT_64 "u %" FMT_64 "u %" FMT_64 "u\n", PHASES[i].name, ns, calls, items);
+    }
+
+    qfprintf (fp, "metric vftables %d\n", (int) scanner->getVtables ().size ());
+    qfprintf (fp, "metric rss_kb %" FMT_64 "u\n", rssAfter);
+    qfprintf (fp, "metric scan_rss_kb %" FMT_64 "u\n", rssAfter > rssBefore ? rssAfter - rssBefore : 0);
+    qfprintf (fp, "metric peak_rss_kb %" FMT_64 "u\n", peakAfter);
+
+    uint64 expected, matched;
+    if (!manifest.empty () && score (manifest.c_str (), scanner->getVtables (), &expected, &matched)) {
+        qfprintf (fp, "metric expected %" FMT_64 "u\n", expected);
+        qfprintf (fp, "metric matched %" FMT_64 "u\n", matched);
+    }
+
+    qfclose (fp);
+
+    msg ("RECPP: benchmark written to %s (%.3f s)\n", resultPath.c_str (), elapsed / 1e9);
+    delete scanner;
+
+    return ok ? 0 : 1;
+}
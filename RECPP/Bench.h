@@ -0,0 +1,87 @@
+﻿/*
+    ██████╗ ███████╗ ██████╗██████╗ ██████╗ 
+    ██╔══██╗██╔════╝██╔════╝██╔══██╗██╔══██╗
+    ██████╔╝█████╗  ██║     ██████╔╝██████╔╝
+    ██╔══██╗██╔══╝  ██║     ██╔═══╝ ██╔═══╝ 
+    ██║  ██║███████╗╚██████╗██║     ██║     
+    ╚═╝  ╚═╝╚══════╝ ╚═════╝╚═╝     ╚═╝     
+* @license : <license placeholder>
+*/
+
+#pragma once
+
+
+// ---------- Includes ------------
+#include "RECPP.h"
+#include "DecMap.h"
+
+// ---------- Defines -------------
+#define BENCH_PHASE_NODES 2
+
+
+// ------ Class definition --------
+// Batch benchmark of the vftable scan, driven by RECPPBench.
+//
+// Run with idat -A "-ORECPP:bench=<result>;manifest=<ground truth>" on a
+// corpus written by RECPPCorpusGen : once the auto analysis is over, the
+// whole pipeline runs on a fresh scan state and the time of every phase,
+// the process memory and the vftables found against the manifest are
+// written to <result>. Phase times come from the Profiler, a build
+// without RECPP_PROFILING only reports the total.
+class Bench
+{
+public:
+    struct phase_t
+    {
+        const char *name;
+        const char *nodes[BENCH_PHASE_NODES];  // Profiler phases summed into it
+    };
+
+    /*
+     * @brief : Was the plugin started with the bench option ?
+     */
+    static bool
+    requested (
+        void
+    );
+
+    /*
+     * @brief : Scan the database and write the measures
+     * @return The process exit code : 0 on success
+     */
+    static int
+    run (
+        DecMap *decMap
+    );
+
+private:
+    /*
+     * @brief : Get an option of -ORECPP:key=value;key=value
+     */
+    static bool
+    option (
+        const char *key,
+        qstring *out
+    );
+
+    /*
+     * @brief : Current and peak resident size of the process, in KB
+     */
+    static void
+    memory_kb (
+        uint64 *current,
+        uint64 *peak
+    );
+
+    /*
+     * @brief : Count the vftables of the manifest, and how many of them were found
+     * @return false if the manifest can't be read
+     */
+    static bool
+    score (
+        const char *manifest,
+        const std::vector<Vtable *> &vtables,
+        uint64 *expected,
+        uint64 *matched
+    );
+};
@@ -0,0 +1,445 @@
+﻿/*
+    ██████╗ ███████╗ ██████╗██████╗ ██████╗ 
+    ██╔══██╗██╔════╝██╔════╝██╔══██╗██╔══██╗
+    ██████╔╝█████╗  ██║     ██████╔╝██████╔╝
+    ██╔══██╗██╔══╝  ██║     ██╔═══╝ ██╔═══╝ 
+    ██║  ██║███████╗╚██████╗██║     ██║     
+    ╚═╝  ╚═╝╚══════╝ ╚═════╝╚═╝     ╚═╝     
+* @license : <license placeholder>
+*/
+
+#include "CallGraphStore.h"
+#include <algorithm>
+
+CallGraphStore *CallGraphStore::instance = NULL;
+
+
+// Lay out a graph in the image format
+static void
+serialize (
+    const std::vector<ea_t> &nodes,
+    const std::vector<std::vector<uint32> > &callees,
+    bytevec_t *out
+) {
+    size_t edgeCount = 0;
+    for (size_t i = 0; i < callees.size (); i++) {
+        edgeCount += callees[i].size ();
+    }
+
+    CallGraphStore::cgs_header_t header;
+    header.magic      = CGS_MAGIC;
+    header.version    = CGS_VERSION;
+    header.func_count = (uint32) nodes.size ();
+    header.edge_count = (uint32) edgeCount;
+
+    out->clear ();
+    out->reserve (sizeof (header)
+                + nodes.size () * sizeof (uint64)
+                + (nodes.size () + 1) * sizeof (uint32)
+                + edgeCount * sizeof (uint32));
+
+    out->append (&header, sizeof (header));
+
+    for (size_t i = 0; i < nodes.size (); i++) {
+        uint64 ea = nodes[i];
+        out->append (&ea, sizeof (ea));
+    }
+
+    uint32 start = 0;
+    for (size_t i = 0; i <= nodes.size (); i++) {
+        out->append (&start, sizeof (start));
+        if (i < nodes.size ()) {
+            start += (uint32) callees[i].size ();
+        }
+    }
+
+    for (size_t i = 0; i < callees.size (); i++) {
+        if (!callees[i].empty ()) {
+            out->append (&callees[i][0], callees[i].size () * sizeof (uint32));
+        }
+    }
+}
+
+// Map callee addresses to node indexes, dropping the ones that aren't nodes
+static void
+to_indexes (
+    const std::vector<ea_t> &nodes,
+    const std::vector<ea_t> &eas,
+    std::vector<uint32> *out
+) {
+    out->clear ();
+
+    for (size_t i = 0; i < eas.size (); i++) {
+        std::vector<ea_t>::const_iterator it = std::lower_bound (nodes.begin (), nodes.end (), eas[i]);
+        if (it != nodes.end () && *it == eas[i]) {
+            out->push_back ((uint32) (it - nodes.begin ()));
+        }
+    }
+}
+
+
+CallGraphStore::CallGraphStore () {
+    this->header = NULL;
+    this->eas = NULL;
+    this->succ_start = NULL;
+    this->succ = NULL;
+    this->unsaved = false;
+    this->gen = 0;
+}
+
+CallGraphStore *
+CallGraphStore::get (
+    void
+) {
+    if (instance == NULL) {
+        instance = new CallGraphStore ();
+    }
+
+    return instance;
+}
+
+CallGraphStore::~CallGraphStore () {
+    MemStats::account (MEM_CALLGRAPH, &this->memory, 0, 0);
+}
+
+void
+CallGraphStore::update_memory (
+    void
+) {
+    size_t bytes = this->image.size ()
+                 + (this->dirty.size () + this->removed.size ()) * (sizeof (ea_t) + MEM_NODE_OVERHEAD);
+
+    for (ea_callees_map_t::const_iterator it = this->overlay.begin (); it != this->overlay.end (); ++it) {
+        bytes += sizeof (*it) + MEM_NODE_OVERHEAD + it->second.capacity () * sizeof (ea_t);
+    }
+
+    MemStats::account (MEM_CALLGRAPH, &this->memory, bytes, node_count () + this->overlay.size ());
+}
+
+void
+CallGraphStore::term (
+    void
+) {
+    delete instance;
+    instance = NULL;
+}
+
+bool
+CallGraphStore::attach (
+    void
+) {
+    this->header = NULL;
+    this->eas = NULL;
+    this->succ_start = NULL;
+    this->succ = NULL;
+    this->gen++;
+
+    if (this->image.size () < sizeof (cgs_header_t)) {
+        return false;
+    }
+
+    const cgs_header_t *h = (const cgs_header_t *) this->image.begin ();
+    if (h->magic != CGS_MAGIC || h->version != CGS_VERSION) {
+        return false;
+    }
+
+    size_t expected = sizeof (cgs_header_t)
+                    + (size_t) h->func_count * sizeof (uint64)
+                    + ((size_t) h->func_count + 1) * sizeof (uint32)
+                    + (size_t) h->edge_count * sizeof (uint32);
+
+    if (this->image.size () != expected) {
+        return false;
+    }
+
+    const uchar *p = this->image.begin () + sizeof (cgs_header_t);
+    this->eas = (const uint64 *) p;
+    p += h->func_count * sizeof (uint64);
+    this->succ_start = (const uint32 *) p;
+    p += (h->func_count + 1) * sizeof (uint32);
+    this->succ = (const uint32 *) p;
+
+    if (this->succ_start[h->func_count] != h->edge_count) {
+        return false;
+    }
+
+    this->header = h;
+    update_memory ();
+    return true;
+}
+
+bool
+CallGraphStore::load (
+    void
+) {
+    netnode n (CGS_NETNODE_NAME);
+    if (n == BADNODE) {
+        return false;
+    }
+
+    this->image.clear ();
+    if (n.getblob (&this->image, 0, CGS_BLOB_TAG) <= 0) {
+        return false;
+    }
+
+    this->overlay.clear ();
+    this->dirty.clear ();
+    this->removed.clear ();
+    this->unsaved = false;
+
+    if (!attach ()) {
+        msg ("RECPP: stored call graph is invalid or outdated, it will be rebuilt.\n");
+        this->image.clear ();
+        update_memory ();
+        return false;
+    }
+
+    return true;
+}
+
+bool
+CallGraphStore::save (
+    void
+) {
+    compact ();
+
+    if (!is_loaded ()) {
+        return false;
+    }
+
+    netnode n (CGS_NETNODE_NAME, 0, true);
+    n.delblob (0, CGS_BLOB_TAG);
+
+    if (!n.setblob (this->image.begin (), this->image.size (), 0, CGS_BLOB_TAG)) {
+        return false;
+    }
+
+    this->unsaved = false;
+    return true;
+}
+
+void
+CallGraphStore::ensure (
+    void
+) {
+    if (is_loaded ()) {
+        return;
+    }
+
+    if (!load ()) {
+        build ();
+    }
+}
+
+void
+CallGraphStore::walk_callees (
+    func_t *func,
+    std::vector<ea_t> *out
+) {
+    func_item_iterator_t fii;
+    out->clear ();
+
+    for (bool fi_ok = fii.set (func); fi_ok; fi_ok = fii.next_code ())
+    {
+        xrefblk_t xb;
+
+        for (bool xb_ok = xb.first_from (fii.current (), XREF_FAR); xb_ok; xb_ok = xb.next_from ())
+        {
+            if (!xb.iscode) {
+                continue;
+            }
+
+            func_t *f = get_func (xb.to);
+            if (f == NULL || func_contains (func, xb.to)) {
+                continue;
+            }
+
+            out->push_back (f->start_ea);
+        }
+    }
+
+    std::sort (out->begin (), out->end ());
+    out->erase (std::unique (out->begin (), out->end ()), out->end ());
+}
+
+void
+CallGraphStore::build (
+    void
+) {
+    size_t funcCount = get_func_qty ();
+    std::vector<ea_t> nodes;
+    std::vector<std::vector<ea_t> > calleeEas (funcCount);
+
+    nodes.reserve (funcCount);
+
+    for (size_t i = 0; i < funcCount; i++) {
+        func_t *f = getn_func (i);
+        nodes.push_back (f->start_ea);
+        walk_callees (f, &calleeEas[i]);
+    }
+
+    std::vector<std::vector<uint32> > callees (funcCount);
+    for (size_t i = 0; i < funcCount; i++) {
+        to_indexes (nodes, calleeEas[i], &callees[i]);
+    }
+
+    serialize (nodes, callees, &this->image);
+
+    this->overlay.clear ();
+    this->dirty.clear ();
+    this->removed.clear ();
+    this->unsaved = true;
+    attach ();
+}
+
+void
+CallGraphStore::refresh (
+    void
+) {
+    for (std::set<ea_t>::const_iterator it = this->dirty.begin (); it != this->dirty.end (); ++it)
+    {
+        func_t *f = get_func (*it);
+
+        if (f == NULL || f->start_ea != *it) {
+            this->overlay.erase (*it);
+            this->removed.insert (*it);
+            continue;
+        }
+
+        walk_callees (f, &this->overlay[*it]);
+        this->removed.erase (*it);
+    }
+
+    this->dirty.clear ();
+    update_memory ();
+}
+
+void
+CallGraphStore::invalidate (
+    ea_t funcEa
+) {
+    if (is_loaded () && this->dirty.insert (funcEa).second) {
+        update_memory ();
+    }
+}
+
+void
+CallGraphStore::remove (
+    ea_t funcEa
+) {
+    if (!is_loaded ()) {
+        return;
+    }
+
+    this->dirty.erase (funcEa);
+    this->overlay.erase (funcEa);
+    this->removed.insert (funcEa);
+    update_memory ();
+}
+
+int
+CallGraphStore::find_node (
+    ea_t funcEa
+) const {
+    if (this->header == NULL) {
+        return -1;
+    }
+
+    const uint64 *end = this->eas + this->header->func_count;
+    const uint64 *it = std::lower_bound (this->eas, end, (uint64) funcEa);
+
+    if (it == end || *it != funcEa) {
+        return -1;
+    }
+
+    return (int) (it - this->eas);
+}
+
+size_t
+CallGraphStore::callees (
+    ea_t funcEa,
+    std::vector<ea_t> *out
+) {
+    out->clear ();
+
+    if (this->dirty.find (funcEa) != this->dirty.end ()) {
+        refresh ();
+    }
+
+    ea_callees_map_t::const_iterator it = this->overlay.find (funcEa);
+    if (it != this->overlay.end ()) {
+        *out = it->second;
+        return out->size ();
+    }
+
+    if (this->removed.find (funcEa) != this->removed.end ()) {
+        return 0;
+    }
+
+    int n = find_node (funcEa);
+    if (n < 0) {
+        return 0;
+    }
+
+    for (const uint32 *s = succ_begin (n); s != succ_end (n); s++) {
+        out->push_back (node_ea (*s));
+    }
+
+    return out->size ();
+}
+
+void
+CallGraphStore::compact (
+    void
+) {
+    refresh ();
+
+    // Nothing to fold into, a partial graph would be worse than none
+    if (!is_loaded () || (this->overlay.empty () && this->removed.empty ())) {
+        return;
+    }
+
+    // New node set : stored functions still alive, plus the rewalked ones
+    std::vector<ea_t> nodes;
+    for (uint32 i = 0; i < node_count (); i++) {
+        if (this->removed.find (node_ea (i)) == this->removed.end ()) {
+            nodes.push_back (node_ea (i));
+        }
+    }
+    for (ea_callees_map_t::const_iterator it = this->overlay.begin (); it != this->overlay.end (); ++it) {
+        nodes.push_back (it->first);
+    }
+
+    std::sort (nodes.begin (), nodes.end ());
+    nodes.erase (std::unique (nodes.begin (), nodes.end ()), nodes.end ());
+
+    std::vector<std::vector<uint32> > callees (nodes.size ());
+    std::vector<ea_t> calleeEas;
+
+    for (size_t i = 0; i < nodes.size (); i++)
+    {
+        ea_callees_map_t::const_iterator it = this->overlay.find (nodes[i]);
+
+        if (it != this->overlay.end ()) {
+            to_indexes (nodes, it->second, &callees[i]);
+            continue;
+        }
+
+        int n = find_node (nodes[i]);
+        calleeEas.clear ();
+        for (const uint32 *s = succ_begin (n); s != succ_end (n); s++) {
+            calleeEas.push_back (node_ea (*s));
+        }
+
+        to_indexes (nodes, calleeEas, &callees[i]);
+    }
+
+    bytevec_t newImage;
+    serialize (nodes, callees, &newImage);
+    this->image.swap (newImage);
+
+    this->overlay.clear ();
+    this->removed.clear ();
+    this->unsaved = true;
+    attach ();
+}
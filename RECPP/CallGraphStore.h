@@ -0,0 +1,202 @@
+﻿/*
+    ██████╗ ███████╗ ██████╗██████╗ ██████╗ 
+    ██╔══██╗██╔════╝██╔════╝██╔══██╗██╔══██╗
+    ██████╔╝█████╗  ██║     ██████╔╝██████╔╝
+    ██╔══██╗██╔══╝  ██║     ██╔═══╝ ██╔═══╝ 
+    ██║  ██║███████╗╚██████╗██║     ██║     
+    ╚═╝  ╚═╝╚══════╝ ╚═════╝╚═╝     ╚═╝     
+* @license : <license placeholder>
+*/
+
+#pragma once
+
+
+// ---------- Includes ------------
+#include "RECPP.h"
+#include "MemStats.h"
+#include <vector>
+#include <map>
+#include <set>
+
+// ---------- Defines -------------
+#define CGS_NETNODE_NAME "$ RECPP callgraph"
+#define CGS_BLOB_TAG     'C'
+#define CGS_MAGIC        0x53474352 // 'RCGS'
+#define CGS_VERSION      1
+
+
+// ------ Class definition --------
+// Whole-program call graph (direct callees of every function), persisted
+// in the IDB so that it survives sessions.
+//
+// The graph lives in one binary image, which is also the blob stored in the
+// netnode, and is read in place :
+//
+//     cgs_header_t
+//     uint64 eas[func_count]           sorted function start addresses
+//     uint32 succ_start[func_count + 1]
+//     uint32 succ[edge_count]          callee indexes into eas
+//
+// Changes coming from IDB events don't touch the image. Functions are only
+// flagged dirty, rewalked on the next query and kept in an overlay until the
+// next compact () / save ().
+class CallGraphStore
+{
+public:
+    struct cgs_header_t
+    {
+        uint32 magic;
+        uint32 version;
+        uint32 func_count;
+        uint32 edge_count;
+    };
+
+    static CallGraphStore *
+    get (
+        void
+    );
+
+    static void
+    term (
+        void
+    );
+
+    /*
+     * @brief : Load the graph stored in the IDB, with a single blob read
+     * @return false if there is none, or if it has an unknown version
+     */
+    bool
+    load (
+        void
+    );
+
+    /*
+     * @brief : Merge the pending changes and write the graph to the IDB
+     */
+    bool
+    save (
+        void
+    );
+
+    /*
+     * @brief : Walk every function of the database, replacing the current graph
+     */
+    void
+    build (
+        void
+    );
+
+    /*
+     * @brief : Load the graph, or build it if the IDB doesn't have one
+     */
+    void
+    ensure (
+        void
+    );
+
+    /*
+     * @brief : Get the direct callees of a function, rewalking it first if it is dirty
+     * @return The number of callees
+     */
+    size_t
+    callees (
+        ea_t funcEa,
+        std::vector<ea_t> *out
+    );
+
+    /*
+     * @brief : Flag a function as changed, it will be rewalked on the next query
+     */
+    void
+    invalidate (
+        ea_t funcEa
+    );
+
+    /*
+     * @brief : Forget a function that was deleted from the database
+     */
+    void
+    remove (
+        ea_t funcEa
+    );
+
+    /*
+     * @brief : Rewalk the dirty functions and fold the overlay into a new image
+     */
+    void
+    compact (
+        void
+    );
+
+    // Compact view, valid until the next compact ()
+    uint32 node_count () const { return this->header ? this->header->func_count : 0; }
+    uint32 edge_count () const { return this->header ? this->header->edge_count : 0; }
+    ea_t node_ea (uint32 n) const { return (ea_t) this->eas[n]; }
+    const uint32 *succ_begin (uint32 n) const { return this->succ + this->succ_start[n]; }
+    const uint32 *succ_end (uint32 n) const { return this->succ + this->succ_start[n + 1]; }
+
+    /*
+     * @brief : Get the node of a function in the compact view
+     * @return The node, or -1 if the function isn't in the image
+     */
+    int
+    find_node (
+        ea_t funcEa
+    ) const;
+
+    bool is_loaded () const { return this->header != NULL; }
+    bool has_changes () const { return this->unsaved || !this->overlay.empty () || !this->dirty.empty () || !this->removed.empty (); }
+
+    // Bumped every time the compact view changes
+    uint32 generation () const { return this->gen; }
+
+private:
+    CallGraphStore ();
+    ~CallGraphStore ();
+
+    static CallGraphStore *instance;
+
+    // Image, and views into it
+    bytevec_t image;
+    const cgs_header_t *header;
+    const uint64 *eas;
+    const uint32 *succ_start;
+    const uint32 *succ;
+
+    // Changes since the image was built
+    typedef std::map<ea_t, std::vector<ea_t> > ea_callees_map_t;
+    ea_callees_map_t overlay;
+    std::set<ea_t> dirty;
+    std::set<ea_t> removed;
+
+    // The image differs from the blob in the IDB
+    bool unsaved;
+
+    uint32 gen;
+
+    MemStats::held_t memory;
+
+    /*
+     * @brief : Report the current size of the containers to MemStats
+     */
+    void
+    update_memory (
+        void
+    );
+
+    bool
+    attach (
+        void
+    );
+
+    void
+    refresh (
+        void
+    );
+
+    static void
+    walk_callees (
+        func_t *func,
+        std::vector<ea_t> *out
+    );
+};
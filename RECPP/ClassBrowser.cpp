@@ -0,0 +1,353 @@
+﻿/*
+    ██████╗ ███████╗ ██████╗██████╗ ██████╗ 
+    ██╔══██╗██╔════╝██╔════╝██╔══██╗██╔══██╗
+    ██████╔╝█████╗  ██║     ██████╔╝██████╔╝
+    ██╔══██╗██╔══╝  ██║     ██╔═══╝ ██╔═══╝ 
+    ██║  ██║███████╗╚██████╗██║     ██║     
+    ╚═╝  ╚═╝╚══════╝ ╚═════╝╚═╝     ╚═╝     
+* @license : <license placeholder>
+*/
+
+#include "ClassBrowser.h"
+#include "Profiler.h"
+#include <algorithm>
+
+ClassBrowser *ClassBrowser::instance = NULL;
+
+static const int widths[] = {
+    40,
+    8 | CHCOL_DEC,
+    8 | CHCOL_DEC,
+    8 | CHCOL_DEC,
+    10 | CHCOL_HEX,
+    10 | CHCOL_HEX,
+    10 | CHCOL_HEX
+};
+
+static const char *const header[] = {
+    "Class",
+    "Vftables",
+    "Slots",
+    "Bases",
+    "Vftable",
+    "COL",
+    "Type descriptor"
+};
+
+
+// Popup actions of the browser
+
+struct browser_jump_action_t : public action_handler_t
+{
+    ClassBrowser::target_t target;
+
+    browser_jump_action_t (ClassBrowser::target_t t) : target (t) { }
+
+    virtual int idaapi activate (action_activation_ctx_t *ctx) {
+        if (ctx->chooser_selection.empty ()) {
+            return 0;
+        }
+
+        if (!ClassBrowser::jump (ctx->chooser_selection[0], this->target)) {
+            msg ("RECPP: nothing to jump to.\n");
+        }
+        return 1;
+    }
+
+    virtual action_state_t idaapi update (action_update_ctx_t *ctx) {
+        return ctx->widget_type == BWN_CHOOSER && ctx->widget == find_widget (CLASS_BROWSER_TITLE)
+             ? AST_ENABLE_FOR_WIDGET
+             : AST_DISABLE_FOR_WIDGET;
+    }
+};
+
+static browser_jump_action_t jump_col_action (ClassBrowser::TARGET_COL);
+static browser_jump_action_t jump_type_action (ClassBrowser::TARGET_TYPE);
+static browser_jump_action_t jump_ctor_action (ClassBrowser::TARGET_CTOR);
+
+
+ClassBrowser::ClassBrowser (
+    ClassRegistry *registry
+) : chooser_t (CH_KEEP | CH_CAN_REFRESH, qnumber (widths), widths, header, CLASS_BROWSER_TITLE) {
+    this->registry = registry;
+    this->registry_gen = 0;
+    build ();
+}
+
+void
+ClassBrowser::show (
+    ClassRegistry *registry
+) {
+    TWidget *widget = find_widget (CLASS_BROWSER_TITLE);
+    if (widget != NULL && instance != NULL) {
+        activate_widget (widget, true);
+        return;
+    }
+
+    if (instance == NULL) {
+        register_action (ACTION_DESC_LITERAL (
+            "RECPP:BrowserJumpCOL", "Jump to COL",
+            &jump_col_action, NULL, NULL, -1));
+        register_action (ACTION_DESC_LITERAL (
+            "RECPP:BrowserJumpType", "Jump to type descriptor",
+            &jump_type_action, NULL, NULL, -1));
+        register_action (ACTION_DESC_LITERAL (
+            "RECPP:BrowserJumpCtor", "Jump to constructor",
+            &jump_ctor_action, NULL, NULL, -1));
+
+        instance = new ClassBrowser (registry);
+    }
+    else {
+        instance->registry = registry;
+        instance->build ();
+    }
+
+    // Kept alive by CH_KEEP, so the object survives the widget
+    instance->choose ();
+
+    widget = find_widget (CLASS_BROWSER_TITLE);
+    if (widget != NULL) {
+        attach_action_to_popup (widget, NULL, "RECPP:BrowserJumpCOL");
+        attach_action_to_popup (widget, NULL, "RECPP:BrowserJumpType");
+        attach_action_to_popup (widget, NULL, "RECPP:BrowserJumpCtor");
+    }
+}
+
+void
+ClassBrowser::term (
+    void
+) {
+    if (instance == NULL) {
+        return;
+    }
+
+    TWidget *widget = find_widget (CLASS_BROWSER_TITLE);
+    if (widget != NULL) {
+        close_widget (widget, 0);
+    }
+
+    unregister_action ("RECPP:BrowserJumpCtor");
+    unregister_action ("RECPP:BrowserJumpType");
+    unregister_action ("RECPP:BrowserJumpCOL");
+
+    MemStats::account (MEM_REGISTRY, &instance->memory, 0, 0);
+    delete instance;
+    instance = NULL;
+}
+
+void
+ClassBrowser::build (
+    void
+) {
+    PROFILE_SCOPE ("ClassBrowser::build");
+
+    this->rows.clear ();
+    this->members.clear ();
+    this->registry_gen = this->registry->generation ();
+
+    // (type descriptor, class), one per live vftable
+    std::vector<std::pair<ea_t, int> > byType;
+    byType.reserve (this->registry->class_count ());
+
+    for (size_t c = 0; c < this->registry->class_count (); c++)
+    {
+        const ClassRegistry::class_t &cls = this->registry->get_class ((int) c);
+        if (cls.alive) {
+            byType.push_back (std::make_pair (get_dword (cls.col + 12), (int) c));
+        }
+    }
+
+    // Registry classes are in address order, so are the vftables of a row
+    std::stable_sort (byType.begin (), byType.end (), [] (const std::pair<ea_t, int> &a, const std::pair<ea_t, int> &b) {
+        return a.first < b.first;
+    });
+
+    this->members.reserve (byType.size ());
+
+    for (size_t i = 0; i < byType.size (); i++)
+    {
+        if (this->rows.empty () || this->rows.back ().type != byType[i].first) {
+            row_t row = { byType[i].first, (uint32) this->members.size (), 0, 0 };
+            this->rows.push_back (row);
+        }
+
+        row_t &row = this->rows.back ();
+        row.count++;
+        row.slot_count += this->registry->get_class (byType[i].second).slot_count;
+        this->members.push_back (byType[i].second);
+    }
+
+    // Show the classes in the order of their first vftable
+    const std::vector<int> &m = this->members;
+    std::sort (this->rows.begin (), this->rows.end (), [&m] (const row_t &a, const row_t &b) {
+        return m[a.first] < m[b.first];
+    });
+
+    MemStats::account (MEM_REGISTRY, &this->memory,
+                       this->rows.capacity () * sizeof (row_t) + this->members.capacity () * sizeof (int),
+                       this->rows.size ());
+}
+
+int
+ClassBrowser::primary (
+    const row_t &row
+) const {
+    for (uint32 i = 0; i < row.count; i++)
+    {
+        int c = this->members[row.first + i];
+        if (get_dword (this->registry->get_class (c).col + 4) == 0) {
+            return c;
+        }
+    }
+
+    return this->members[row.first];
+}
+
+size_t idaapi
+ClassBrowser::get_count (
+    void
+) const {
+    return this->rows.size ();
+}
+
+void idaapi
+ClassBrowser::get_row (
+    qstrvec_t *cols,
+    int *,
+    chooser_item_attrs_t *,
+    size_t n
+) const {
+    const row_t &row = this->rows[n];
+    const ClassRegistry::class_t &cls = this->registry->get_class (primary (row));
+
+    ea_t chd = get_dword (cls.col + 16);
+
+    (*cols)[0] = cls.name;
+    (*cols)[1].sprnt ("%u", row.count);
+    (*cols)[2].sprnt ("%u", row.slot_count);
+    // The class itself is the first entry of its base class array
+    (*cols)[3].sprnt ("%u", get_dword (chd + 8) - 1);
+    (*cols)[4].sprnt ("%a", cls.vtable);
+    (*cols)[5].sprnt ("%a", cls.col);
+    (*cols)[6].sprnt ("%a", row.type);
+}
+
+ea_t idaapi
+ClassBrowser::get_ea (
+    size_t n
+) const {
+    return get_target (n, TARGET_VFTABLE);
+}
+
+chooser_t::cbret_t idaapi
+ClassBrowser::enter (
+    size_t n
+) {
+    jump (n, TARGET_VFTABLE);
+    return cbret_t (n, NOTHING_CHANGED);
+}
+
+chooser_t::cbret_t idaapi
+ClassBrowser::refresh (
+    ssize_t n
+) {
+    // The registry follows the IDB events, rebuild only when it moved
+    if (this->registry->generation () == this->registry_gen) {
+        return cbret_t (n, NOTHING_CHANGED);
+    }
+
+    build ();
+    return cbret_t (0, ALL_CHANGED);
+}
+
+bool
+ClassBrowser::jump (
+    size_t n,
+    target_t target
+) {
+    if (instance == NULL) {
+        return false;
+    }
+
+    ea_t ea = instance->get_target (n, target);
+    return ea != BADADDR && jumpto (ea);
+}
+
+ea_t
+ClassBrowser::get_target (
+    size_t n,
+    target_t target
+) const {
+    if (n >= this->rows.size ()) {
+        return BADADDR;
+    }
+
+    const row_t &row = this->rows[n];
+    const ClassRegistry::class_t &cls = this->registry->get_class (primary (row));
+    ea_t ea = BADADDR;
+
+    switch (target)
+    {
+        case TARGET_VFTABLE: ea = cls.vtable; break;
+        case TARGET_COL:     ea = cls.col; break;
+        case TARGET_TYPE:    ea = row.type; break;
+        case TARGET_CTOR:    ea = find_constructor (row); break;
+    }
+
+    return ea;
+}
+
+ea_t
+ClassBrowser::find_constructor (
+    const row_t &row
+) const {
+    std::vector<ea_t> slotFuncs;
+    for (uint32 i = 0; i < row.count; i++)
+    {
+        int c = this->members[row.first + i];
+        for (uint32 s = 0; s < this->registry->get_class (c).slot_count; s++) {
+            slotFuncs.push_back (this->registry->slot_func (c, s));
+        }
+    }
+    std::sort (slotFuncs.begin (), slotFuncs.end ());
+
+    ea_t best = BADADDR;
+    int bestCallers = -1;
+    ea_t vtable = this->registry->get_class (primary (row)).vtable;
+
+    xrefblk_t xb;
+    for (bool ok = xb.first_to (vtable, XREF_DATA); ok; ok = xb.next_to ())
+    {
+        func_t *f = get_func (xb.from);
+        if (f == NULL || f->start_ea == best
+         || std::binary_search (slotFuncs.begin (), slotFuncs.end (), f->start_ea)) {
+            continue;
+        }
+
+        // Destructors are called by the deleting destructor, which is a slot
+        int callers = 0;
+        bool fromSlot = false;
+        xrefblk_t cx;
+        for (bool cok = cx.first_to (f->start_ea, XREF_FAR); cok; cok = cx.next_to ())
+        {
+            if (!cx.iscode) {
+                continue;
+            }
+
+            func_t *caller = get_func (cx.from);
+            if (caller != NULL && std::binary_search (slotFuncs.begin (), slotFuncs.end (), caller->start_ea)) {
+                fromSlot = true;
+                break;
+            }
+            callers++;
+        }
+
+        // Most constructors are inlined or called from many places
+        if (!fromSlot && callers > bestCallers) {
+            best = f->start_ea;
+            bestCallers = callers;
+        }
+    }
+
+    return best;
+}
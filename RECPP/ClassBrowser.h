@@ -0,0 +1,132 @@
+﻿/*
+    ██████╗ ███████╗ ██████╗██████╗ ██████╗ 
+    ██╔══██╗██╔════╝██╔════╝██╔══██╗██╔══██╗
+    ██████╔╝█████╗  ██║     ██████╔╝██████╔╝
+    ██╔══██╗██╔══╝  ██║     ██╔═══╝ ██╔═══╝ 
+    ██║  ██║███████╗╚██████╗██║     ██║     
+    ╚═╝  ╚═╝╚══════╝ ╚═════╝╚═╝     ╚═╝     
+* @license : <license placeholder>
+*/
+
+#pragma once
+
+
+// ---------- Includes ------------
+#include "RECPP.h"
+#include "ClassRegistry.h"
+#include "MemStats.h"
+#include <vector>
+
+// ---------- Defines -------------
+#define CLASS_BROWSER_TITLE "RECPP classes"
+
+
+// ------ Class definition --------
+// Chooser listing the classes of the registry, one row per class.
+//
+// Rows only hold indexes into the registry : names and RTTI addresses are
+// read when the chooser asks for a row, so only the visible rows cost
+// anything. Vftables of one class (multiple inheritance) share the type
+// descriptor of their COL, which is what groups them.
+class ClassBrowser : public chooser_t
+{
+public:
+    enum target_t
+    {
+        TARGET_VFTABLE,
+        TARGET_COL,
+        TARGET_TYPE,
+        TARGET_CTOR
+    };
+
+    /*
+     * @brief : Open the browser, or bring it to the front if it is already open
+     */
+    static void
+    show (
+        ClassRegistry *registry
+    );
+
+    /*
+     * @brief : Close the browser, must be called before the registry is deleted
+     */
+    static void
+    term (
+        void
+    );
+
+    /*
+     * @brief : Jump to an address of the class of a row of the open browser
+     * @return false if the class doesn't have one
+     */
+    static bool
+    jump (
+        size_t n,
+        target_t target
+    );
+
+    // chooser_t
+    virtual size_t idaapi get_count () const;
+    virtual void idaapi get_row (qstrvec_t *cols, int *icon, chooser_item_attrs_t *attrs, size_t n) const;
+    virtual ea_t idaapi get_ea (size_t n) const;
+    virtual cbret_t idaapi enter (size_t n);
+    virtual cbret_t idaapi refresh (ssize_t n);
+
+private:
+    ClassBrowser (
+        ClassRegistry *registry
+    );
+
+    static ClassBrowser *instance;
+
+    struct row_t
+    {
+        ea_t type;          // type descriptor shared by the vftables
+        uint32 first;       // range in members
+        uint32 count;
+        uint32 slot_count;  // slots of all the vftables
+    };
+
+    ClassRegistry *registry;
+    uint32 registry_gen;
+
+    std::vector<row_t> rows;
+    std::vector<int> members;   // registry classes, grouped by row
+
+    MemStats::held_t memory;
+
+    /*
+     * @brief : Group the live vftables of the registry by class
+     */
+    void
+    build (
+        void
+    );
+
+    /*
+     * @brief : Get the vftable of the complete object (COL offset 0), or the first one
+     */
+    int
+    primary (
+        const row_t &row
+    ) const;
+
+    /*
+     * @brief : Get an address of the class of a row
+     * @return The address, or BADADDR
+     */
+    ea_t
+    get_target (
+        size_t n,
+        target_t target
+    ) const;
+
+    /*
+     * @brief : Guess the constructor : a function storing the vftable that
+     *          isn't a slot nor called by one (those are the destructors)
+     */
+    ea_t
+    find_constructor (
+        const row_t &row
+    ) const;
+};
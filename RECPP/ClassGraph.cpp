@@ -0,0 +1,312 @@
+﻿/*
+    ██████╗ ███████╗ ██████╗██████╗ ██████╗ 
+    ██╔══██╗██╔════╝██╔════╝██╔══██╗██╔══██╗
+    ██████╔╝█████╗  ██║     ██████╔╝██████╔╝
+    ██╔══██╗██╔══╝  ██║     ██╔═══╝ ██╔═══╝ 
+    ██║  ██║███████╗╚██████╗██║     ██║     
+    ╚═╝  ╚═╝╚══════╝ ╚═════╝╚═╝     ╚═╝     
+* @license : <license placeholder>
+*/
+
+#include "ClassGraph.h"
+#include "Profiler.h"
+#include "IDAUtils.h"
+#include <algorithm>
+
+
+ClassGraph::ClassGraph () {
+    this->registry = NULL;
+    this->source_gen = 0;
+    this->state = GRAPH_EMPTY;
+    this->cursor = 0;
+}
+
+void
+ClassGraph::reset (
+    const ClassRegistry *registry
+) {
+    this->registry = registry;
+    this->source_gen = registry != NULL ? registry->generation () : 0;
+    this->state = registry != NULL ? GRAPH_EDGES : GRAPH_EMPTY;
+    this->cursor = 0;
+
+    this->edges.clear ();
+    this->seen.clear ();
+    this->types.clear ();
+    this->base_counts.clear ();
+    this->child_start.assign (1, 0);
+    this->children.clear ();
+    this->root_nodes.clear ();
+    this->order.clear ();
+    this->sizes.clear ();
+    this->names.clear ();
+
+    update_memory ();
+}
+
+int
+ClassGraph::progress (
+    void
+) const {
+    size_t total = 0;
+
+    switch (this->state)
+    {
+        case GRAPH_EDGES: total = this->registry->class_count (); break;
+        case GRAPH_COUNT:
+        case GRAPH_NAMES: total = this->types.size (); break;
+        case GRAPH_READY: return 100;
+        default: return 0;
+    }
+
+    return total != 0 ? (int) (this->cursor * 100 / total) : 100;
+}
+
+// Add the edges of every class of a base class array
+void
+ClassGraph::read_class (
+    ea_t col
+) {
+    ea_t type = get_dword (col + 12);
+    if (!this->seen.insert (type).second) {
+        // Another vftable of the same class
+        return;
+    }
+
+    ea_t chd = get_dword (col + 16);
+    uint32 count = get_dword (chd + 8);
+    ea_t bca = get_dword (chd + 12);
+
+    if (count == 0 || count > CLASS_GRAPH_MAX_BASES) {
+        this->edges.push_back (std::make_pair (BADADDR, type));
+        return;
+    }
+
+    std::vector<ea_t> entryTypes (count);
+    std::vector<uint32> contained (count);
+
+    for (uint32 i = 0; i < count; i++) {
+        ea_t bcd = get_dword (bca + i * 4);
+        entryTypes[i] = get_dword (bcd);
+        contained[i] = get_dword (bcd + 4);
+    }
+
+    // The class itself, so that it gets a node even without any base
+    this->edges.push_back (std::make_pair (BADADDR, type));
+
+    for (uint32 i = 0; i < count; i++)
+    {
+        uint32 end = i + 1 + contained[i];
+        if (end > count) {
+            end = count;
+        }
+
+        for (uint32 j = i + 1; j < end; j += 1 + contained[j]) {
+            this->edges.push_back (std::make_pair (entryTypes[j], entryTypes[i]));
+        }
+    }
+}
+
+void
+ClassGraph::link (
+    void
+) {
+    PROFILE_SCOPE ("ClassGraph::link");
+
+    this->seen.clear ();
+
+    std::sort (this->edges.begin (), this->edges.end ());
+    this->edges.erase (std::unique (this->edges.begin (), this->edges.end ()), this->edges.end ());
+
+    this->types.clear ();
+    for (size_t i = 0; i < this->edges.size (); i++) {
+        if (this->edges[i].first != BADADDR) {
+            this->types.push_back (this->edges[i].first);
+        }
+        this->types.push_back (this->edges[i].second);
+    }
+
+    std::sort (this->types.begin (), this->types.end ());
+    this->types.erase (std::unique (this->types.begin (), this->types.end ()), this->types.end ());
+
+    int count = (int) this->types.size ();
+    this->base_counts.assign (count, 0);
+    this->child_start.assign (count + 1, 0);
+
+    // Edges are sorted by base, the children come out grouped already
+    this->children.clear ();
+    for (size_t i = 0; i < this->edges.size (); i++)
+    {
+        if (this->edges[i].first == BADADDR) {
+            continue;
+        }
+
+        int base = find_node (this->edges[i].first);
+        int derived = find_node (this->edges[i].second);
+
+        this->child_start[base + 1]++;
+        this->base_counts[derived]++;
+        this->children.push_back (derived);
+    }
+
+    for (int n = 0; n < count; n++) {
+        this->child_start[n + 1] += this->child_start[n];
+    }
+
+    std::vector<std::pair<ea_t, ea_t> > ().swap (this->edges);
+
+    // Kahn, from the roots : a class comes after all of its bases. Corrupted
+    // RTTI with a cycle leaves the nodes of the cycle out, uncounted
+    this->root_nodes.clear ();
+    std::vector<uint32> pending (this->base_counts);
+
+    for (int n = 0; n < count; n++) {
+        if (pending[n] == 0) {
+            this->root_nodes.push_back (n);
+        }
+    }
+
+    this->order.assign (this->root_nodes.begin (), this->root_nodes.end ());
+    for (size_t i = 0; i < this->order.size (); i++) {
+        int n = this->order[i];
+        for (const int *c = children_begin (n); c != children_end (n); c++) {
+            if (--pending[*c] == 0) {
+                this->order.push_back (*c);
+            }
+        }
+    }
+
+    this->sizes.assign (count, 1);
+}
+
+bool
+ClassGraph::step (
+    uint64 deadline
+) {
+    switch (this->state)
+    {
+        case GRAPH_EDGES: {
+            size_t n = 0;
+            while (this->cursor < this->registry->class_count ())
+            {
+                const ClassRegistry::class_t &cls = this->registry->get_class ((int) this->cursor++);
+                if (cls.alive) {
+                    read_class (cls.col);
+                }
+
+                if (++n % 64 == 0 && get_nsec_stamp () >= deadline) {
+                    update_memory ();
+                    return false;
+                }
+            }
+
+            link ();
+            this->state = GRAPH_COUNT;
+            this->cursor = 0;
+            update_memory ();
+        } // fall through
+
+        case GRAPH_COUNT: {
+            // Derived classes first, each one adding its size to its bases
+            while (this->cursor < this->order.size ())
+            {
+                int n = this->order[this->order.size () - 1 - this->cursor++];
+                for (const int *c = children_begin (n); c != children_end (n); c++) {
+                    this->sizes[n] += this->sizes[*c];
+                }
+
+                if (this->cursor % 1024 == 0 && get_nsec_stamp () >= deadline) {
+                    return false;
+                }
+            }
+
+            this->state = GRAPH_NAMES;
+            this->cursor = 0;
+        } // fall through
+
+        case GRAPH_NAMES: {
+            while (this->cursor < this->types.size ())
+            {
+                qstring name = get_name ((int) this->cursor++);
+                this->names.add (name.c_str ());
+
+                if (this->cursor % 64 == 0 && get_nsec_stamp () >= deadline) {
+                    return false;
+                }
+            }
+
+            this->names.finalize ();
+            this->state = GRAPH_READY;
+            this->cursor = 0;
+            update_memory ();
+        } // fall through
+
+        case GRAPH_READY:
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+int
+ClassGraph::find_node (
+    ea_t type
+) const {
+    std::vector<ea_t>::const_iterator it = std::lower_bound (this->types.begin (), this->types.end (), type);
+    if (it == this->types.end () || *it != type) {
+        return -1;
+    }
+
+    return (int) (it - this->types.begin ());
+}
+
+qstring
+ClassGraph::get_name (
+    int n
+) const {
+    char mangled[MAXSTR] = {0};
+    ea_t type = this->types[n];
+
+    // ".?AVA@@" -> "??_R0?AVA@@@8" = A `RTTI Type Descriptor'
+    IDAUtils::GetAsciizStr (type + 8, mangled, sizeof (mangled));
+
+    qstring symbol;
+    symbol.sprnt ("??_R0%s@8", &mangled[1]);
+
+    qstring name;
+    if (demangle_name (&name, symbol.c_str (), MNG_SHORT_FORM) <= 0) {
+        name.sprnt ("%a", type);
+        return name;
+    }
+
+    size_t suffix = name.find (" `RTTI Type Descriptor'");
+    if (suffix != qstring::npos) {
+        name.resize (suffix);
+    }
+
+    return name;
+}
+
+size_t
+ClassGraph::search (
+    const char *text,
+    std::vector<int> *out
+) const {
+    // Name ids are the node ids
+    return this->names.search (text, 0, 0, out);
+}
+
+void
+ClassGraph::update_memory (
+    void
+) {
+    size_t bytes = this->edges.capacity () * sizeof (std::pair<ea_t, ea_t>)
+                 + this->seen.size () * (sizeof (ea_t) + MEM_NODE_OVERHEAD)
+                 + this->types.capacity () * sizeof (ea_t)
+                 + (this->base_counts.capacity () + this->child_start.capacity ()) * sizeof (uint32)
+                 + (this->children.capacity () + this->root_nodes.capacity () + this->order.capacity ()) * sizeof (int)
+                 + this->sizes.capacity () * sizeof (uint64);
+
+    MemStats::account (MEM_REGISTRY, &this->memory, bytes, this->types.size ());
+}
@@ -0,0 +1,180 @@
+﻿/*
+    ██████╗ ███████╗ ██████╗██████╗ ██████╗ 
+    ██╔══██╗██╔════╝██╔════╝██╔══██╗██╔══██╗
+    ██████╔╝█████╗  ██║     ██████╔╝██████╔╝
+    ██╔══██╗██╔══╝  ██║     ██╔═══╝ ██╔═══╝ 
+    ██║  ██║███████╗╚██████╗██║     ██║     
+    ╚═╝  ╚═╝╚══════╝ ╚═════╝╚═╝     ╚═╝     
+* @license : <license placeholder>
+*/
+
+#pragma once
+
+
+// ---------- Includes ------------
+#include "RECPP.h"
+#include "ClassRegistry.h"
+#include "NameIndex.h"
+#include "MemStats.h"
+#include <vector>
+#include <set>
+
+// ---------- Defines -------------
+#define CLASS_GRAPH_MAX_BASES 4096 // sanity limit on numBaseClasses of a CHD
+
+
+// ------ Class definition --------
+// Inheritance graph of the classes of the registry, nodes being the type
+// descriptors and edges going from a base to its direct derived classes.
+//
+// Every base class array lists the whole hierarchy of its class in preorder,
+// each entry followed by its own bases (numContainedBases of them), which is
+// enough to recover the direct bases of every class it contains.
+//
+// The graph is built in steps so that it can be driven from a timer :
+//   GRAPH_EDGES  read the base class arrays (kernel reads)
+//   GRAPH_COUNT  count the size of every subtree, leaves first
+//   GRAPH_NAMES  read and index the class names
+// The children are available once the edges are linked, the subtree sizes
+// and the name search when their step is over.
+class ClassGraph
+{
+public:
+    enum state_t
+    {
+        GRAPH_EMPTY,
+        GRAPH_EDGES,
+        GRAPH_COUNT,
+        GRAPH_NAMES,
+        GRAPH_READY
+    };
+
+    ClassGraph ();
+
+    /*
+     * @brief : Drop the graph and start over from a registry, doesn't read anything
+     */
+    void
+    reset (
+        const ClassRegistry *registry
+    );
+
+    /*
+     * @brief : Build until the deadline
+     * @param deadline : get_nsec_stamp () value to stop at
+     * @return true once the graph is complete
+     */
+    bool
+    step (
+        uint64 deadline
+    );
+
+    state_t get_state () const { return this->state; }
+    bool is_linked () const { return this->state > GRAPH_EDGES; }
+    bool is_counted () const { return this->state > GRAPH_COUNT; }
+    bool has_names () const { return this->state == GRAPH_READY; }
+
+    // Registry generation the graph was built from
+    uint32 source_generation () const { return this->source_gen; }
+
+    /*
+     * @brief : Progress of the current step, in percent
+     */
+    int
+    progress (
+        void
+    ) const;
+
+    int node_count () const { return (int) this->types.size (); }
+    ea_t node_type (int n) const { return this->types[n]; }
+    uint32 base_count (int n) const { return this->base_counts[n]; }
+    const std::vector<int> &roots () const { return this->root_nodes; }
+
+    const int *children_begin (int n) const { return this->children.data () + this->child_start[n]; }
+    const int *children_end (int n) const { return this->children.data () + this->child_start[n + 1]; }
+    uint32 child_count (int n) const { return this->child_start[n + 1] - this->child_start[n]; }
+
+    /*
+     * @brief : Number of nodes of the tree under a node, itself included. A
+     *          class inherited twice is counted twice, like the tree shows it
+     * @return The size, or 0 while it isn't counted yet
+     */
+    uint64 subtree_size (int n) const { return is_counted () ? this->sizes[n] : 0; }
+
+    /*
+     * @brief : Get the node of a type descriptor
+     * @return The node, or -1
+     */
+    int
+    find_node (
+        ea_t type
+    ) const;
+
+    /*
+     * @brief : Demangled class name of a node, read from its type descriptor
+     */
+    qstring
+    get_name (
+        int n
+    ) const;
+
+    /*
+     * @brief : Lowercased class name of a node, as indexed. Needs the names step
+     * @return The name, or NULL if the node isn't indexed
+     */
+    const char *
+    get_lower_name (
+        int n
+    ) const {
+        // Name ids are the node ids
+        return this->names.get_name (n);
+    }
+
+    /*
+     * @brief : Search the nodes whose name contains \text, needs the names step
+     * @return The number of matches
+     */
+    size_t
+    search (
+        const char *text,
+        std::vector<int> *out
+    ) const;
+
+private:
+    const ClassRegistry *registry;
+    uint32 source_gen;
+    state_t state;
+    size_t cursor;
+
+    // Edges step : (base, derived) type descriptors, and the classes already read
+    std::vector<std::pair<ea_t, ea_t> > edges;
+    std::set<ea_t> seen;
+
+    // Linked graph
+    std::vector<ea_t> types;            // sorted type descriptors
+    std::vector<uint32> base_counts;    // direct bases
+    std::vector<uint32> child_start;    // node -> range in children
+    std::vector<int> children;          // direct derived classes
+    std::vector<int> root_nodes;        // classes without base
+    std::vector<int> order;             // topological order, bases first
+    std::vector<uint64> sizes;
+
+    NameIndex names;
+
+    MemStats::held_t memory;
+
+    void
+    read_class (
+        ea_t col
+    );
+
+    void
+    link (
+        void
+    );
+
+    void
+    update_memory (
+        void
+    );
+};
@@ -0,0 +1,300 @@
+﻿/*
+    ██████╗ ███████╗ ██████╗██████╗ ██████╗ 
+    ██╔══██╗██╔════╝██╔════╝██╔══██╗██╔══██╗
+    ██████╔╝█████╗  ██║     ██████╔╝██████╔╝
+    ██╔══██╗██╔══╝  ██║     ██╔═══╝ ██╔═══╝ 
+    ██║  ██║███████╗╚██████╗██║     ██║     
+    ╚═╝  ╚═╝╚══════╝ ╚═════╝╚═╝     ╚═╝     
+* @license : <license placeholder>
+*/
+
+#include "ClassRegistry.h"
+#include "FuncIndex.h"
+#include <algorithm>
+
+
+ClassRegistry::ClassRegistry () {
+    this->gen = 0;
+}
+
+ClassRegistry::~ClassRegistry () {
+    MemStats::account (MEM_REGISTRY, &this->memory, 0, 0);
+}
+
+// Every slot is in exactly one list of by_func or in unresolved, so the
+// estimate doesn't need to walk them
+void
+ClassRegistry::update_memory (
+    void
+) {
+    size_t bytes = this->classes.capacity () * sizeof (class_t)
+                 + this->slots.capacity () * sizeof (ea_t)
+                 + this->funcs.capacity () * sizeof (ea_t)
+                 + this->slot_class.capacity () * sizeof (int)
+                 + this->by_vtable.size () * (sizeof (std::pair<ea_t, int>) + MEM_NODE_OVERHEAD)
+                 + this->by_func.size () * (sizeof (std::pair<ea_t, std::vector<uint32> >) + MEM_NODE_OVERHEAD)
+                 + this->slots.size () * sizeof (uint32)
+                 + this->unresolved.capacity () * sizeof (uint32);
+
+    MemStats::account (MEM_REGISTRY, &this->memory, bytes, this->classes.size ());
+}
+
+void
+ClassRegistry::clear (
+    void
+) {
+    this->classes.clear ();
+    this->slots.clear ();
+    this->funcs.clear ();
+    this->slot_class.clear ();
+    this->by_vtable.clear ();
+    this->by_func.clear ();
+    this->unresolved.clear ();
+    this->gen++;
+    update_memory ();
+}
+
+void
+ClassRegistry::build (
+    const std::vector<Vtable *> &vtables
+) {
+    clear ();
+
+    // One kernel walk for every function, instead of a get_func per slot
+    FuncIndex::get ()->ensure ();
+
+    this->classes.reserve (vtables.size ());
+
+    for (size_t v = 0; v < vtables.size (); v++)
+    {
+        class_t c;
+        c.vtable     = vtables[v]->getAddress ();
+        c.col        = get_dword (c.vtable - 4);
+        c.name       = vtables[v]->getName ();
+        c.first_slot = (uint32) this->slots.size ();
+        c.slot_count = (uint32) vtables[v]->getMethodsCount ();
+        c.alive      = true;
+
+        int id = (int) this->classes.size ();
+        this->classes.push_back (c);
+        this->by_vtable[c.vtable] = id;
+
+        for (uint32 i = 0; i < c.slot_count; i++) {
+            this->slots.push_back (get_dword (c.vtable + i * 4));
+            this->funcs.push_back (BADADDR);
+            this->slot_class.push_back (id);
+            link ((uint32) this->slots.size () - 1);
+        }
+    }
+
+    update_memory ();
+}
+
+// Resolve the function of a slot and add it to the reverse index
+void
+ClassRegistry::link (
+    uint32 s
+) {
+    ea_t func = FuncIndex::get ()->func_start (this->slots[s]);
+    this->funcs[s] = func;
+
+    if (func != BADADDR) {
+        this->by_func[func].push_back (s);
+    }
+    else {
+        this->unresolved.push_back (s);
+    }
+}
+
+void
+ClassRegistry::unlink (
+    uint32 s
+) {
+    std::vector<uint32> *list = &this->unresolved;
+
+    std::map<ea_t, std::vector<uint32> >::iterator it = this->by_func.find (this->funcs[s]);
+    if (this->funcs[s] != BADADDR && it != this->by_func.end ()) {
+        list = &it->second;
+    }
+
+    std::vector<uint32>::iterator pos = std::find (list->begin (), list->end (), s);
+    if (pos != list->end ()) {
+        list->erase (pos);
+    }
+
+    if (list != &this->unresolved && list->empty ()) {
+        this->by_func.erase (it);
+    }
+
+    this->funcs[s] = BADADDR;
+}
+
+int
+ClassRegistry::find_class (
+    ea_t vtable
+) const {
+    std::map<ea_t, int>::const_iterator it = this->by_vtable.find (vtable);
+    if (it == this->by_vtable.end () || !this->classes[it->second].alive) {
+        return -1;
+    }
+
+    return it->second;
+}
+
+size_t
+ClassRegistry::find_slots (
+    ea_t funcEa,
+    std::vector<slot_ref_t> *out
+) const {
+    out->clear ();
+
+    std::map<ea_t, std::vector<uint32> >::const_iterator it = this->by_func.find (funcEa);
+    if (it == this->by_func.end ()) {
+        return 0;
+    }
+
+    for (size_t i = 0; i < it->second.size (); i++)
+    {
+        uint32 s = it->second[i];
+        int c = this->slot_class[s];
+
+        if (this->classes[c].alive) {
+            slot_ref_t ref = { c, s - this->classes[c].first_slot };
+            out->push_back (ref);
+        }
+    }
+
+    return out->size ();
+}
+
+void
+ClassRegistry::on_renamed (
+    ea_t ea
+) {
+    int c = find_class (ea);
+    if (c < 0) {
+        return;
+    }
+
+    // Same name as the scan gives to a new vftable
+    qstring name = get_short_name (ea);
+    char *className = name.begin ();
+
+    if (className != NULL) {
+        Vtable::filterClassName (&className, NULL);
+        this->classes[c].name = className;
+    }
+    else {
+        this->classes[c].name.clear ();
+    }
+
+    this->gen++;
+}
+
+void
+ClassRegistry::on_data_changed (
+    ea_t ea,
+    asize_t size
+) {
+    if (this->by_vtable.empty ()) {
+        return;
+    }
+
+    // The closest vftable starting before the end of the change
+    std::map<ea_t, int>::const_iterator it = this->by_vtable.lower_bound (ea + size);
+
+    while (it != this->by_vtable.begin ())
+    {
+        --it;
+        class_t &c = this->classes[it->second];
+        ea_t end = c.vtable + c.slot_count * 4;
+
+        if (end <= ea) {
+            // Tables don't overlap, nothing before this one can be touched
+            break;
+        }
+
+        if (!c.alive) {
+            continue;
+        }
+
+        for (uint32 i = 0; i < c.slot_count; i++)
+        {
+            uint32 s = c.first_slot + i;
+            ea_t slotEa = c.vtable + i * 4;
+
+            if (slotEa + 4 <= ea || slotEa >= ea + size) {
+                continue;
+            }
+
+            ea_t target = get_dword (slotEa);
+            if (target != this->slots[s]) {
+                unlink (s);
+                this->slots[s] = target;
+                link (s);
+                this->gen++;
+            }
+        }
+    }
+
+    update_memory ();
+}
+
+void
+ClassRegistry::on_undefined (
+    ea_t ea1,
+    ea_t ea2
+) {
+    std::map<ea_t, int>::const_iterator it = this->by_vtable.lower_bound (ea1);
+
+    for (; it != this->by_vtable.end () && it->first < ea2; ++it) {
+        if (this->classes[it->second].alive) {
+            this->classes[it->second].alive = false;
+            this->gen++;
+        }
+    }
+}
+
+void
+ClassRegistry::on_func_added (
+    func_t *pfn
+) {
+    // Only the slots pointing outside of any function can move into it
+    std::vector<uint32> pending;
+    pending.swap (this->unresolved);
+
+    for (size_t i = 0; i < pending.size (); i++)
+    {
+        uint32 s = pending[i];
+
+        if (pfn->contains (this->slots[s])) {
+            this->funcs[s] = pfn->start_ea;
+            this->by_func[pfn->start_ea].push_back (s);
+            this->gen++;
+        }
+        else {
+            this->unresolved.push_back (s);
+        }
+    }
+
+    update_memory ();
+}
+
+void
+ClassRegistry::on_func_deleted (
+    func_t *pfn
+) {
+    std::map<ea_t, std::vector<uint32> >::iterator it = this->by_func.find (pfn->start_ea);
+    if (it == this->by_func.end ()) {
+        return;
+    }
+
+    for (size_t i = 0; i < it->second.size (); i++) {
+        this->funcs[it->second[i]] = BADADDR;
+        this->unresolved.push_back (it->second[i]);
+    }
+
+    this->by_func.erase (it);
+    this->gen++;
+    update_memory ();
+}
@@ -0,0 +1,163 @@
+﻿/*
+    ██████╗ ███████╗ ██████╗██████╗ ██████╗ 
+    ██╔══██╗██╔════╝██╔════╝██╔══██╗██╔══██╗
+    ██████╔╝█████╗  ██║     ██████╔╝██████╔╝
+    ██╔══██╗██╔══╝  ██║     ██╔═══╝ ██╔═══╝ 
+    ██║  ██║███████╗╚██████╗██║     ██║     
+    ╚═╝  ╚═╝╚══════╝ ╚═════╝╚═╝     ╚═╝     
+* @license : <license placeholder>
+*/
+
+#pragma once
+
+
+// ---------- Includes ------------
+#include "RECPP.h"
+#include "Vtable.h"
+#include "MemStats.h"
+#include <vector>
+#include <map>
+
+// ---------- Defines -------------
+
+
+// ------ Class definition --------
+// Live view of the classes found by the vftable scan.
+//
+// Classes and their slots are stored column-wise : one record per class,
+// and every slot target in a single flat array, the slots of class c being
+// slot_target[first_slot .. first_slot + slot_count]. Two indexes go back
+// from an address to the class owning a vftable and to the slots pointing
+// into a function.
+//
+// The registry is built from a scan, then kept up to date by the IDB
+// events (see the on_* methods) so that queries don't need a new scan.
+class ClassRegistry
+{
+public:
+    struct class_t
+    {
+        ea_t vtable;
+        ea_t col;           // complete object locator, read at build time
+        qstring name;
+        uint32 first_slot;
+        uint32 slot_count;
+        bool alive;         // false once the vftable was undefined
+    };
+
+    struct slot_ref_t
+    {
+        int cls;
+        uint32 index;       // slot index in the class
+    };
+
+    ClassRegistry ();
+    ~ClassRegistry ();
+
+    /*
+     * @brief : Replace the content of the registry by the result of a scan
+     */
+    void
+    build (
+        const std::vector<Vtable *> &vtables
+    );
+
+    void
+    clear (
+        void
+    );
+
+    size_t class_count () const { return this->classes.size (); }
+    const class_t &get_class (int c) const { return this->classes[c]; }
+    ea_t slot_target (int c, uint32 i) const { return this->slots[this->classes[c].first_slot + i]; }
+    ea_t slot_func (int c, uint32 i) const { return this->funcs[this->classes[c].first_slot + i]; }
+
+    // Bumped on every change
+    uint32 generation () const { return this->gen; }
+
+    /*
+     * @brief : Get the class of a vftable
+     * @return The class, or -1
+     */
+    int
+    find_class (
+        ea_t vtable
+    ) const;
+
+    /*
+     * @brief : Get the slots pointing into a function
+     * @return The number of slots
+     */
+    size_t
+    find_slots (
+        ea_t funcEa,
+        std::vector<slot_ref_t> *out
+    ) const;
+
+    // IDB event updates
+
+    void
+    on_renamed (
+        ea_t ea
+    );
+
+    /*
+     * @brief : Bytes or items changed in [ea, ea + size), reread the slots there
+     */
+    void
+    on_data_changed (
+        ea_t ea,
+        asize_t size
+    );
+
+    /*
+     * @brief : Items were undefined in [ea1, ea2), drop the classes whose vftable starts there
+     */
+    void
+    on_undefined (
+        ea_t ea1,
+        ea_t ea2
+    );
+
+    void
+    on_func_added (
+        func_t *pfn
+    );
+
+    void
+    on_func_deleted (
+        func_t *pfn
+    );
+
+private:
+    std::vector<class_t> classes;
+    std::vector<ea_t> slots;        // slot targets
+    std::vector<ea_t> funcs;        // start of the function of each target, or BADADDR
+    std::vector<int>  slot_class;   // owner of each slot
+
+    std::map<ea_t, int> by_vtable;
+    std::map<ea_t, std::vector<uint32> > by_func;   // function -> slots
+    std::vector<uint32> unresolved;                 // slots pointing outside of any function
+
+    uint32 gen;
+
+    MemStats::held_t memory;
+
+    /*
+     * @brief : Report the current size of the containers to MemStats
+     */
+    void
+    update_memory (
+        void
+    );
+
+    void
+    link (
+        uint32 s
+    );
+
+    void
+    unlink (
+        uint32 s
+    );
+};
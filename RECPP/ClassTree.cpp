@@ -0,0 +1,387 @@
+﻿/*
+    ██████╗ ███████╗ ██████╗██████╗ ██████╗ 
+    ██╔══██╗██╔════╝██╔════╝██╔══██╗██╔══██╗
+    ██████╔╝█████╗  ██║     ██████╔╝██████╔╝
+    ██╔══██╗██╔══╝  ██║     ██╔═══╝ ██╔═══╝ 
+    ██║  ██║███████╗╚██████╗██║     ██║     
+    ╚═╝  ╚═╝╚══════╝ ╚═════╝╚═╝     ╚═╝     
+* @license : <license placeholder>
+*/
+
+#include "ClassTree.h"
+
+ClassTree *ClassTree::instance = NULL;
+
+static const int widths[] = {
+    48,
+    6 | CHCOL_DEC,
+    8 | CHCOL_DEC,
+    10 | CHCOL_DEC,
+    10 | CHCOL_HEX
+};
+
+static const char *const header[] = {
+    "Class",
+    "Bases",
+    "Derived",
+    "Subtree",
+    "Type descriptor"
+};
+
+
+// Popup actions of the view
+
+struct tree_filter_action_t : public action_handler_t
+{
+    virtual int idaapi activate (action_activation_ctx_t *) {
+        qstring text (ClassTree::get_filter ());
+        if (!ask_str (&text, HIST_SRCH, "Show the classes containing")) {
+            return 0;
+        }
+
+        ClassTree::set_filter (text.c_str ());
+        return 1;
+    }
+
+    virtual action_state_t idaapi update (action_update_ctx_t *ctx) {
+        return ctx->widget_type == BWN_CHOOSER && ctx->widget == find_widget (CLASS_TREE_TITLE)
+             ? AST_ENABLE_FOR_WIDGET
+             : AST_DISABLE_FOR_WIDGET;
+    }
+};
+static tree_filter_action_t tree_filter_action;
+
+struct tree_jump_action_t : public action_handler_t
+{
+    virtual int idaapi activate (action_activation_ctx_t *ctx) {
+        if (ctx->chooser_selection.empty ()) {
+            return 0;
+        }
+
+        ClassTree::jump (ctx->chooser_selection[0]);
+        return 1;
+    }
+
+    virtual action_state_t idaapi update (action_update_ctx_t *ctx) {
+        return ctx->widget_type == BWN_CHOOSER && ctx->widget == find_widget (CLASS_TREE_TITLE)
+             ? AST_ENABLE_FOR_WIDGET
+             : AST_DISABLE_FOR_WIDGET;
+    }
+};
+static tree_jump_action_t tree_jump_action;
+
+
+ClassTree::ClassTree (
+    ClassRegistry *registry
+) : chooser_t (CH_KEEP | CH_CAN_REFRESH, qnumber (widths), widths, header, CLASS_TREE_TITLE) {
+    this->registry = registry;
+    this->timer = NULL;
+    this->graph.reset (registry);
+}
+
+ClassTree::~ClassTree () {
+    if (this->timer != NULL) {
+        unregister_timer (this->timer);
+    }
+}
+
+void
+ClassTree::show (
+    ClassRegistry *registry
+) {
+    TWidget *widget = find_widget (CLASS_TREE_TITLE);
+    if (widget != NULL && instance != NULL) {
+        activate_widget (widget, true);
+        return;
+    }
+
+    if (instance == NULL) {
+        register_action (ACTION_DESC_LITERAL (
+            "RECPP:TreeFilter", "Filter classes...",
+            &tree_filter_action, NULL, NULL, -1));
+        register_action (ACTION_DESC_LITERAL (
+            "RECPP:TreeJump", "Jump to type descriptor",
+            &tree_jump_action, NULL, NULL, -1));
+
+        instance = new ClassTree (registry);
+    }
+    else {
+        instance->registry = registry;
+    }
+
+    // Nothing is read here, the graph is built by the timer
+    instance->sync ();
+    instance->arm ();
+    instance->choose ();
+
+    widget = find_widget (CLASS_TREE_TITLE);
+    if (widget != NULL) {
+        attach_action_to_popup (widget, NULL, "RECPP:TreeFilter");
+        attach_action_to_popup (widget, NULL, "RECPP:TreeJump");
+    }
+}
+
+void
+ClassTree::term (
+    void
+) {
+    if (instance == NULL) {
+        return;
+    }
+
+    TWidget *widget = find_widget (CLASS_TREE_TITLE);
+    if (widget != NULL) {
+        close_widget (widget, 0);
+    }
+
+    unregister_action ("RECPP:TreeJump");
+    unregister_action ("RECPP:TreeFilter");
+
+    delete instance;
+    instance = NULL;
+}
+
+void
+ClassTree::sync (
+    void
+) {
+    if (this->graph.get_state () != ClassGraph::GRAPH_EMPTY
+     && this->graph.source_generation () == this->registry->generation ()) {
+        return;
+    }
+
+    this->graph.reset (this->registry);
+    this->matches.clear ();
+    this->rows.clear ();
+}
+
+void
+ClassTree::reset_rows (
+    void
+) {
+    this->rows.clear ();
+
+    if (!this->graph.is_linked ()) {
+        return;
+    }
+
+    const std::vector<int> &top = this->filter.empty () ? this->graph.roots () : this->matches;
+    this->rows.reserve (top.size ());
+
+    for (size_t i = 0; i < top.size (); i++) {
+        row_t row = { top[i], 0, false };
+        this->rows.push_back (row);
+    }
+}
+
+void
+ClassTree::set_filter (
+    const char *text
+) {
+    if (instance == NULL) {
+        return;
+    }
+
+    qstring previous = instance->filter;
+    instance->filter = text;
+
+    if (instance->filter.empty ()) {
+        instance->matches.clear ();
+    }
+    else if (instance->graph.has_names ()
+          && !previous.empty () && strstr (instance->filter.c_str (), previous.c_str ()) != NULL) {
+        // Narrowing : the new matches are among the current ones, checked
+        // against the indexed names without reading the database
+        qstring lower (instance->filter);
+        for (size_t i = 0; i < lower.length (); i++) {
+            lower[i] = (char) qtolower (lower[i]);
+        }
+
+        std::vector<int> kept;
+        for (size_t i = 0; i < instance->matches.size (); i++)
+        {
+            const char *name = instance->graph.get_lower_name (instance->matches[i]);
+            if (name != NULL && strstr (name, lower.c_str ()) != NULL) {
+                kept.push_back (instance->matches[i]);
+            }
+        }
+        instance->matches.swap (kept);
+    }
+    else if (instance->graph.has_names ()) {
+        instance->graph.search (instance->filter.c_str (), &instance->matches);
+    }
+    else {
+        // Applied by the timer once the names are indexed
+        instance->matches.clear ();
+        msg ("RECPP: the class names are still being indexed, the filter will apply when done.\n");
+    }
+
+    instance->reset_rows ();
+    refresh_chooser (CLASS_TREE_TITLE);
+}
+
+bool
+ClassTree::jump (
+    size_t n
+) {
+    if (instance == NULL) {
+        return false;
+    }
+
+    ea_t ea = instance->get_ea (n);
+    return ea != BADADDR && jumpto (ea);
+}
+
+void
+ClassTree::arm (
+    void
+) {
+    if (this->timer == NULL && this->graph.get_state () != ClassGraph::GRAPH_READY) {
+        this->timer = register_timer (CLASS_TREE_TICK_MS, timer_cb, this);
+    }
+}
+
+int
+ClassTree::tick (
+    void
+) {
+    // The auto analysis still has work to do, don't compete with it
+    if (!auto_is_ok ()) {
+        return CLASS_TREE_TICK_MS;
+    }
+
+    bool linked = this->graph.is_linked ();
+    bool named = this->graph.has_names ();
+    uint64 deadline = get_nsec_stamp () + (uint64) CLASS_TREE_SLICE_MS * 1000000;
+
+    bool done = this->graph.step (deadline);
+
+    if (!linked && this->graph.is_linked ()) {
+        reset_rows ();
+    }
+
+    if (!named && this->graph.has_names () && !this->filter.empty ()) {
+        this->graph.search (this->filter.c_str (), &this->matches);
+        reset_rows ();
+    }
+
+    // Progress while building, then the subtree sizes
+    refresh_chooser (CLASS_TREE_TITLE);
+
+    if (done) {
+        // Unregistered by returning -1, armed again by the next show
+        this->timer = NULL;
+        return -1;
+    }
+
+    return CLASS_TREE_TICK_MS;
+}
+
+int idaapi
+ClassTree::timer_cb (
+    void *ud
+) {
+    return ((ClassTree *) ud)->tick ();
+}
+
+size_t idaapi
+ClassTree::get_count (
+    void
+) const {
+    // A single status row until the graph is linked
+    return this->graph.is_linked () ? this->rows.size () : 1;
+}
+
+void idaapi
+ClassTree::get_row (
+    qstrvec_t *cols,
+    int *,
+    chooser_item_attrs_t *,
+    size_t n
+) const {
+    if (!this->graph.is_linked ()) {
+        (*cols)[0].sprnt ("Reading the class hierarchy (%d%%)...", this->graph.progress ());
+        return;
+    }
+
+    const row_t &row = this->rows[n];
+    int node = row.node;
+
+    const char *marker = this->graph.child_count (node) == 0 ? "  " : row.expanded ? "- " : "+ ";
+    (*cols)[0].sprnt ("%*s%s%s", row.depth * 2, "", marker, this->graph.get_name (node).c_str ());
+    (*cols)[1].sprnt ("%u", this->graph.base_count (node));
+    (*cols)[2].sprnt ("%u", this->graph.child_count (node));
+
+    if (this->graph.is_counted ()) {
+        // The class itself isn't part of its subtree
+        (*cols)[3].sprnt ("%" FMT_64 "u", this->graph.subtree_size (node) - 1);
+    }
+    else {
+        (*cols)[3] = "...";
+    }
+
+    (*cols)[4].sprnt ("%a", this->graph.node_type (node));
+}
+
+ea_t idaapi
+ClassTree::get_ea (
+    size_t n
+) const {
+    if (!this->graph.is_linked () || n >= this->rows.size ()) {
+        return BADADDR;
+    }
+
+    return this->graph.node_type (this->rows[n].node);
+}
+
+chooser_t::cbret_t idaapi
+ClassTree::enter (
+    size_t n
+) {
+    if (!this->graph.is_linked () || n >= this->rows.size ()) {
+        return cbret_t (n, NOTHING_CHANGED);
+    }
+
+    row_t &row = this->rows[n];
+
+    if (row.expanded) {
+        // Drop the rows below, they are rebuilt on the next expand
+        size_t end = n + 1;
+        while (end < this->rows.size () && this->rows[end].depth > row.depth) {
+            end++;
+        }
+
+        this->rows.erase (this->rows.begin () + n + 1, this->rows.begin () + end);
+        row.expanded = false;
+        return cbret_t (n, ALL_CHANGED);
+    }
+
+    if (this->graph.child_count (row.node) == 0) {
+        return cbret_t (n, NOTHING_CHANGED);
+    }
+
+    std::vector<row_t> children;
+    for (const int *c = this->graph.children_begin (row.node); c != this->graph.children_end (row.node); c++) {
+        row_t child = { *c, row.depth + 1, false };
+        children.push_back (child);
+    }
+
+    row.expanded = true;
+    this->rows.insert (this->rows.begin () + n + 1, children.begin (), children.end ());
+
+    return cbret_t (n, ALL_CHANGED);
+}
+
+chooser_t::cbret_t idaapi
+ClassTree::refresh (
+    ssize_t n
+) {
+    // The registry follows the IDB events, restart only when it moved
+    if (this->graph.source_generation () == this->registry->generation ()) {
+        return cbret_t (n, NOTHING_CHANGED);
+    }
+
+    sync ();
+    arm ();
+    return cbret_t (0, ALL_CHANGED);
+}
@@ -0,0 +1,130 @@
+﻿/*
+    ██████╗ ███████╗ ██████╗██████╗ ██████╗ 
+    ██╔══██╗██╔════╝██╔════╝██╔══██╗██╔══██╗
+    ██████╔╝█████╗  ██║     ██████╔╝██████╔╝
+    ██╔══██╗██╔══╝  ██║     ██╔═══╝ ██╔═══╝ 
+    ██║  ██║███████╗╚██████╗██║     ██║     
+    ╚═╝  ╚═╝╚══════╝ ╚═════╝╚═╝     ╚═╝     
+* @license : <license placeholder>
+*/
+
+#pragma once
+
+
+// ---------- Includes ------------
+#include "RECPP.h"
+#include "ClassGraph.h"
+#include <vector>
+
+// ---------- Defines -------------
+#define CLASS_TREE_TITLE   "RECPP inheritance"
+#define CLASS_TREE_TICK_MS 100 // how often the graph build looks for idle time
+#define CLASS_TREE_SLICE_MS 30 // how long one tick may build
+
+
+// ------ Class definition --------
+// Inheritance tree of the classes, bases above their derived classes.
+//
+// The chooser shows the expanded part of the tree as a flat list of rows :
+// opening it only lists the roots, and the children of a class are inserted
+// under it when it is expanded (Enter). The graph itself is built from a
+// timer in the background, along with the subtree sizes and the name index,
+// so opening the view never waits for it.
+class ClassTree : public chooser_t
+{
+public:
+    /*
+     * @brief : Open the view, or bring it to the front if it is already open
+     */
+    static void
+    show (
+        ClassRegistry *registry
+    );
+
+    /*
+     * @brief : Close the view, must be called before the registry is deleted
+     */
+    static void
+    term (
+        void
+    );
+
+    /*
+     * @brief : Only show the classes whose name contains \text, and their
+     *          subtrees. Narrowing the previous filter only rechecks its matches
+     * @param text : The filter, empty to show the whole tree again
+     */
+    static void
+    set_filter (
+        const char *text
+    );
+
+    static const char *get_filter () { return instance != NULL ? instance->filter.c_str () : ""; }
+
+    static bool
+    jump (
+        size_t n
+    );
+
+    // chooser_t
+    virtual size_t idaapi get_count () const;
+    virtual void idaapi get_row (qstrvec_t *cols, int *icon, chooser_item_attrs_t *attrs, size_t n) const;
+    virtual ea_t idaapi get_ea (size_t n) const;
+    virtual cbret_t idaapi enter (size_t n);
+    virtual cbret_t idaapi refresh (ssize_t n);
+
+private:
+    ClassTree (
+        ClassRegistry *registry
+    );
+    ~ClassTree ();
+
+    static ClassTree *instance;
+
+    struct row_t
+    {
+        int node;
+        int depth;
+        bool expanded;
+    };
+
+    ClassRegistry *registry;
+    ClassGraph graph;
+    std::vector<row_t> rows;    // expanded part of the tree
+
+    qstring filter;
+    std::vector<int> matches;   // nodes matching the filter
+
+    qtimer_t timer;
+
+    /*
+     * @brief : Restart from the registry if it changed since the graph was built
+     */
+    void
+    sync (
+        void
+    );
+
+    /*
+     * @brief : Collapse everything, back to the top level rows
+     */
+    void
+    reset_rows (
+        void
+    );
+
+    void
+    arm (
+        void
+    );
+
+    int
+    tick (
+        void
+    );
+
+    static int idaapi
+    timer_cb (
+        void *ud
+    );
+};
@@ -10,17 +10,20 @@
 
 #include "CompleteObjectLocator.h"
 #include "IDAUtils.h"
+#include "Profiler.h"
 
 void
 CompleteObjectLocator::parse (
     ea_t address
 ) {
+    PROFILE_SCOPE ("RTTI COL");
+
     if (address == BADADDR || !address) {
         return;
     }
     
     char buffer2[2048] = {0};
-    char *cloName = IDAUtils::GetAsciizStr (get_dword (address + 12) + 8, buffer2, sizeof (buffer2));
+    char *cloName = IDAUtils::GetAsciizStr (IDAUtils::Dword (address + 12) + 8, buffer2, sizeof (buffer2));
 
     IDAUtils::DwordCmt (address, "signature");
     IDAUtils::DwordCmt (address + 4, "offset");
@@ -28,20 +31,20 @@ CompleteObjectLocator::parse (
     IDAUtils::OffCmt (address + 12, "pTypeDescriptor");
     IDAUtils::OffCmt (address + 16, "pClassDescriptor");
 
-    CRTTIClassHierarchyDescriptor::parse (get_dword (address + 16));
+    CRTTIClassHierarchyDescriptor::parse (IDAUtils::Dword (address + 16));
 }
 
 bool
 CompleteObjectLocator::isValid (
     ea_t address
 ) {
-    ea_t x = get_dword (address + 12);
+    ea_t x = IDAUtils::Dword (address + 12);
 
     if (!x || (x == BADADDR)) {
         return 0;
     }
 
-    x = get_dword (x + 8);
+    x = IDAUtils::Dword (x + 8);
 
                           // .?A
     if ((x & 0xFFFFFF) == 0x413F2E) {
@@ -58,7 +61,7 @@ CompleteObjectLocator::get_type_name_by_col (
     char *buffer,
     size_t bufferSize
 ) {
-    ea_t x = get_dword (colAddress + 12);
+    ea_t x = IDAUtils::Dword (colAddress + 12);
     
     if (x == BADADDR || !x) {
         return NULL;
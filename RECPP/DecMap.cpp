@@ -9,32 +9,239 @@
 */
 
 #include "DecMap.h"
+#include "Profiler.h"
 
 
-DecMap::DecMap () {
+DecMap::DecMap (size_t budget) {
+    this->node_count = 0;
+    this->budget = budget;
+    memset (&this->stats, 0, sizeof (this->stats));
 }
 
 
 DecMap::~DecMap () {
+    clear ();
 }
 
 
+// Count the ctree items, the cfunc doesn't tell how much memory it holds
+struct item_counter_t : public ctree_visitor_t
+{
+    size_t count;
+
+    item_counter_t () : ctree_visitor_t (CV_FAST), count (0) { }
+
+    int idaapi visit_insn (cinsn_t *) { count++; return 0; }
+    int idaapi visit_expr (cexpr_t *) { count++; return 0; }
+};
+
+size_t
+DecMap::estimate_size (
+    cfunc_t *cfunc
+) {
+    item_counter_t counter;
+    counter.apply_to (&cfunc->body, NULL);
+
+    size_t size = sizeof (cfunc_t) + counter.count * DECMAP_ITEM_SIZE;
+
+    lvars_t *lvars = cfunc->get_lvars ();
+    if (lvars != NULL) {
+        size += lvars->size () * sizeof (lvar_t);
+    }
+
+    return size;
+}
+
 //--------------------------------------------------------------------------
-void DecMap::process (cfunc_t *cfunc)
+void DecMap::insert (const cfuncptr_t &cfunc)
 {
-    ea_cf_map_t::const_iterator it = ea2cf.find (cfunc->entry_ea);
+    ea_cf_map_t::iterator it = ea2cf.find (cfunc->entry_ea);
     if (it != ea2cf.end ()) {
-        // Already exists
+        // Already exists, a newer decompilation replaces it
+        if ((cfunc_t *) it->second.cfunc == (cfunc_t *) cfunc) {
+            return;
+        }
+
+        this->stats.bytes -= it->second.size;
+        this->lru.erase (it->second.lru);
+        ea2cf.erase (it);
+    }
+
+    entry_t entry;
+    entry.cfunc = cfunc;
+    entry.size = estimate_size ((cfunc_t *) cfunc);
+    this->lru.push_front (cfunc->entry_ea);
+    entry.lru = this->lru.begin ();
+
+    ea2cf [cfunc->entry_ea] = entry;
+
+    this->stats.bytes += entry.size;
+    if (this->stats.bytes > this->stats.peak_bytes) {
+        this->stats.peak_bytes = this->stats.bytes;
+    }
+
+    // Reports the new size to MemStats, even when nothing is evicted
+    evict ();
+}
+
+//--------------------------------------------------------------------------
+void DecMap::evict (void)
+{
+    // Always keep the most recent entry, even if it's bigger than the budget
+    while (this->stats.bytes > this->budget && this->lru.size () > 1)
+    {
+        ea_cf_map_t::iterator it = ea2cf.find (this->lru.back ());
+        this->lru.pop_back ();
+
+        if (it == ea2cf.end ()) {
+            continue;
+        }
+
+        this->stats.bytes -= it->second.size;
+        this->stats.evictions++;
+        ea2cf.erase (it); // releases our reference on the cfunc
+    }
+
+    this->stats.entries = ea2cf.size ();
+    update_memory ();
+}
+
+//--------------------------------------------------------------------------
+cfuncptr_t DecMap::find (ea_t func_ea)
+{
+    ea_cf_map_t::iterator it = ea2cf.find (func_ea);
+    if (it == ea2cf.end ()) {
+        return cfuncptr_t ();
+    }
+
+    // Move to the front of the lru
+    this->lru.splice (this->lru.begin (), this->lru, it->second.lru);
+    return it->second.cfunc;
+}
+
+//--------------------------------------------------------------------------
+cfuncptr_t DecMap::get (ea_t func_ea)
+{
+    cfuncptr_t cfunc = find (func_ea);
+    if (cfunc != NULL) {
+        this->stats.hits++;
+        return cfunc;
+    }
+
+    this->stats.misses++;
+
+    func_t *pFn = get_func (func_ea);
+    if (!pFn) {
+        return cfuncptr_t ();
+    }
+
+    hexrays_failure_t hf;
+    {
+        PROFILE_SCOPE ("DecMap::decompile");
+        cfunc = decompile (pFn, &hf);
+    }
+    if (cfunc == NULL) {
+        return cfunc;
+    }
+
+    PROFILE_SCOPE ("DecMap::insert");
+    insert (cfunc);
+    return cfunc;
+}
+
+//--------------------------------------------------------------------------
+void DecMap::invalidate (ea_t func_ea)
+{
+    ea_cf_map_t::iterator it = ea2cf.find (func_ea);
+    if (it == ea2cf.end ()) {
         return;
     }
 
-    ea_gi_map_t::const_iterator it2 = ea2gi.find (cfunc->entry_ea);
-    if (it2 == ea2gi.end ()) {
-        // Don't exist, but it should do!
+    this->stats.bytes -= it->second.size;
+    this->stats.invalidations++;
+    this->lru.erase (it->second.lru);
+    ea2cf.erase (it);
+    this->stats.entries = ea2cf.size ();
+    update_memory ();
+}
+
+//--------------------------------------------------------------------------
+void DecMap::clear (void)
+{
+    ea2cf.clear ();
+    this->lru.clear ();
+    this->stats.bytes = 0;
+    this->stats.entries = 0;
+    update_memory ();
+}
+
+//--------------------------------------------------------------------------
+void DecMap::update_memory (void)
+{
+    // The cfuncs are estimated, the lru and map nodes come on top of them
+    size_t bytes = this->stats.bytes
+                 + this->stats.entries * (sizeof (entry_t) + sizeof (ea_t) + 2 * MEM_NODE_OVERHEAD);
+
+    MemStats::account (MEM_DECOMPILER, &this->memory, bytes, this->stats.entries);
+}
+
+//--------------------------------------------------------------------------
+void DecMap::set_budget (size_t bytes)
+{
+    this->budget = bytes;
+    evict ();
+}
+
+//--------------------------------------------------------------------------
+void DecMap::print_stats (void) const
+{
+    size_t lookups = this->stats.hits + this->stats.misses;
+
+    msg ("Decompilation cache : %d entries, %d KB (peak %d KB, budget %d KB)\n",
+         (int) this->stats.entries,
+         (int) (this->stats.bytes / 1024),
+         (int) (this->stats.peak_bytes / 1024),
+         (int) (this->budget / 1024));
+    msg ("    %d hits, %d misses (%d%% hit rate), %d evictions, %d invalidations\n",
+         (int) this->stats.hits,
+         (int) this->stats.misses,
+         lookups ? (int) (this->stats.hits * 100 / lookups) : 0,
+         (int) this->stats.evictions,
+         (int) this->stats.invalidations);
+    msg ("    %d decompilation events, %d processed\n",
+         (int) this->stats.events_seen,
+         (int) this->stats.events_processed);
+}
+
+//--------------------------------------------------------------------------
+void DecMap::process (cfunc_t *cfunc)
+{
+    this->stats.events_seen++;
+
+    if (!is_interesting (cfunc->entry_ea)) {
         return;
     }
 
-    ea2cf [cfunc->entry_ea] = cfunc;
+    this->stats.events_processed++;
+
+    // The decompiler owns this cfunc : take a reference before wrapping it,
+    // qrefcnt_t's constructor from a raw pointer doesn't add one
+    cfunc->refcnt++;
+    cfuncptr_t ref (cfunc);
+    insert (ref);
+}
+
+//--------------------------------------------------------------------------
+void DecMap::add_interesting (ea_t func_ea)
+{
+    this->interesting.add (func_ea);
+}
+
+//--------------------------------------------------------------------------
+void DecMap::remove_interesting (ea_t func_ea)
+{
+    this->interesting.remove (func_ea);
+    invalidate (func_ea);
 }
 
 //--------------------------------------------------------------------------
@@ -54,11 +261,8 @@ void DecMap::decompile_function (graph_info_t *gi, ea_t func_ea)
     
     // Everything is ok from here, add the graph info to the map
     ea2gi [func_ea] = gi;
+    add_interesting (func_ea);
 
-    // Request to decompile function
-    hexrays_failure_t hf;
-    cfunc_t *cfunc = decompile (pFn, &hf);
-    if (!cfunc) {
-        return;
-    }
+    // Request to decompile function, the result stays in the cache
+    get (func_ea);
 }
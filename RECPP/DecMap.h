@@ -14,28 +14,161 @@
 // ---------- Includes ------------
 #include "RECPP.h"
 #include "callgraph.h"
+#include "FuncFilter.h"
+#include "MemStats.h"
+#include <list>
 
 // ---------- Defines -------------
+#define DECMAP_DEFAULT_BUDGET (256 * 1024 * 1024) // bytes of decompiled code kept alive
+#define DECMAP_ITEM_SIZE      128                 // estimated cost of one ctree item
 
 
 // ------ Class definition --------
 
 class graph_info_t;
 
+// Cache of decompiled functions.
+// Entries hold a reference on their cfunc, the least recently used ones are
+// released once the estimated size of the cache goes over the budget.
 class DecMap {
 public:
-    DecMap ();
+    DecMap (size_t budget = DECMAP_DEFAULT_BUDGET);
     ~DecMap ();
 
     int node_count;
-    
-    // Map address -> cfunc_t
-    typedef std::map<ea_t, cfunc_t *> ea_cf_map_t;
+
     typedef std::map<ea_t, graph_info_t *> ea_gi_map_t;
-    ea_cf_map_t ea2cf;
     ea_gi_map_t ea2gi;
 
+    struct stats_t
+    {
+        size_t hits;
+        size_t misses;
+        size_t evictions;
+        size_t invalidations;
+        size_t bytes;       // current estimated size
+        size_t peak_bytes;
+        size_t entries;
+        size_t events_seen;      // final maturity events from the decompiler
+        size_t events_processed; // those about an interesting function
+    };
+
     void DecMap::decompile_function (graph_info_t *gi, ea_t func_ea);
     void DecMap::process (cfunc_t *cfunc);
-};
 
+    /*
+     * @brief : Is a decompiled function worth handing to process ? Called for
+     *          every decompilation in the database, so it must stay cheap
+     */
+    bool
+    DecMap::is_interesting (
+        ea_t func_ea
+    ) const {
+        return this->interesting.contains (func_ea);
+    }
+
+    /*
+     * @brief : Keep the decompilations of a function made outside of the cache,
+     *          when the user opens it for instance
+     */
+    void
+    DecMap::add_interesting (
+        ea_t func_ea
+    );
+
+    /*
+     * @brief : Stop following a function, because it was deleted
+     */
+    void
+    DecMap::remove_interesting (
+        ea_t func_ea
+    );
+
+    /*
+     * @brief : Get a decompiled function, from the cache or by decompiling it
+     * @return The cfunc, or an empty pointer if the decompilation failed
+     */
+    cfuncptr_t
+    DecMap::get (
+        ea_t func_ea
+    );
+
+    /*
+     * @brief : Get a decompiled function only if it is cached
+     */
+    cfuncptr_t
+    DecMap::find (
+        ea_t func_ea
+    );
+
+    /*
+     * @brief : Drop a function from the cache, because it changed
+     */
+    void
+    DecMap::invalidate (
+        ea_t func_ea
+    );
+
+    void
+    DecMap::clear (
+        void
+    );
+
+    void
+    DecMap::set_budget (
+        size_t bytes
+    );
+
+    const stats_t &get_stats () const { return this->stats; }
+
+    void
+    DecMap::print_stats (
+        void
+    ) const;
+
+private:
+    typedef std::list<ea_t> lru_t;
+
+    struct entry_t
+    {
+        cfuncptr_t cfunc;
+        size_t size;
+        lru_t::iterator lru;
+    };
+
+    // Map address -> cached cfunc, most recently used first in the lru
+    typedef std::map<ea_t, entry_t> ea_cf_map_t;
+    ea_cf_map_t ea2cf;
+    lru_t lru;
+
+    size_t budget;
+    stats_t stats;
+    MemStats::held_t memory;
+
+    // Functions RECPP works on : the class slots, the prefetch targets and the
+    // methods followed by FieldLayout. Checked on every decompilation event
+    FuncFilter interesting;
+
+    /*
+     * @brief : Cache a decompiled function, the entry holds its own reference
+     */
+    void
+    DecMap::insert (
+        const cfuncptr_t &cfunc
+    );
+
+    void
+    DecMap::evict (
+        void
+    );
+
+    void
+    DecMap::update_memory (
+        void
+    );
+
+    static size_t
+    DecMap::estimate_size (
+        cfunc_t *cfunc
+    );
+};
@@ -0,0 +1,650 @@
+﻿/*
+    ██████╗ ███████╗ ██████╗██████╗ ██████╗ 
+    ██╔══██╗██╔════╝██╔════╝██╔══██╗██╔══██╗
+    ██████╔╝█████╗  ██║     ██████╔╝██████╔╝
+    ██╔══██╗██╔══╝  ██║     ██╔═══╝ ██╔═══╝ 
+    ██║  ██║███████╗╚██████╗██║     ██║     
+    ╚═╝  ╚═╝╚══════╝ ╚═════╝╚═╝     ╚═╝     
+* @license : <license placeholder>
+*/
+
+#include "FieldLayout.h"
+#include "ClassRegistry.h"
+#include "VtableScanner.h"
+#include "DecMap.h"
+#include "ParallelFor.h"
+#include "Profiler.h"
+#include <algorithm>
+
+FieldLayout *FieldLayout::instance = NULL;
+
+
+FieldLayout::FieldLayout () {
+}
+
+FieldLayout::~FieldLayout () {
+    MemStats::account (MEM_DECOMPILER, &this->memory, 0, 0);
+}
+
+FieldLayout *
+FieldLayout::get (
+    void
+) {
+    if (instance == NULL) {
+        instance = new FieldLayout ();
+    }
+
+    return instance;
+}
+
+void
+FieldLayout::term (
+    void
+) {
+    delete instance;
+    instance = NULL;
+}
+
+void
+FieldLayout::update_memory (
+    void
+) {
+    size_t bytes = this->accesses.size () * (sizeof (ea_t) + sizeof (std::vector<access_t>) + MEM_NODE_OVERHEAD);
+
+    for (ea_access_map_t::const_iterator it = this->accesses.begin (); it != this->accesses.end (); ++it) {
+        bytes += it->second.capacity () * sizeof (access_t);
+    }
+
+    MemStats::account (MEM_DECOMPILER, &this->memory, bytes, this->accesses.size ());
+}
+
+
+// Size of the items a pointer points to, for the pointer arithmetic
+static int64
+pointee_size (
+    const tinfo_t &type
+) {
+    if (!type.is_ptr ()) {
+        return 1;
+    }
+
+    size_t size = type.get_ptrarr_objsize ();
+    return size == 0 || size == BADSIZE ? 1 : (int64) size;
+}
+
+// Accesses through `this`, or through a local variable it was copied to
+struct this_access_visitor_t : public ctree_visitor_t
+{
+    std::vector<bool> alias;
+    std::vector<FieldLayout::access_t> *out;
+
+    this_access_visitor_t (cfunc_t *cfunc, std::vector<FieldLayout::access_t> *out)
+        : ctree_visitor_t (CV_PARENTS), out (out)
+    {
+        lvars_t *lvars = cfunc->get_lvars ();
+        this->alias.assign (lvars != NULL ? lvars->size () : 0, false);
+
+        if (!cfunc->argidx.empty () && (size_t) cfunc->argidx[0] < this->alias.size ()) {
+            this->alias[cfunc->argidx[0]] = true;
+        }
+    }
+
+    bool
+    is_this (
+        const cexpr_t *e
+    ) const {
+        while (e->op == cot_cast) {
+            e = e->x;
+        }
+
+        return e->op == cot_var && (size_t) e->v.idx < this->alias.size () && this->alias[e->v.idx];
+    }
+
+    // this, this + k, this - k
+    bool
+    this_offset (
+        const cexpr_t *e,
+        int64 *offset
+    ) const {
+        while (e->op == cot_cast) {
+            e = e->x;
+        }
+
+        if (is_this (e)) {
+            *offset = 0;
+            return true;
+        }
+
+        if ((e->op != cot_add && e->op != cot_sub) || e->y->op != cot_num || !is_this (e->x)) {
+            return false;
+        }
+
+        int64 k = (int64) e->y->n->value (e->y->type) * pointee_size (e->x->type);
+        *offset = e->op == cot_add ? k : -k;
+        return true;
+    }
+
+    int idaapi
+    visit_expr (
+        cexpr_t *e
+    ) {
+        int64 offset;
+
+        switch (e->op)
+        {
+            case cot_asg:
+                // v2 = this;
+                if (e->x->op == cot_var && (size_t) e->x->v.idx < this->alias.size () && is_this (e->y)) {
+                    this->alias[e->x->v.idx] = true;
+                }
+                return 0;
+
+            case cot_memptr:
+                // this->field_8
+                if (!is_this (e->x)) {
+                    return 0;
+                }
+                offset = e->m;
+                break;
+
+            case cot_ptr:
+                // *((_DWORD *)this + 3)
+                if (!this_offset (e->x, &offset)) {
+                    return 0;
+                }
+                break;
+
+            case cot_idx:
+                // ((_DWORD *)this)[3]
+                if (e->y->op != cot_num || !is_this (e->x)) {
+                    return 0;
+                }
+                offset = (int64) e->y->n->value (e->y->type) * pointee_size (e->x->type);
+                break;
+
+            default:
+                return 0;
+        }
+
+        size_t size = e->type.get_size ();
+        if (offset < 0 || offset >= FL_MAX_OFFSET || size == 0 || size == BADSIZE || size > FL_MAX_SIZE) {
+            return 0;
+        }
+
+        FieldLayout::access_t access;
+        access.offset = (uint32) offset;
+        access.size = (uint32) size;
+        access.kind = e->type.is_ptr () || e->type.is_funcptr () ? FK_PTR
+                    : e->type.is_floating () ? FK_FLOAT
+                    : FK_INT;
+        access.flags = FL_READ;
+
+        const citem_t *up = this->parents.empty () ? NULL : this->parents.back ();
+        if (up != NULL && up->is_expr ()) {
+            const cexpr_t *parent = (const cexpr_t *) up;
+
+            if (parent->op == cot_ref) {
+                // &this->x : an address, not an access of that size
+                return 0;
+            }
+            else if (parent->op == cot_asg && parent->x == e) {
+                access.flags = FL_WRITE;
+            }
+            else if (parent->op > cot_asg && parent->op <= cot_asgumod && parent->x == e) {
+                access.flags = FL_READ | FL_WRITE;
+            }
+        }
+
+        this->out->push_back (access);
+        return 0;
+    }
+};
+
+static bool
+access_less (
+    const FieldLayout::access_t &a,
+    const FieldLayout::access_t &b
+) {
+    if (a.offset != b.offset) return a.offset < b.offset;
+    if (a.size != b.size) return a.size < b.size;
+    return a.kind < b.kind;
+}
+
+void
+FieldLayout::collect (
+    cfunc_t *cfunc
+) {
+    std::vector<access_t> found;
+
+    this_access_visitor_t visitor (cfunc, &found);
+    visitor.apply_to (&cfunc->body, NULL);
+
+    // One entry per distinct access, so that every method votes once
+    std::sort (found.begin (), found.end (), access_less);
+
+    std::vector<access_t> &list = this->accesses[cfunc->entry_ea];
+    list.clear ();
+
+    for (size_t i = 0; i < found.size (); i++)
+    {
+        if (!list.empty () && !access_less (list.back (), found[i])) {
+            list.back ().flags |= found[i].flags;
+            continue;
+        }
+
+        list.push_back (found[i]);
+    }
+
+    this->known.add (cfunc->entry_ea);
+}
+
+void
+FieldLayout::on_decompiled (
+    cfunc_t *cfunc
+) {
+    if (!this->known.contains (cfunc->entry_ea)) {
+        return;
+    }
+
+    collect (cfunc);
+    update_memory ();
+}
+
+void
+FieldLayout::invalidate (
+    ea_t funcEa
+) {
+    if (!this->known.contains (funcEa)) {
+        return;
+    }
+
+    this->accesses.erase (funcEa);
+    this->known.remove (funcEa);
+    update_memory ();
+}
+
+void
+FieldLayout::reduce (
+    const std::vector<source_t> &sources,
+    uint32 objectSize,
+    layout_t *out
+) {
+    std::vector<access_t> all;
+    for (size_t i = 0; i < sources.size (); i++)
+    {
+        const std::vector<access_t> &list = *sources[i].accesses;
+
+        for (size_t j = 0; j < list.size (); j++)
+        {
+            access_t a = list[j];
+            a.offset += sources[i].shift;
+
+            if (a.offset < FL_MAX_OFFSET) {
+                all.push_back (a);
+            }
+        }
+    }
+
+    std::sort (all.begin (), all.end (), access_less);
+
+    // Best access at every offset : the most used one, then the largest
+    std::vector<field_t> best;
+    for (size_t i = 0; i < all.size (); )
+    {
+        field_t f = { all[i].offset, all[i].size, all[i].kind, 0, 0 };
+
+        for (; i < all.size () && all[i].offset == f.offset && all[i].size == f.size && all[i].kind == f.kind; i++) {
+            f.flags |= all[i].flags;
+            f.votes++;
+        }
+
+        if (!best.empty () && best.back ().offset == f.offset) {
+            if (f.votes >= best.back ().votes) {
+                best.back () = f;
+            }
+            continue;
+        }
+
+        best.push_back (f);
+    }
+
+    out->fields.clear ();
+    out->size = objectSize;
+    out->conflicts = 0;
+
+    // The vftable pointer always comes first
+    field_t vfptr = { 0, 4, FK_PTR, FL_READ | FL_WRITE, 0 };
+    out->fields.push_back (vfptr);
+
+    for (size_t i = 0; i < best.size (); i++)
+    {
+        const field_t &f = best[i];
+
+        if (f.offset < vfptr.size || (objectSize != 0 && f.offset + f.size > objectSize)) {
+            continue;
+        }
+
+        // Overlapping accesses : the one more methods agree on stays
+        bool keep = true;
+        while (out->fields.size () > 1)
+        {
+            field_t &prev = out->fields.back ();
+            if (f.offset >= prev.offset + prev.size) {
+                break;
+            }
+
+            out->conflicts++;
+            if (f.votes <= prev.votes) {
+                keep = false;
+                break;
+            }
+
+            out->fields.pop_back ();
+        }
+
+        if (keep) {
+            out->fields.push_back (f);
+        }
+    }
+}
+
+bool
+FieldLayout::write_struct (
+    const char *className,
+    const layout_t &layout
+) {
+    qstring name;
+    name.sprnt ("%s_object", className);
+
+    tid_t id = get_struc_id (name.c_str ());
+    if (id == BADADDR) {
+        id = add_struc (BADADDR, name.c_str ());
+    }
+
+    struc_t *sptr = get_struc (id);
+    if (sptr == NULL) {
+        msg ("Could not create the object structure %s !\n", name.c_str ());
+        return false;
+    }
+
+    // Members already there were named or typed by the user, or by a
+    // previous run : only the gaps are filled
+    for (size_t i = 0; i < layout.fields.size (); i++)
+    {
+        const field_t &f = layout.fields[i];
+
+        if (get_member (sptr, f.offset) != NULL || get_member (sptr, f.offset + f.size - 1) != NULL) {
+            continue;
+        }
+
+        flags_t flags;
+        switch (f.size)
+        {
+            case 1: flags = byte_flag (); break;
+            case 2: flags = word_flag (); break;
+            case 4: flags = f.kind == FK_FLOAT ? float_flag () : dword_flag (); break;
+            case 8: flags = f.kind == FK_FLOAT ? double_flag () : qword_flag (); break;
+            default: flags = byte_flag (); break;
+        }
+
+        qstring memberName;
+        if (f.offset == 0) {
+            memberName = "__vftable";
+        }
+        else {
+            memberName.sprnt ("field_%X", f.offset);
+        }
+
+        if (add_struc_member (sptr, memberName.c_str (), f.offset, flags | FF_DATA, NULL, f.size) != 0) {
+            continue;
+        }
+
+        member_t *mptr = get_member (sptr, f.offset);
+        if (mptr == NULL || f.kind != FK_PTR) {
+            continue;
+        }
+
+        // __vftable points to the vftable structure when it is a local type
+        tinfo_t pointee;
+        qstring vtableName;
+        vtableName.sprnt ("%s_vtable", className);
+
+        if (f.offset != 0 || !pointee.get_named_type (get_idati (), vtableName.c_str ())) {
+            pointee = tinfo_t (BT_VOID);
+        }
+
+        tinfo_t ptr;
+        ptr.create_ptr (pointee);
+        set_member_tinfo (sptr, mptr, 0, ptr, 0);
+    }
+
+    // Fields after the last access are unknown, the structure still gets the size of the object
+    asize_t size = get_struc_size (sptr);
+    if (layout.size > size) {
+        expand_struc (sptr, size, layout.size - size);
+    }
+
+    return true;
+}
+
+size_t
+FieldLayout::recover (
+    const ClassRegistry *registry,
+    const VtableScanner *scanner,
+    DecMap *decMap
+) {
+    PROFILE_SCOPE ("FieldLayout::recover");
+
+    size_t classCount = registry->class_count ();
+
+    // The vftables of a class share its type descriptor (COL + 12), each one
+    // at the offset of its subobject (COL + 4). The primary vftable, at
+    // offset 0, owns the layout of the class
+    std::vector<int> owner (classCount, -1);
+    std::vector<uint32> shift (classCount, 0);
+    std::vector<ea_t> typeDesc (classCount, BADADDR);
+    std::map<ea_t, int> primary;
+
+    for (size_t c = 0; c < classCount; c++)
+    {
+        const ClassRegistry::class_t &cls = registry->get_class ((int) c);
+        if (!cls.alive) {
+            continue;
+        }
+
+        if (cls.col != 0 && cls.col != BADADDR && is_mapped (cls.col)) {
+            typeDesc[c] = IDAUtils::Dword (cls.col + 12);
+            shift[c] = IDAUtils::Dword (cls.col + 4);
+        }
+
+        if (shift[c] >= FL_MAX_OFFSET) {
+            typeDesc[c] = BADADDR;
+            shift[c] = 0;
+        }
+
+        if (shift[c] == 0) {
+            owner[c] = (int) c;
+            if (typeDesc[c] != BADADDR) {
+                owner[c] = primary.insert (std::make_pair (typeDesc[c], (int) c)).first->second;
+            }
+        }
+    }
+
+    // Secondary vftables join their primary one, those without it are left out
+    for (size_t c = 0; c < classCount; c++) {
+        if (owner[c] < 0 && typeDesc[c] != BADADDR) {
+            std::map<ea_t, int>::const_iterator it = primary.find (typeDesc[c]);
+            if (it != primary.end ()) {
+                owner[c] = it->second;
+            }
+        }
+    }
+
+    // Methods of every class and the offset of their `this` : the slot targets,
+    // and the functions storing the vftable at offset 0
+    typedef std::pair<ea_t, uint32> method_t;
+    std::vector<std::vector<method_t> > methods (classCount);
+    std::vector<ea_t> all;
+
+    for (size_t c = 0; c < classCount; c++)
+    {
+        const ClassRegistry::class_t &cls = registry->get_class ((int) c);
+        if (owner[c] < 0) {
+            continue;
+        }
+
+        for (uint32 i = 0; i < cls.slot_count; i++) {
+            if (registry->slot_func ((int) c, i) != BADADDR) {
+                methods[owner[c]].push_back (method_t (registry->slot_func ((int) c, i), shift[c]));
+            }
+        }
+    }
+
+    if (scanner != NULL)
+    {
+        // The vftables stored at offset 0 before the last one are those of the
+        // bases : the function builds or destroys the class it stores last
+        std::map<ea_t, const VtableWriters::writer_t *> last;
+        const std::vector<VtableWriters::writer_t> &stores = scanner->getWriters ().get_writers ();
+
+        for (size_t i = 0; i < stores.size (); i++)
+        {
+            if (stores[i].offset != 0) {
+                continue;
+            }
+
+            const VtableWriters::writer_t *&l = last[stores[i].func];
+            if (l == NULL || stores[i].insn > l->insn) {
+                l = &stores[i];
+            }
+        }
+
+        for (std::map<ea_t, const VtableWriters::writer_t *>::const_iterator it = last.begin (); it != last.end (); ++it)
+        {
+            int c = registry->find_class (it->second->vtable);
+            if (c >= 0 && owner[c] >= 0 && shift[c] == 0) {
+                methods[owner[c]].push_back (method_t (it->first, 0));
+            }
+        }
+    }
+
+    for (size_t c = 0; c < classCount; c++)
+    {
+        std::vector<method_t> &list = methods[c];
+        std::sort (list.begin (), list.end ());
+        list.erase (std::unique (list.begin (), list.end ()), list.end ());
+
+        for (size_t i = 0; i < list.size (); i++) {
+            all.push_back (list[i].first);
+        }
+    }
+
+    std::sort (all.begin (), all.end ());
+    all.erase (std::unique (all.begin (), all.end ()), all.end ());
+
+    // Decompile what isn't known yet, on this thread : the decompiler can't
+    // run anywhere else
+    bool cancelled = false;
+    {
+        ScopedPhase phase ("decompile");
+        show_wait_box ("Decompiling methods...");
+
+        for (size_t i = 0; i < all.size (); i++)
+        {
+            // The methods followed here are refreshed from the decompilations
+            // the user makes, the cache keeps them too
+            decMap->add_interesting (all[i]);
+
+            if (this->known.contains (all[i])) {
+                continue;
+            }
+
+            if ((i & 15) == 0) {
+                replace_wait_box ("Decompiling methods... %d / %d", (int) i, (int) all.size ());
+                if (user_cancelled ()) {
+                    cancelled = true;
+                    break;
+                }
+            }
+
+            phase.add_items (1);
+
+            cfuncptr_t cfunc = decMap->get (all[i]);
+            if (cfunc != NULL) {
+                collect (cfunc);
+            }
+            else {
+                // Failed, don't try again until it changes
+                this->accesses[all[i]].clear ();
+                this->known.add (all[i]);
+            }
+        }
+
+        hide_wait_box ();
+    }
+
+    update_memory ();
+
+    // The accesses collected so far are kept for the next run
+    if (cancelled) {
+        msg ("RECPP: layout recovery cancelled, no structure written\n");
+        return 0;
+    }
+
+    // Reduce the classes in parallel, the map is only read from here
+    std::vector<std::vector<source_t> > sources (classCount);
+    std::vector<uint32> sizes (classCount, 0);
+
+    for (size_t c = 0; c < classCount; c++)
+    {
+        if (owner[c] != (int) c) {
+            continue;
+        }
+
+        for (size_t i = 0; i < methods[c].size (); i++) {
+            ea_access_map_t::const_iterator it = this->accesses.find (methods[c][i].first);
+            if (it != this->accesses.end ()) {
+                source_t s = { &it->second, methods[c][i].second };
+                sources[c].push_back (s);
+            }
+        }
+
+        if (scanner != NULL) {
+            sizes[c] = scanner->getObjectSizes ().get_size (registry->get_class ((int) c).vtable);
+        }
+    }
+
+    std::vector<layout_t> layouts (classCount);
+    {
+        ScopedPhase phase ("reduce");
+        phase.add_items (classCount);
+
+        parallel_for (classCount, [&] (size_t c) {
+            reduce (sources[c], sizes[c], &layouts[c]);
+        });
+    }
+
+    // Write the structures
+    size_t written = 0;
+    uint32 conflicts = 0;
+
+    for (size_t c = 0; c < classCount; c++)
+    {
+        const ClassRegistry::class_t &cls = registry->get_class ((int) c);
+
+        // The vftable pointer alone isn't worth a structure
+        if (owner[c] != (int) c || cls.name.empty () || layouts[c].fields.size () < 2) {
+            continue;
+        }
+
+        if (write_struct (cls.name.c_str (), layouts[c])) {
+            written++;
+            conflicts += layouts[c].conflicts;
+        }
+    }
+
+    msg ("RECPP: %d object structure(s) written from %d method(s), %d conflicting access(es) dropped\n",
+         (int) written, (int) all.size (), (int) conflicts);
+
+    return written;
+}
@@ -0,0 +1,177 @@
+﻿/*
+    ██████╗ ███████╗ ██████╗██████╗ ██████╗ 
+    ██╔══██╗██╔════╝██╔════╝██╔══██╗██╔══██╗
+    ██████╔╝█████╗  ██║     ██████╔╝██████╔╝
+    ██╔══██╗██╔══╝  ██║     ██╔═══╝ ██╔═══╝ 
+    ██║  ██║███████╗╚██████╗██║     ██║     
+    ╚═╝  ╚═╝╚══════╝ ╚═════╝╚═╝     ╚═╝     
+* @license : <license placeholder>
+*/
+
+#pragma once
+
+
+// ---------- Includes ------------
+#include "RECPP.h"
+#include "FuncFilter.h"
+#include "MemStats.h"
+#include <vector>
+#include <map>
+
+// ---------- Defines -------------
+#define FL_READ        0x01
+#define FL_WRITE       0x02
+
+#define FK_INT         0
+#define FK_FLOAT       1
+#define FK_PTR         2
+
+#define FL_MAX_OFFSET  0x100000 // further from this is not a field
+#define FL_MAX_SIZE    16
+
+
+// ------ Class definition --------
+
+class ClassRegistry;
+class VtableScanner;
+class DecMap;
+
+// Field layout of the classes, recovered from the way their methods use
+// `this` in the decompiled code :
+//
+//     *((_DWORD *)this + 3) = 0;          -> field_C, dword, written
+//     v2 = *((float *)this + 5);          -> field_14, float, read
+//
+// The accesses of every method (virtual methods and the functions storing
+// the vftable) are collected once on the main thread, where the decompiler
+// runs, and kept per function. Methods are only decompiled again when they
+// changed, and a new decompilation of a known method refreshes its accesses.
+// The accesses of each class are then merged into a list of fields in
+// parallel, and written as a structure whose first member is the vftable
+// pointer.
+//
+// The vftables of a class are grouped by type descriptor : the methods of a
+// secondary vftable see `this` at the offset of their subobject, their
+// accesses are shifted by that offset into the layout of the primary one.
+class FieldLayout
+{
+public:
+    struct access_t
+    {
+        uint32 offset;
+        uint32 size;
+        uint8 kind;         // FK_*
+        uint8 flags;        // FL_READ / FL_WRITE
+    };
+
+    struct field_t
+    {
+        uint32 offset;
+        uint32 size;
+        uint8 kind;
+        uint8 flags;
+        uint32 votes;       // methods using this exact access
+    };
+
+    struct layout_t
+    {
+        std::vector<field_t> fields;
+        uint32 size;        // size of the object if known, 0 otherwise
+        uint32 conflicts;   // overlapping accesses that lost
+    };
+
+    // Accesses of one method, and where its `this` is in the object
+    struct source_t
+    {
+        const std::vector<access_t> *accesses;
+        uint32 shift;
+    };
+
+    static FieldLayout *
+    get (
+        void
+    );
+
+    static void
+    term (
+        void
+    );
+
+    /*
+     * @brief : Recover the layout of every class of the registry and write the structures
+     * @param scanner : Gives the constructors and object sizes, can be NULL
+     * @return The number of structures written
+     */
+    size_t
+    recover (
+        const ClassRegistry *registry,
+        const VtableScanner *scanner,
+        DecMap *decMap
+    );
+
+    /*
+     * @brief : A function was decompiled, refresh its accesses if it is a known method
+     */
+    void
+    on_decompiled (
+        cfunc_t *cfunc
+    );
+
+    /*
+     * @brief : Forget the accesses of a function, it will be decompiled again
+     */
+    void
+    invalidate (
+        ea_t funcEa
+    );
+
+    /*
+     * @brief : Merge the accesses of the methods of a class into fields.
+     *          Memory only, called from the workers
+     * @param objectSize : Size of the object if known, 0 otherwise
+     */
+    static void
+    reduce (
+        const std::vector<source_t> &sources,
+        uint32 objectSize,
+        layout_t *out
+    );
+
+private:
+    FieldLayout ();
+    ~FieldLayout ();
+
+    static FieldLayout *instance;
+
+    // Accesses of every method, sorted by offset
+    typedef std::map<ea_t, std::vector<access_t> > ea_access_map_t;
+    ea_access_map_t accesses;
+
+    // Keys of accesses, checked before touching the map
+    FuncFilter known;
+
+    MemStats::held_t memory;
+
+    void
+    collect (
+        cfunc_t *cfunc
+    );
+
+    /*
+     * @brief : Add the fields to the object structure of a class, creating it if needed,
+     *          and grow it up to the size of the object
+     */
+    static bool
+    write_struct (
+        const char *className,
+        const layout_t &layout
+    );
+
+    /*
+     * @brief : Report the current size of the containers to MemStats
+     */
+    void
+    update_memory (
+        void
+    );
+};
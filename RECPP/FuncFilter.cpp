@@ -0,0 +1,86 @@
+﻿/*
+    ██████╗ ███████╗ ██████╗██████╗ ██████╗ 
+    ██╔══██╗██╔════╝██╔════╝██╔══██╗██╔══██╗
+    ██████╔╝█████╗  ██║     ██████╔╝██████╔╝
+    ██╔══██╗██╔══╝  ██║     ██╔═══╝ ██╔═══╝ 
+    ██║  ██║███████╗╚██████╗██║     ██║     
+    ╚═╝  ╚═╝╚══════╝ ╚═════╝╚═╝     ╚═╝     
+* @license : <license placeholder>
+*/
+
+#include "FuncFilter.h"
+
+
+FuncFilter::FuncFilter () {
+    clear ();
+}
+
+void
+FuncFilter::clear (
+    void
+) {
+    this->exact.clear ();
+    this->blocks.assign (FUNCFILTER_MIN_BLOCKS * 8, 0);
+    this->removed = 0;
+}
+
+void
+FuncFilter::set_bits (
+    ea_t ea
+) {
+    uint64 h = hash (ea);
+    uint64 *block = &this->blocks[(size_t) (((h >> 32) * this->blocks.size () / 8) >> 32) * 8];
+
+    for (int i = 0; i < 4; i++, h >>= 9) {
+        uint32 bit = (uint32) h & 511;
+        block[bit >> 6] |= (uint64) 1 << (bit & 63);
+    }
+}
+
+void
+FuncFilter::rebuild (
+    size_t capacity
+) {
+    size_t count = (capacity * FUNCFILTER_BITS_PER_ITEM + 511) / 512;
+    if (count < FUNCFILTER_MIN_BLOCKS) {
+        count = FUNCFILTER_MIN_BLOCKS;
+    }
+
+    this->blocks.assign (count * 8, 0);
+    this->removed = 0;
+
+    for (std::unordered_set<ea_t>::const_iterator it = this->exact.begin (); it != this->exact.end (); ++it) {
+        set_bits (*it);
+    }
+}
+
+void
+FuncFilter::add (
+    ea_t ea
+) {
+    if (!this->exact.insert (ea).second) {
+        return;
+    }
+
+    // Keep the false positive rate down as the set grows
+    if (this->exact.size () * FUNCFILTER_BITS_PER_ITEM > this->blocks.size () * 64) {
+        rebuild (this->exact.size () * 2);
+        return;
+    }
+
+    set_bits (ea);
+}
+
+void
+FuncFilter::remove (
+    ea_t ea
+) {
+    if (this->exact.erase (ea) == 0) {
+        return;
+    }
+
+    // Bloom bits can't be cleared, drop them once they're a good part of the filter
+    if (++this->removed > this->exact.size ()) {
+        rebuild (this->exact.size () * 2);
+    }
+}
@@ -0,0 +1,109 @@
+﻿/*
+    ██████╗ ███████╗ ██████╗██████╗ ██████╗ 
+    ██╔══██╗██╔════╝██╔════╝██╔══██╗██╔══██╗
+    ██████╔╝█████╗  ██║     ██████╔╝██████╔╝
+    ██╔══██╗██╔══╝  ██║     ██╔═══╝ ██╔═══╝ 
+    ██║  ██║███████╗╚██████╗██║     ██║     
+    ╚═╝  ╚═╝╚══════╝ ╚═════╝╚═╝     ╚═╝     
+* @license : <license placeholder>
+*/
+
+#pragma once
+
+
+// ---------- Includes ------------
+#include "RECPP.h"
+#include <vector>
+#include <unordered_set>
+
+// ---------- Defines -------------
+#define FUNCFILTER_BITS_PER_ITEM 12 // ~0.5% false positives with 4 probes per block
+#define FUNCFILTER_MIN_BLOCKS    16
+
+
+// ------ Class definition --------
+// Membership filter for function addresses, tuned for "no" answers.
+// A blocked Bloom filter (one 512 bit, cache line sized block per address)
+// rejects almost every address with a single memory access, the exact set
+// behind it is only consulted for the few that pass.
+class FuncFilter
+{
+public:
+    FuncFilter ();
+
+    void
+    add (
+        ea_t ea
+    );
+
+    void
+    remove (
+        ea_t ea
+    );
+
+    void
+    clear (
+        void
+    );
+
+    /*
+     * @brief : Is \ea in the set ?
+     */
+    bool
+    contains (
+        ea_t ea
+    ) const {
+        uint64 h = hash (ea);
+        const uint64 *block = &this->blocks[(size_t) (((h >> 32) * this->blocks.size () / 8) >> 32) * 8];
+
+        if (!probe (block, h)) {
+            return false;
+        }
+
+        return this->exact.find (ea) != this->exact.end ();
+    }
+
+    size_t size () const { return this->exact.size (); }
+
+private:
+    std::vector<uint64> blocks;     // 8 words per block
+    std::unordered_set<ea_t> exact;
+    size_t removed;                 // stale bits since the last rebuild
+
+    static uint64
+    hash (
+        ea_t ea
+    ) {
+        // splitmix64 finalizer
+        uint64 h = (uint64) ea + 0x9E3779B97F4A7C15ULL;
+        h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        h = (h ^ (h >> 27)) * 0x94D049BB133111EBULL;
+        return h ^ (h >> 31);
+    }
+
+    // 4 bits of the block, picked by 4 x 9 bits of the low half of the hash
+    static bool
+    probe (
+        const uint64 *block,
+        uint64 h
+    ) {
+        for (int i = 0; i < 4; i++, h >>= 9) {
+            uint32 bit = (uint32) h & 511;
+            if ((block[bit >> 6] & ((uint64) 1 << (bit & 63))) == 0) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    void
+    set_bits (
+        ea_t ea
+    );
+
+    void
+    rebuild (
+        size_t capacity
+    );
+};
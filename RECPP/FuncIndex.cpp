@@ -0,0 +1,159 @@
+﻿/*
+    ██████╗ ███████╗ ██████╗██████╗ ██████╗ 
+    ██╔══██╗██╔════╝██╔════╝██╔══██╗██╔══██╗
+    ██████╔╝█████╗  ██║     ██████╔╝██████╔╝
+    ██╔══██╗██╔══╝  ██║     ██╔═══╝ ██╔═══╝ 
+    ██║  ██║███████╗╚██████╗██║     ██║     
+    ╚═╝  ╚═╝╚══════╝ ╚═════╝╚═╝     ╚═╝     
+* @license : <license placeholder>
+*/
+
+#include "FuncIndex.h"
+#include "Profiler.h"
+#include <algorithm>
+
+FuncIndex *FuncIndex::instance = NULL;
+
+
+FuncIndex::FuncIndex () {
+    this->valid = false;
+}
+
+FuncIndex::~FuncIndex () {
+    MemStats::account (MEM_SCANNER, &this->memory, 0, 0);
+}
+
+FuncIndex *
+FuncIndex::get (
+    void
+) {
+    if (instance == NULL) {
+        instance = new FuncIndex ();
+    }
+
+    return instance;
+}
+
+void
+FuncIndex::term (
+    void
+) {
+    delete instance;
+    instance = NULL;
+}
+
+void
+FuncIndex::build (
+    void
+) {
+    PROFILE_SCOPE ("FuncIndex::build");
+
+    struct chunk_t
+    {
+        ea_t start;
+        ea_t end;
+        ea_t owner;
+
+        bool operator< (const chunk_t &o) const { return start < o.start; }
+    };
+
+    std::vector<chunk_t> chunks;
+    size_t count = get_func_qty ();
+
+    chunks.reserve (count);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        func_t *pfn = getn_func (i);
+        if (pfn == NULL) {
+            continue;
+        }
+
+        func_tail_iterator_t fti (pfn);
+        for (bool ok = fti.main (); ok; ok = fti.next ()) {
+            chunk_t c = { fti.chunk ().start_ea, fti.chunk ().end_ea, pfn->start_ea };
+            chunks.push_back (c);
+        }
+    }
+
+    std::sort (chunks.begin (), chunks.end ());
+
+    this->starts.resize (chunks.size ());
+    this->ends.resize (chunks.size ());
+    this->owners.resize (chunks.size ());
+
+    for (size_t i = 0; i < chunks.size (); i++) {
+        this->starts[i] = chunks[i].start;
+        this->ends[i]   = chunks[i].end;
+        this->owners[i] = chunks[i].owner;
+    }
+
+    this->valid = true;
+
+    MemStats::account (MEM_SCANNER, &this->memory,
+                       this->starts.capacity () * 3 * sizeof (ea_t),
+                       this->starts.size ());
+}
+
+void
+FuncIndex::ensure (
+    void
+) {
+    if (!this->valid) {
+        build ();
+    }
+}
+
+void
+FuncIndex::invalidate (
+    void
+) {
+    if (!this->valid) {
+        return;
+    }
+
+    this->valid = false;
+    std::vector<ea_t> ().swap (this->starts);
+    std::vector<ea_t> ().swap (this->ends);
+    std::vector<ea_t> ().swap (this->owners);
+
+    MemStats::account (MEM_SCANNER, &this->memory, 0, 0);
+}
+
+// The loop has no data dependent branch : the compare becomes a cmov, and
+// the only branch left is on the (predictable) remaining length
+ssize_t
+FuncIndex::last_not_above (
+    const std::vector<ea_t> &values,
+    ea_t ea
+) {
+    size_t n = values.size ();
+    if (n == 0 || values[0] > ea) {
+        return -1;
+    }
+
+    const ea_t *base = &values[0];
+    while (n > 1) {
+        size_t half = n / 2;
+        base = base[half] <= ea ? base + half : base;
+        n -= half;
+    }
+
+    return base - &values[0];
+}
+
+ea_t
+FuncIndex::func_start (
+    ea_t ea
+) const {
+    if (this->valid) {
+        ssize_t i = last_not_above (this->starts, ea);
+        if (i >= 0 && ea < this->ends[i]) {
+            return this->owners[i];
+        }
+    }
+
+    // Not in the snapshot : no snapshot, or a function added since
+    func_t *pfn = get_func (ea);
+    return pfn != NULL ? pfn->start_ea : BADADDR;
+}
@@ -0,0 +1,103 @@
+﻿/*
+    ██████╗ ███████╗ ██████╗██████╗ ██████╗ 
+    ██╔══██╗██╔════╝██╔════╝██╔══██╗██╔══██╗
+    ██████╔╝█████╗  ██║     ██████╔╝██████╔╝
+    ██╔══██╗██╔══╝  ██║     ██╔═══╝ ██╔═══╝ 
+    ██║  ██║███████╗╚██████╗██║     ██║     
+    ╚═╝  ╚═╝╚══════╝ ╚═════╝╚═╝     ╚═╝     
+* @license : <license placeholder>
+*/
+
+#pragma once
+
+
+// ---------- Includes ------------
+#include "RECPP.h"
+#include "MemStats.h"
+#include <vector>
+
+// ---------- Defines -------------
+
+
+// ------ Class definition --------
+// Snapshot of the function chunks of the database, to find the function
+// containing an address without going through the kernel.
+//
+// Chunks (tails included) are kept sorted by start address, in separate
+// arrays so that the search only touches the starts, and looked up with a
+// branchless binary search.
+// Functions added after the snapshot are found by falling back to get_func
+// on a miss. Deleted or resized functions would give wrong answers, so those
+// events invalidate the snapshot until the next build.
+class FuncIndex
+{
+public:
+    static FuncIndex *
+    get (
+        void
+    );
+
+    static void
+    term (
+        void
+    );
+
+    /*
+     * @brief : Take a new snapshot of every function chunk
+     */
+    void
+    build (
+        void
+    );
+
+    /*
+     * @brief : Build the snapshot if there is no valid one
+     */
+    void
+    ensure (
+        void
+    );
+
+    /*
+     * @brief : Drop the snapshot, the lookups go to the kernel until the next build
+     */
+    void
+    invalidate (
+        void
+    );
+
+    bool is_valid () const { return this->valid; }
+    size_t size () const { return this->starts.size (); }
+
+    /*
+     * @brief : Get the start of the function containing an address
+     * @return The function start (the owner for a tail), or BADADDR
+     */
+    ea_t
+    func_start (
+        ea_t ea
+    ) const;
+
+private:
+    FuncIndex ();
+    ~FuncIndex ();
+
+    static FuncIndex *instance;
+
+    std::vector<ea_t> starts;   // chunk starts, sorted
+    std::vector<ea_t> ends;
+    std::vector<ea_t> owners;   // function of each chunk
+    bool valid;
+
+    MemStats::held_t memory;
+
+    /*
+     * @brief : Index of the last value <= ea in a sorted array
+     * @return The index, or -1 if every value is above ea
+     */
+    static ssize_t
+    last_not_above (
+        const std::vector<ea_t> &values,
+        ea_t ea
+    );
+};
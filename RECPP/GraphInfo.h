@@ -14,13 +14,14 @@
 // ---------- Includes ------------
 #include "RECPP.h"
 #include "CallGraph.h"
+#include "MemStats.h"
 
 // ---------- Defines -------------
 
 
 // ------ Class definition --------
 
-class GraphInfo
+class GraphInfo : public MemTracked<MEM_CALLGRAPH>
 {
 // Actual context variables
 public:
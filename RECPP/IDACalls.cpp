@@ -0,0 +1,157 @@
+﻿/*
+    ██████╗ ███████╗ ██████╗██████╗ ██████╗ 
+    ██╔══██╗██╔════╝██╔════╝██╔══██╗██╔══██╗
+    ██████╔╝█████╗  ██║     ██████╔╝██████╔╝
+    ██╔══██╗██╔══╝  ██║     ██╔═══╝ ██╔═══╝ 
+    ██║  ██║███████╗╚██████╗██║     ██║     
+    ╚═╝  ╚═╝╚══════╝ ╚═════╝╚═╝     ╚═╝     
+* @license : <license placeholder>
+*/
+
+#include "IDACalls.h"
+#include <algorithm>
+
+std::vector<IDACalls::counter_t> IDACalls::counters;
+uint32 IDACalls::sample_rate = IDA_CALL_SAMPLE_RATE;
+uint32 IDACalls::tick = 0;
+
+static const char *const api_names[IDACalls::API_COUNT] = {
+    "get_byte",
+    "get_bytes",
+    "get_dword",
+    "get_flags",
+    "get_func",
+    "get_name",
+    "force_name",
+    "demangle_name",
+    "xref iteration",
+    "create_insn",
+    "add_func",
+    "add_struc_member",
+    "set_member_name",
+};
+
+
+IDACalls::counter_t &
+IDACalls::get_counter (
+    int api
+) {
+    size_t index = (size_t) Profiler::get ()->current_node () * API_COUNT + api;
+
+    if (index >= counters.size ()) {
+        counter_t zero = { 0, 0, 0 };
+        counters.resize ((index / API_COUNT + 1) * API_COUNT, zero);
+    }
+
+    return counters[index];
+}
+
+bool
+IDACalls::hit (
+    int api
+) {
+    get_counter (api).calls++;
+
+    // One clock shared by all the APIs, so that interleaved calls still get sampled
+    if (sample_rate == 0 || ++tick < sample_rate) {
+        return false;
+    }
+
+    tick = 0;
+    return true;
+}
+
+void
+IDACalls::record (
+    int api,
+    uint64 ns
+) {
+    counter_t &c = get_counter (api);
+    c.samples++;
+    c.sampled_ns += ns;
+}
+
+void
+IDACalls::set_sample_rate (
+    uint32 rate
+) {
+    sample_rate = rate;
+    tick = 0;
+}
+
+void
+IDACalls::reset (
+    void
+) {
+    counters.clear ();
+    tick = 0;
+}
+
+void
+IDACalls::report (
+    void
+) {
+    if (!PROFILER_ENABLED) {
+        return;
+    }
+
+    struct row_t
+    {
+        int api;
+        int phase;
+        uint64 calls;
+        double avg_ns;
+        double est_ns;  // sampled average times all the calls
+
+        bool operator< (const row_t &o) const {
+            if (est_ns != o.est_ns) return est_ns > o.est_ns;
+            return calls > o.calls;
+        }
+    };
+
+    std::vector<row_t> rows;
+    uint64 totals[API_COUNT] = { 0 };
+
+    for (size_t i = 0; i < counters.size (); i++)
+    {
+        const counter_t &c = counters[i];
+        if (c.calls == 0) {
+            continue;
+        }
+
+        // Counted under a phase the profiler has forgotten since
+        if ((int) (i / API_COUNT) >= Profiler::get ()->node_count ()) {
+            continue;
+        }
+
+        row_t r;
+        r.api    = (int) (i % API_COUNT);
+        r.phase  = (int) (i / API_COUNT);
+        r.calls  = c.calls;
+        r.avg_ns = c.samples ? (double) c.sampled_ns / c.samples : 0;
+        r.est_ns = r.avg_ns * c.calls;
+
+        rows.push_back (r);
+        totals[r.api] += c.calls;
+    }
+
+    std::sort (rows.begin (), rows.end ());
+
+    msg ("----- RECPP kernel calls -----\n");
+    msg ("%-18s %-24s %10s %10s %10s\n", "api", "phase", "calls", "avg ns", "est. ms");
+
+    for (size_t i = 0; i < rows.size () && i < IDA_CALL_REPORT_ROWS; i++) {
+        msg ("%-18s %-24s %10d %10.0f %10.3f\n",
+             api_names[rows[i].api],
+             Profiler::get ()->get_node (rows[i].phase).name,
+             (int) rows[i].calls, rows[i].avg_ns, rows[i].est_ns / 1e6);
+    }
+
+    msg ("Calls per api :");
+    for (int a = 0; a < API_COUNT; a++) {
+        if (totals[a] != 0) {
+            msg (" %s %d", api_names[a], (int) totals[a]);
+        }
+    }
+    msg ("\n");
+}
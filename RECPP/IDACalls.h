@@ -0,0 +1,144 @@
+﻿/*
+    ██████╗ ███████╗ ██████╗██████╗ ██████╗ 
+    ██╔══██╗██╔════╝██╔════╝██╔══██╗██╔══██╗
+    ██████╔╝█████╗  ██║     ██████╔╝██████╔╝
+    ██╔══██╗██╔══╝  ██║     ██╔═══╝ ██╔═══╝ 
+    ██║  ██║███████╗╚██████╗██║     ██║     
+    ╚═╝  ╚═╝╚══════╝ ╚═════╝╚═╝     ╚═╝     
+* @license : <license placeholder>
+*/
+
+#pragma once
+
+
+// ---------- Includes ------------
+#include "RECPP.h"
+#include "Profiler.h"
+#include <vector>
+
+// ---------- Defines -------------
+#define IDA_CALL_SAMPLE_RATE 64 // one call out of this many is timed
+#define IDA_CALL_REPORT_ROWS 40
+
+// Account a kernel call : IDA_CALL (GET_DWORD, get_dword (ea)).
+// Only built along with the profiler, expr is evaluated as is otherwise.
+#define IDA_CALL(api, expr) IDACallT<PROFILER_ENABLED>::call (IDACalls::API_##api, [&] () { return (expr); })
+
+
+// ------ Class definition --------
+// Number of calls to the IDA kernel, per API and per profiler phase.
+// A sample of the calls is also timed, to estimate the time spent in each
+// API without reading the clock around every call.
+class IDACalls
+{
+public:
+    enum api_t
+    {
+        API_GET_BYTE,
+        API_GET_BYTES,
+        API_GET_DWORD,
+        API_GET_FLAGS,
+        API_GET_FUNC,
+        API_GET_NAME,
+        API_FORCE_NAME,
+        API_DEMANGLE,
+        API_XREF,
+        API_CREATE_INSN,
+        API_ADD_FUNC,
+        API_ADD_STRUC_MEMBER,
+        API_SET_MEMBER_NAME,
+        API_COUNT
+    };
+
+    struct counter_t
+    {
+        uint64 calls;
+        uint64 samples;
+        uint64 sampled_ns;
+    };
+
+    /*
+     * @brief : Count a call
+     * @return true if this call has to be timed
+     */
+    static bool
+    hit (
+        int api
+    );
+
+    /*
+     * @brief : Add the time of a sampled call
+     */
+    static void
+    record (
+        int api,
+        uint64 ns
+    );
+
+    /*
+     * @brief : Time 1 call out of \rate, 0 only counts
+     */
+    static void
+    set_sample_rate (
+        uint32 rate
+    );
+
+    static void
+    reset (
+        void
+    );
+
+    /*
+     * @brief : Print the (API, phase) pairs, the most expensive first
+     */
+    static void
+    report (
+        void
+    );
+
+private:
+    // [phase * API_COUNT + api]
+    static std::vector<counter_t> counters;
+    static uint32 sample_rate;
+    static uint32 tick;
+
+    static counter_t &
+    get_counter (
+        int api
+    );
+};
+
+// Times the sampled calls
+class IDACallTimer
+{
+public:
+    IDACallTimer (int api) : api (api), start (get_nsec_stamp ()) { }
+    ~IDACallTimer () { IDACalls::record (this->api, get_nsec_stamp () - this->start); }
+
+private:
+    int api;
+    uint64 start;
+};
+
+template <bool Enabled>
+struct IDACallT
+{
+    template <typename Fn>
+    static auto call (int, Fn fn) -> decltype (fn ()) {
+        return fn ();
+    }
+};
+
+template <>
+struct IDACallT<true>
+{
+    template <typename Fn>
+    static auto call (int api, Fn fn) -> decltype (fn ()) {
+        if (!IDACalls::hit (api)) {
+            return fn ();
+        }
+
+        IDACallTimer timer (api);
+        return fn ();
+    }
+};
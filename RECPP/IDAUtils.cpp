@@ -2,6 +2,8 @@
 #include "offset.hpp"
 #include "frame.hpp"
 #include "struct.hpp"
+#include "IDACalls.h"
+#include "StrUtils.h"
 
 #define FF_DWRD     0x20000000LU
 #define FF_STRU     0x60000000LU
@@ -9,24 +11,7 @@
 int
 str_n_pos (char *str, const char *search, int len_str)
 {
-	int i,  len_string = len_str,
-            len_search = strlen (search);
-	int count = 0;
-
-	for (i = 0; i < len_string; i++)
-	{
-		if (str[i] == search[count])
-			count++;
-		else
-			count = 0;
-
-		if (count == len_search)
-		{
-			return i - len_search + 1;
-		}
-	}
-
-	return -1;
+	return str_find (str, len_str, search);
 }
 
 int
@@ -59,25 +44,36 @@ std::string IDAUtils::string_sprintf (const char* format, ...)
     return str;
 }
 
+// Kernel readers for the StrUtils primitives
+static uint8_t
+read_kernel_byte (
+    void *,
+    uint32_t address
+) {
+    return (uint8_t) IDA_CALL (GET_BYTE, get_byte (address));
+}
+
+static int
+read_kernel_bytes (
+    void *,
+    uint8_t *buffer,
+    size_t size,
+    uint32_t address
+) {
+    return (int) IDA_CALL (GET_BYTES, get_bytes (buffer, size, address));
+}
+
 char *
 IDAUtils::GetAsciizStr (
     ea_t address,
     char *buffer,
     size_t bufferSize
 ) {
-    char curByte;
-    size_t bufferPos = 0;
-
-    while (curByte = get_byte (address)) {
-        buffer [bufferPos++] = curByte;
-        address++;
-        if (bufferPos > bufferSize) {
-            msg ("Type name too long, cannot continue.\n");
-            return NULL;
-        }
+    if (get_asciiz_str (read_kernel_bytes, read_kernel_byte, NULL, address, buffer, bufferSize) == NULL) {
+        msg ("Type name too long, cannot continue.\n");
+        return NULL;
     }
 
-    buffer[bufferPos] = '\0';
     return buffer;
 }
 
@@ -119,7 +115,7 @@ ea_t
 IDAUtils::DfirstB (
     int to
 ) {
-    return get_first_dref_to (to);
+    return IDA_CALL (XREF, get_first_dref_to (to));
 }
 
 ea_t 
@@ -127,7 +123,7 @@ IDAUtils::DnextB (
     int to,
     int current
 ) {
-    return get_next_dref_to (to, current);
+    return IDA_CALL (XREF, get_next_dref_to (to, current));
 }
 
 bool 
@@ -206,14 +202,14 @@ int
 IDAUtils::MakeCode (
     ea_t address
 ) {
-    return create_insn(address);
+    return IDA_CALL (CREATE_INSN, create_insn (address));
 }
 
 uint32
 IDAUtils::Dword (
     ea_t address
 ) {
-    return get_dword (address);
+    return IDA_CALL (GET_DWORD, get_dword (address));
 }
 
 tid_t
@@ -326,22 +322,21 @@ IDAUtils::GetArraySize (
 
 void
 IDAUtils::doAddrList (
-    char *name
+    char *name,
+    const addr_list_t &list
 ) {
-    tid_t idx, id;
     ea_t val, ctr, dtr;
 
-    id = IDAUtils::GetArrayId("AddrList");
     ctr = 0; dtr = 0;
 
-    if (name != NULL && id != -1)
+    if (name != NULL)
     {
-        if (IDAUtils::GetArraySize (id) != 2) {
+        if (list.size () != 2) {
             return;
         }
-        for ( idx = IDAUtils::GetFirstIndex (AR_LONG, id); idx != -1; idx = IDAUtils::GetNextIndex (AR_LONG, id, idx) )
+        for (size_t idx = 0; idx < list.size (); idx++)
         {
-            val = IDAUtils::GetArrayElementA (id, idx);
+            val = list[idx];
             
             if (IDAUtils::Byte (val) == 0xE9) {
                 val = IDAUtils::getRelJmpTarget(val);
@@ -361,8 +356,6 @@ IDAUtils::doAddrList (
         char buffer[4096] = {0};
         IDAUtils::MakeName(ctr, IDAUtils::MakeSpecialName (name, SN_constructor, 0, buffer, sizeof (buffer)));
     }
-
-    IDAUtils::DeleteArray (IDAUtils::GetArrayId ("AddrList"));
 }
 
 
@@ -413,7 +406,7 @@ IDAUtils::AddStrucMember (
 ) {
 	opinfo_t mt;
     // Calls an internal function to initialize mt using typeid
-    return add_struc_member (get_struc (id), name, offset, flag, &mt, nbytes);
+    return IDA_CALL (ADD_STRUC_MEMBER, add_struc_member (get_struc (id), name, offset, flag, &mt, nbytes));
 }
 
 bool
@@ -422,7 +415,7 @@ IDAUtils::SetMemberName (
     long member_offset,
     char *name
 ) {
-    return set_member_name (get_struc (id), member_offset, name);
+    return IDA_CALL (SET_MEMBER_NAME, set_member_name (get_struc (id), member_offset, name));
 }
 
 char *
@@ -467,38 +460,6 @@ IDAUtils::ForceDWMember (
     }
 }
 
-bool
-IDAUtils::ForceMethodMember (
-    tid_t id, 
-    int offset, 
-    char *name,
-    size_t nameSize
-) {
-    int status;
-    char completeName[4096] = {0};
-    if ((status = IDAUtils::AddStrucMember (id, name, offset, FF_DWRD | FF_DATA, -1, 4)) != 0) {
-        if (status != STRUC_ERROR_MEMBER_OFFSET && status != STRUC_ERROR_MEMBER_NAME) {
-            return false;
-        }
-
-        if (!(IDAUtils::SetMemberName (id, offset, name))) {
-            int suffixId = 1;
-            do {
-                if (suffixId > 1000) {
-                    // Alright, let's give up
-                    return false;
-                }
-                sprintf_s (completeName, sizeof (completeName), "%s_%d", name, suffixId++);
-            } while (IDAUtils::AddStrucMember (id, completeName, offset, FF_DWRD | FF_DATA, -1, 4) != 0);
-        }
-        else {
-            return true;
-        }
-    }
-    
-    return false;
-}
-
 ea_t
 IDAUtils::getRelCallTarget (
     ea_t address
@@ -625,33 +586,12 @@ IDAUtils::matchBytes (
 ) {
     size_t len = strlen(match);
 
-    if (len % 2) { 
+    if (len % 2 || len / 2 > PATTERN_MAX_BYTES) { 
         msg ("Bad match string in matchBytes: %s", match);
         return false;
     }
 
-    size_t i = 0;
-    char s[3] = {0};
-    char s2[3] = {0};
-
-    while (i < len)
-    {
-        s[0] = match[i];
-        s[1] = match[i+1];
-        sprintf_s (s2, "%02X", IDAUtils::Byte (address));
-
-        if ((strncmp (s, "??", 2) != 0)
-        &&  (strncmp (s2, s, 2) != 0)
-        ) {
-            // Mismatch
-            return false;
-        }
-
-        i += 2;
-        address++;
-    }
-
-    return true;
+    return match_bytes (read_kernel_bytes, read_kernel_byte, NULL, address, match);
 }
 
 
@@ -691,7 +631,7 @@ unsigned char
 IDAUtils::Byte (
     ea_t address
 ) {
-    return get_wide_byte(address);
+    return IDA_CALL (GET_BYTE, get_wide_byte (address));
 }
 
 bool
@@ -699,7 +639,7 @@ IDAUtils::MakeFunction (
     ea_t start,
     ea_t end
 ) {
-    return add_func (start, end);
+    return IDA_CALL (ADD_FUNC, add_func (start, end));
 }
 
 nodeidx_t
@@ -732,47 +672,13 @@ IDAUtils::GetArrayElementA (
     return n.altval(idx);
 }
 
-bool
-IDAUtils::AddAddr (
-    ea_t address
-) {
-    nodeidx_t id, idx;
-    ea_t val;
-
-    if ((id = IDAUtils::GetArrayId ("AddrList")) == -1) {
-        id  = IDAUtils::CreateArray ("AddrList");
-        IDAUtils::SetArrayLong (id, 0, address);
-        return true;
-    }
-
-    for (idx = IDAUtils::GetFirstIndex (AR_LONG, id); idx != -1; idx = IDAUtils::GetNextIndex (AR_LONG, id, idx))
-    {
-        val = IDAUtils::GetArrayElementA (id, idx);
-        if (val == address) {
-            return true;
-        }
-
-        if (val > address)    // InSort
-        {
-            for (; idx != -1; idx = IDAUtils::GetNextIndex (AR_LONG, id, idx)) {
-                val = IDAUtils::GetArrayElementA (id, idx);
-                IDAUtils::SetArrayLong (id, idx, address);
-                address = val;
-            }
-        }
-    }
-
-    IDAUtils::SetArrayLong (id, IDAUtils::GetLastIndex (AR_LONG, id) + 1, address);
-    return true;
-}
-
 char *
 IDAUtils::Name (
     ea_t address,
     char *buffer,
     size_t bufferSize
 ) {
-     qstring TempQ = get_name(address, BADADDR/*BADADDR, address, buffer, bufferSize*/);
+     qstring TempQ = IDA_CALL (GET_NAME, get_name (address, BADADDR/*BADADDR, address, buffer, bufferSize*/));
 	 char* result = const_cast<char*>(TempQ.c_str());
 	 if (!result) {
         buffer[0] = '\0';
@@ -784,14 +690,15 @@ ea_t
 IDAUtils::PrevFunction (
     ea_t address
 ) {
-    return get_prev_func (address)->start_ea;
+    func_t *f = get_prev_func (address);
+    return f != NULL ? f->start_ea : BADADDR;
 }
 
 ushort
 IDAUtils::GetFunctionFlags (
     ea_t address
 ) {
-    func_t *f = get_func (address);
+    func_t *f = IDA_CALL (GET_FUNC, get_func (address));
     if (!f) {
         return 0;
     }
@@ -803,7 +710,7 @@ flags_t
 IDAUtils::GetFlags (
     ea_t address
 ) {
-    return get_full_flags(address);
+    return IDA_CALL (GET_FLAGS, get_full_flags (address));
 }
 
 bool
@@ -835,7 +742,7 @@ IDAUtils::Demangle (
     char *buffer,
     size_t bufferSize
 ) {
-    demangle_name (/*buffer, bufferSize,*/mangledName, disable_mask);
+    IDA_CALL (DEMANGLE, demangle_name (/*buffer, bufferSize,*/mangledName, disable_mask));
     return buffer;
 }
 
@@ -940,7 +847,7 @@ IDAUtils::MakeName (
     ea_t address,
     char *name
 ) {
-    return force_name(address, name, 0);
+    return IDA_CALL (FORCE_NAME, force_name (address, name, 0));
 }
 
 bool
@@ -1027,31 +934,5 @@ IDAUtils::MangleNumber (
     // X = X-1 (1<=X<=10)
     // -X = ?(X-1)
     // 0x0..0xF = 'A'..'P'
-
-    buffer[0] = '\0';
-    int sign = 0;
-
-    if (number < 0) {
-        sign = 1;
-        number = -number;
-    }
-
-    if (number == 0) {
-        return strdup ("A@");
-    }
-
-    else if (number <= 10) {
-        sprintf_s (buffer, bufferSize, "%s%d", sign ? "?" : "", number - 1);
-        return buffer;
-    }
-
-    else {
-        while (number > 0)
-        {
-            sprintf_s (buffer, bufferSize, "%c%s", 'A' + (number % 16), buffer);
-            number = number / 16;
-        }
-        sprintf_s (buffer, bufferSize, "%s%s@", sign ? "?" : "", buffer);
-        return buffer;
-    }
+    return mangle_number (number, buffer, bufferSize);
 }
\ No newline at end of file
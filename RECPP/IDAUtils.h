@@ -13,6 +13,7 @@
 #include "RECPP.h"
 #include <iostream>
 #include <cstdarg>
+#include <vector>
 
 // ---------- Defines -------------
 #ifndef INF_STRTYPE
@@ -25,6 +26,9 @@
 #define AR_STR  'S'     // array of strings
 #endif
 
+// Sorted set of addresses, scratch space that never touches the database
+typedef std::vector<ea_t> addr_list_t;
+
 #define SN_constructor 1
 #define SN_destructor  2
 #define SN_vdestructor 3
@@ -335,7 +339,8 @@ class IDAUtils {
     );
 
     /*
-    * @brief : 
+    * @brief : Get the start of the function before an address
+    * @return The function start, or BADADDR if there is none
     */
     static ea_t
     IDAUtils::PrevFunction (
@@ -407,14 +412,6 @@ class IDAUtils {
         nodeidx_t idx
     );
 
-    /*
-    * @brief : 
-    */
-    static bool
-    IDAUtils::AddAddr (
-        ea_t address
-    );
-    
     /*
     * @brief : 
     */
@@ -573,17 +570,6 @@ class IDAUtils {
         char *name
     );
 
-    /*
-    * @brief :
-    */
-    static bool
-    IDAUtils::ForceMethodMember (
-        tid_t id, 
-        int offset, 
-        char *name,
-        size_t nameSize
-    );
-
     /*
     * @brief :
     */
@@ -621,11 +607,14 @@ class IDAUtils {
     );
     
     /*
-    * @brief :
+    * @brief : Name the constructor of a class among the functions writing its
+    *          vftable, when they are exactly a constructor and a named destructor
+    * @param list : The writing functions
     */
     static void
     IDAUtils::doAddrList (
-        char *name
+        char *name,
+        const addr_list_t &list
     );
 };
 
@@ -0,0 +1,143 @@
+﻿/*
+    ██████╗ ███████╗ ██████╗██████╗ ██████╗ 
+    ██╔══██╗██╔════╝██╔════╝██╔══██╗██╔══██╗
+    ██████╔╝█████╗  ██║     ██████╔╝██████╔╝
+    ██╔══██╗██╔══╝  ██║     ██╔═══╝ ██╔═══╝ 
+    ██║  ██║███████╗╚██████╗██║     ██║     
+    ╚═╝  ╚═╝╚══════╝ ╚═════╝╚═╝     ╚═╝     
+* @license : <license placeholder>
+*/
+
+#include "MemStats.h"
+
+MemStats::counter_t MemStats::counters[MEM_COUNT];
+
+
+static void
+update_peaks (
+    MemStats::counter_t *c
+) {
+    if (c->bytes > c->peak_bytes) {
+        c->peak_bytes = c->bytes;
+    }
+    if (c->objects > c->peak_objects) {
+        c->peak_objects = c->objects;
+    }
+}
+
+void
+MemStats::on_alloc (
+    mem_subsystem_t sys,
+    size_t bytes
+) {
+    counter_t *c = &counters[sys];
+
+    c->bytes += bytes;
+    c->objects++;
+    c->allocs++;
+    update_peaks (c);
+}
+
+void
+MemStats::on_free (
+    mem_subsystem_t sys,
+    size_t bytes
+) {
+    counter_t *c = &counters[sys];
+
+    c->bytes -= bytes < c->bytes ? bytes : c->bytes;
+    c->objects -= c->objects != 0 ? 1 : 0;
+    c->frees++;
+}
+
+void
+MemStats::account (
+    mem_subsystem_t sys,
+    held_t *held,
+    size_t bytes,
+    size_t objects
+) {
+    counter_t *c = &counters[sys];
+
+    if (bytes > held->bytes) {
+        c->allocs++;
+    }
+    else if (bytes < held->bytes) {
+        c->frees++;
+    }
+
+    c->bytes = c->bytes - held->bytes + bytes;
+    c->objects = c->objects - held->objects + objects;
+    update_peaks (c);
+
+    held->bytes = bytes;
+    held->objects = objects;
+}
+
+const char *
+MemStats::name (
+    mem_subsystem_t sys
+) {
+    static const char *const names[MEM_COUNT] = {
+        "scanner", "class registry", "call graphs", "decompilation cache", "names"
+    };
+
+    return sys < MEM_COUNT ? names[sys] : "?";
+}
+
+MemStats::counter_t
+MemStats::total (
+    void
+) {
+    counter_t t;
+    memset (&t, 0, sizeof (t));
+
+    // Subsystems don't peak together, the sum of the peaks is an upper bound
+    for (int i = 0; i < MEM_COUNT; i++) {
+        t.bytes        += counters[i].bytes;
+        t.peak_bytes   += counters[i].peak_bytes;
+        t.objects      += counters[i].objects;
+        t.peak_objects += counters[i].peak_objects;
+        t.allocs       += counters[i].allocs;
+        t.frees        += counters[i].frees;
+    }
+
+    return t;
+}
+
+void
+MemStats::reset_peaks (
+    void
+) {
+    for (int i = 0; i < MEM_COUNT; i++) {
+        counters[i].peak_bytes = counters[i].bytes;
+        counters[i].peak_objects = counters[i].objects;
+    }
+}
+
+static void
+report_line (
+    const char *name,
+    const MemStats::counter_t &c
+) {
+    msg ("%-20s %10.1f KB %10.1f KB %10d %10d %10d %10d\n",
+         name,
+         c.bytes / 1024.0, c.peak_bytes / 1024.0,
+         (int) c.objects, (int) c.peak_objects,
+         (int) c.allocs, (int) c.frees);
+}
+
+void
+MemStats::report (
+    void
+) {
+    msg ("----- RECPP memory -----\n");
+    msg ("%-20s %13s %13s %10s %10s %10s %10s\n",
+         "subsystem", "current", "peak", "objects", "peak", "allocs", "frees");
+
+    for (int i = 0; i < MEM_COUNT; i++) {
+        report_line (name ((mem_subsystem_t) i), counters[i]);
+    }
+
+    report_line ("total", total ());
+}
@@ -0,0 +1,144 @@
+﻿/*
+    ██████╗ ███████╗ ██████╗██████╗ ██████╗ 
+    ██╔══██╗██╔════╝██╔════╝██╔══██╗██╔══██╗
+    ██████╔╝█████╗  ██║     ██████╔╝██████╔╝
+    ██╔══██╗██╔══╝  ██║     ██╔═══╝ ██╔═══╝ 
+    ██║  ██║███████╗╚██████╗██║     ██║     
+    ╚═╝  ╚═╝╚══════╝ ╚═════╝╚═╝     ╚═╝     
+* @license : <license placeholder>
+*/
+
+#pragma once
+
+
+// ---------- Includes ------------
+#include "RECPP.h"
+#include <new>
+
+// ---------- Defines -------------
+// Estimated bookkeeping cost of one node of a std::map / std::set
+#define MEM_NODE_OVERHEAD 32
+
+enum mem_subsystem_t
+{
+    MEM_SCANNER,    // scanner, vftables, methods and the stored scan
+    MEM_REGISTRY,   // class registry
+    MEM_CALLGRAPH,  // call graph store and per-function graphs
+    MEM_DECOMPILER, // decompilation cache
+    MEM_NAMES,      // class names and name indexes
+    MEM_COUNT
+};
+
+
+// ------ Class definition --------
+// Current and peak memory of every subsystem.
+//
+// Objects deriving from MemTracked are counted when they are allocated and
+// released. Containers can't be hooked that way : their owner reports what
+// it holds with account () after every change, and only the difference with
+// the previous report is applied.
+// Only meant for the UI thread, like the rest of the kernel calls.
+class MemStats
+{
+public:
+    struct counter_t
+    {
+        size_t bytes;
+        size_t peak_bytes;
+        size_t objects;
+        size_t peak_objects;
+        uint64 allocs;
+        uint64 frees;
+    };
+
+    // What an owner reported last time
+    struct held_t
+    {
+        size_t bytes;
+        size_t objects;
+
+        held_t () : bytes (0), objects (0) { }
+
+        // A copy of the owner has reported nothing yet
+        held_t (const held_t &) : bytes (0), objects (0) { }
+        held_t &operator= (const held_t &) { return *this; }
+    };
+
+    static void
+    on_alloc (
+        mem_subsystem_t sys,
+        size_t bytes
+    );
+
+    static void
+    on_free (
+        mem_subsystem_t sys,
+        size_t bytes
+    );
+
+    /*
+     * @brief : Replace what an owner holds by its current size
+     * @param held : The previous report of the owner, updated
+     */
+    static void
+    account (
+        mem_subsystem_t sys,
+        held_t *held,
+        size_t bytes,
+        size_t objects
+    );
+
+    static const counter_t &get (mem_subsystem_t sys) { return counters[sys]; }
+
+    static const char *
+    name (
+        mem_subsystem_t sys
+    );
+
+    /*
+     * @brief : Total of every subsystem
+     */
+    static counter_t
+    total (
+        void
+    );
+
+    /*
+     * @brief : Restart the peaks from the current usage
+     */
+    static void
+    reset_peaks (
+        void
+    );
+
+    /*
+     * @brief : Print every subsystem to the output window
+     */
+    static void
+    report (
+        void
+    );
+
+private:
+    static counter_t counters[MEM_COUNT];
+};
+
+// Count the instances of a class in a subsystem. The sized delete gets the
+// size of the dynamic type as long as the destructor is virtual.
+template <mem_subsystem_t Sys>
+class MemTracked
+{
+public:
+    static void *operator new (size_t size) {
+        void *p = ::operator new (size);
+        MemStats::on_alloc (Sys, size);
+        return p;
+    }
+
+    static void operator delete (void *p, size_t size) {
+        if (p != NULL) {
+            MemStats::on_free (Sys, size);
+        }
+        ::operator delete (p);
+    }
+};
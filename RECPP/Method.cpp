@@ -10,6 +10,7 @@
 
 #include "Method.h"
 #include "IDAUtils.h"
+#include "Profiler.h"
 #include <iostream>
 #include <cstdarg>
 
@@ -36,6 +37,8 @@ void
 Method::explore (
     void
 ) {
+    PROFILE_SCOPE ("CallGraph::walk_func");
+
     if (!this->function) {
         return;
     }
@@ -13,12 +13,13 @@
 // ---------- Includes ------------
 #include "RECPP.h"
 #include "GraphInfo.h"
+#include "MemStats.h"
 
 // ---------- Defines -------------
 
 
 // ------ Class definition --------
-class Method 
+class Method : public MemTracked<MEM_SCANNER>
 {
     public:
         Method (char *className, ea_t functionAddress, bool makeName);
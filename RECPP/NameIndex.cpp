@@ -0,0 +1,291 @@
+﻿/*
+    ██████╗ ███████╗ ██████╗██████╗ ██████╗ 
+    ██╔══██╗██╔════╝██╔════╝██╔══██╗██╔══██╗
+    ██████╔╝█████╗  ██║     ██████╔╝██████╔╝
+    ██╔══██╗██╔══╝  ██║     ██╔═══╝ ██╔═══╝ 
+    ██║  ██║███████╗╚██████╗██║     ██║     
+    ╚═╝  ╚═╝╚══════╝ ╚═════╝╚═╝     ╚═╝     
+* @license : <license placeholder>
+*/
+
+#include "NameIndex.h"
+#include <algorithm>
+
+
+NameIndex::NameIndex () {
+    this->ready = false;
+}
+
+NameIndex::~NameIndex () {
+    MemStats::account (MEM_NAMES, &this->memory, 0, 0);
+}
+
+void
+NameIndex::update_memory (
+    void
+) {
+    size_t bytes = this->names.capacity ()
+                 + this->offsets.capacity () * sizeof (uint32)
+                 + this->trigrams.capacity () * sizeof (uint32)
+                 + this->post_start.capacity () * sizeof (uint32)
+                 + this->postings.capacity () * sizeof (int);
+
+    MemStats::account (MEM_NAMES, &this->memory, bytes, this->offsets.size ());
+}
+
+void
+NameIndex::clear (
+    void
+) {
+    this->names.clear ();
+    this->offsets.clear ();
+    this->trigrams.clear ();
+    this->post_start.clear ();
+    this->postings.clear ();
+    this->ready = false;
+    update_memory ();
+}
+
+int
+NameIndex::add (
+    const char *name
+) {
+    int id = (int) this->offsets.size ();
+    this->offsets.push_back ((uint32) this->names.size ());
+
+    if (name != NULL) {
+        for (; *name != '\0'; name++) {
+            this->names.push_back ((char) qtolower (*name));
+        }
+    }
+
+    this->names.push_back ('\0');
+    this->ready = false;
+
+    return id;
+}
+
+uint32
+NameIndex::trigram (
+    const char *s
+) {
+    return ((uint32) (uchar) s[0] << 16)
+         | ((uint32) (uchar) s[1] << 8)
+         |  (uint32) (uchar) s[2];
+}
+
+void
+NameIndex::finalize (
+    void
+) {
+    // (trigram, id) pairs, sorted once so that every posting list ends up
+    // contiguous and ordered by id
+    std::vector<uint64> pairs;
+    std::vector<uint32> local;
+
+    for (size_t id = 0; id < this->offsets.size (); id++)
+    {
+        const char *s = &this->names[this->offsets[id]];
+        size_t len = strlen (s);
+
+        local.clear ();
+        for (size_t i = 0; i + 3 <= len; i++) {
+            local.push_back (trigram (&s[i]));
+        }
+
+        std::sort (local.begin (), local.end ());
+        local.erase (std::unique (local.begin (), local.end ()), local.end ());
+
+        for (size_t i = 0; i < local.size (); i++) {
+            pairs.push_back (((uint64) local[i] << 32) | (uint32) id);
+        }
+    }
+
+    std::sort (pairs.begin (), pairs.end ());
+
+    this->trigrams.clear ();
+    this->post_start.clear ();
+    this->postings.clear ();
+    this->postings.reserve (pairs.size ());
+
+    for (size_t i = 0; i < pairs.size (); i++)
+    {
+        uint32 tri = (uint32) (pairs[i] >> 32);
+
+        if (this->trigrams.empty () || this->trigrams.back () != tri) {
+            this->trigrams.push_back (tri);
+            this->post_start.push_back ((uint32) this->postings.size ());
+        }
+
+        this->postings.push_back ((int) (uint32) pairs[i]);
+    }
+
+    this->post_start.push_back ((uint32) this->postings.size ());
+    this->ready = true;
+    update_memory ();
+}
+
+bool
+NameIndex::get_postings (
+    uint32 tri,
+    const int **begin,
+    const int **end
+) const {
+    std::vector<uint32>::const_iterator it = std::lower_bound (this->trigrams.begin (), this->trigrams.end (), tri);
+    if (it == this->trigrams.end () || *it != tri) {
+        return false;
+    }
+
+    size_t k = it - this->trigrams.begin ();
+    *begin = &this->postings[0] + this->post_start[k];
+    *end   = &this->postings[0] + this->post_start[k + 1];
+
+    return true;
+}
+
+const char *
+NameIndex::get_name (
+    int id
+) const {
+    if (id < 0 || (size_t) id >= this->offsets.size ()) {
+        return NULL;
+    }
+
+    return &this->names[this->offsets[id]];
+}
+
+// Lower is better : exact match, prefix, start of a word, anywhere else
+int
+NameIndex::rank (
+    int id,
+    const char *text,
+    size_t textLen
+) const {
+    const char *name = get_name (id);
+    const char *pos = strstr (name, text);
+
+    if (pos == NULL) {
+        return -1;
+    }
+
+    if (pos == name) {
+        return name[textLen] == '\0' ? 0 : 1;
+    }
+
+    for (; pos != NULL; pos = strstr (pos + 1, text)) {
+        if (!qisalnum (pos[-1])) {
+            return 2;
+        }
+    }
+
+    return 3;
+}
+
+size_t
+NameIndex::search (
+    const char *text,
+    size_t offset,
+    size_t limit,
+    std::vector<int> *out
+) const {
+    out->clear ();
+
+    if (text == NULL || text[0] == '\0') {
+        return 0;
+    }
+
+    std::string query;
+    for (; *text != '\0'; text++) {
+        query += (char) qtolower (*text);
+    }
+
+    std::vector<int> candidates;
+
+    if (query.size () < 3 || !this->ready) {
+        // Too short for a trigram, every entry is a candidate
+        candidates.resize (this->offsets.size ());
+        for (size_t id = 0; id < candidates.size (); id++) {
+            candidates[id] = (int) id;
+        }
+    }
+    else {
+        typedef std::pair<const int *, const int *> range_t;
+        std::vector<range_t> lists;
+
+        for (size_t i = 0; i + 3 <= query.size (); i++)
+        {
+            range_t r;
+            if (!get_postings (trigram (&query[i]), &r.first, &r.second)) {
+                // One trigram is in no name at all
+                return 0;
+            }
+
+            lists.push_back (r);
+        }
+
+        // Intersect the shortest lists first
+        std::sort (lists.begin (), lists.end (), [] (const range_t &a, const range_t &b) {
+            return (a.second - a.first) < (b.second - b.first);
+        });
+
+        candidates.assign (lists[0].first, lists[0].second);
+
+        std::vector<int> tmp;
+        for (size_t i = 1; i < lists.size () && !candidates.empty (); i++)
+        {
+            if (lists[i].first == lists[i - 1].first) {
+                // Same trigram twice in the query
+                continue;
+            }
+
+            tmp.clear ();
+            std::set_intersection (candidates.begin (), candidates.end (),
+                                   lists[i].first, lists[i].second,
+                                   std::back_inserter (tmp));
+            candidates.swap (tmp);
+        }
+    }
+
+    // Trigrams only tell us a name may match, verify and rank the survivors
+    struct hit_t {
+        int rank;
+        size_t len;
+        int id;
+
+        bool operator< (const hit_t &o) const {
+            if (rank != o.rank) return rank < o.rank;
+            if (len != o.len) return len < o.len;
+            return id < o.id;
+        }
+    };
+
+    std::vector<hit_t> hits;
+    for (size_t i = 0; i < candidates.size (); i++)
+    {
+        int id = candidates[i];
+        int r = rank (id, query.c_str (), query.size ());
+
+        if (r >= 0) {
+            hit_t h = { r, strlen (get_name (id)), id };
+            hits.push_back (h);
+        }
+    }
+
+    if (offset >= hits.size ()) {
+        return hits.size ();
+    }
+
+    size_t count = hits.size () - offset;
+    if (limit != 0 && limit < count) {
+        count = limit;
+    }
+
+    // Only the requested page has to be ordered
+    std::partial_sort (hits.begin (), hits.begin () + offset + count, hits.end ());
+
+    for (size_t i = offset; i < offset + count; i++) {
+        out->push_back (hits[i].id);
+    }
+
+    return hits.size ();
+}
@@ -0,0 +1,125 @@
+﻿/*
+    ██████╗ ███████╗ ██████╗██████╗ ██████╗ 
+    ██╔══██╗██╔════╝██╔════╝██╔══██╗██╔══██╗
+    ██████╔╝█████╗  ██║     ██████╔╝██████╔╝
+    ██╔══██╗██╔══╝  ██║     ██╔═══╝ ██╔═══╝ 
+    ██║  ██║███████╗╚██████╗██║     ██║     
+    ╚═╝  ╚═╝╚══════╝ ╚═════╝╚═╝     ╚═╝     
+* @license : <license placeholder>
+*/
+
+#pragma once
+
+
+// ---------- Includes ------------
+#include "RECPP.h"
+#include "MemStats.h"
+#include <vector>
+
+// ---------- Defines -------------
+
+
+// ------ Class definition --------
+// Case-insensitive substring index over a set of names.
+// Names are stored lowercased in one contiguous buffer, and every distinct
+// trigram of a name points back to it through a sorted posting list.
+class NameIndex
+{
+public:
+    NameIndex ();
+    ~NameIndex ();
+
+    /*
+     * @brief : Drop every name and posting list
+     */
+    void
+    clear (
+        void
+    );
+
+    /*
+     * @brief : Append a name, the id of the entry is its insertion order
+     * @param name : The name to index, can be NULL
+     * @return The id of the new entry
+     */
+    int
+    add (
+        const char *name
+    );
+
+    /*
+     * @brief : Build the trigram posting lists, must be called after the last add
+     */
+    void
+    finalize (
+        void
+    );
+
+    /*
+     * @brief : Search all the names containing \text, best matches first
+     * @param text : The substring to look for (case insensitive)
+     * @param offset : Number of ranked results to skip
+     * @param limit : Maximum number of results to return (0 = unlimited)
+     * @param out : Receives the ids of the matching entries
+     * @return The total number of matches, regardless of \offset and \limit
+     */
+    size_t
+    search (
+        const char *text,
+        size_t offset,
+        size_t limit,
+        std::vector<int> *out
+    ) const;
+
+    /*
+     * @brief : Get the lowercased name of an entry
+     */
+    const char *
+    get_name (
+        int id
+    ) const;
+
+    size_t size () const { return this->offsets.size (); }
+    bool is_ready () const { return this->ready; }
+
+private:
+    // Lowercased, NUL separated names, and start offset of each name
+    std::vector<char>   names;
+    std::vector<uint32> offsets;
+
+    // Sorted distinct trigrams, and for each of them a range of postings
+    std::vector<uint32> trigrams;
+    std::vector<uint32> post_start;
+    std::vector<int>    postings;
+
+    bool ready;
+
+    MemStats::held_t memory;
+
+    /*
+     * @brief : Report the current size of the containers to MemStats
+     */
+    void
+    update_memory (
+        void
+    );
+
+    static uint32
+    trigram (
+        const char *s
+    );
+
+    int
+    rank (
+        int id,
+        const char *text,
+        size_t textLen
+    ) const;
+
+    bool
+    get_postings (
+        uint32 tri,
+        const int **begin,
+        const int **end
+    ) const;
+};
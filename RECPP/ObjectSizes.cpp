@@ -0,0 +1,289 @@
+﻿/*
+    ██████╗ ███████╗ ██████╗██████╗ ██████╗ 
+    ██╔══██╗██╔════╝██╔════╝██╔══██╗██╔══██╗
+    ██████╔╝█████╗  ██║     ██████╔╝██████╔╝
+    ██╔══██╗██╔══╝  ██║     ██╔═══╝ ██╔═══╝ 
+    ██║  ██║███████╗╚██████╗██║     ██║     
+    ╚═╝  ╚═╝╚══════╝ ╚═════╝╚═╝     ╚═╝     
+* @license : <license placeholder>
+*/
+
+#include "ObjectSizes.h"
+#include "CallGraphStore.h"
+#include "ParallelFor.h"
+#include "Profiler.h"
+#include "IDACalls.h"
+#include <algorithm>
+
+// operator new and operator new[], and the import slots they are called through
+static const char *const NEW_NAMES[] = {
+    "??2@YAPAXI@Z",
+    "??_U@YAPAXI@Z",
+};
+
+
+ObjectSizes::ObjectSizes () {
+}
+
+ObjectSizes::~ObjectSizes () {
+    MemStats::account (MEM_SCANNER, &this->memory, 0, 0);
+}
+
+void
+ObjectSizes::clear (
+    void
+) {
+    this->sizes.clear ();
+    MemStats::account (MEM_SCANNER, &this->memory, 0, 0);
+}
+
+static uint32
+read32 (
+    const uchar *p
+) {
+    return (uint32) p[0] | ((uint32) p[1] << 8) | ((uint32) p[2] << 16) | ((uint32) p[3] << 24);
+}
+
+struct body_t
+{
+    ea_t base;
+    std::vector<uchar> bytes;
+};
+
+struct site_t
+{
+    ea_t ctor;
+    uint32 size;
+};
+
+// Runs on the workers of parallel_for : memory only, no kernel call
+static void
+search_body (
+    const body_t &body,
+    const std::vector<ea_t> &ctors,
+    const std::vector<ea_t> &news,
+    const std::vector<ea_t> &newSlots,
+    std::vector<site_t> *out
+) {
+    const uchar *b = body.bytes.data ();
+    size_t len = body.bytes.size ();
+
+    for (size_t i = 0; i + 5 <= len; i++)
+    {
+        // call rel32 to a constructor
+        if (b[i] != 0xE8) {
+            continue;
+        }
+
+        ea_t target = body.base + (ea_t) i + 5 + (ea_t) read32 (&b[i + 1]);
+        if (!std::binary_search (ctors.begin (), ctors.end (), target)) {
+            continue;
+        }
+
+        // The closest allocation before it
+        size_t from = i > OBJSIZE_WINDOW ? i - OBJSIZE_WINDOW : 0;
+        for (size_t k = i; k-- > from; )
+        {
+            bool isNew = false;
+
+            if (b[k] == 0xE8 && k + 5 <= i) {
+                isNew = std::binary_search (news.begin (), news.end (), body.base + (ea_t) k + 5 + (ea_t) read32 (&b[k + 1]));
+            }
+            else if (b[k] == 0xFF && b[k + 1] == 0x15 && k + 6 <= i) {
+                // call ds:__imp_??2@YAPAXI@Z, the import slot may also carry the plain name
+                ea_t slot = (ea_t) read32 (&b[k + 2]);
+                isNew = std::binary_search (newSlots.begin (), newSlots.end (), slot)
+                     || std::binary_search (news.begin (), news.end (), slot);
+            }
+
+            if (!isNew) {
+                continue;
+            }
+
+            uint32 size = 0;
+            if (k >= 2 && b[k - 2] == 0x6A && (int8) b[k - 1] > 0) {
+                // push imm8
+                size = b[k - 1];
+            }
+            else if (k >= 5 && (b[k - 5] == 0x68 || b[k - 5] == 0xB9)) {
+                // push imm32 / mov ecx, imm32
+                size = read32 (&b[k - 4]);
+            }
+
+            if (size != 0) {
+                site_t site = { target, size };
+                out->push_back (site);
+            }
+            break;
+        }
+    }
+}
+
+void
+ObjectSizes::analyze (
+    const VtableWriters &writers
+) {
+    clear ();
+
+    // Constructors : the functions installing a vftable at offset 0. The base
+    // constructors inlined before it store their own vftables first, the
+    // last store is the class being built
+    std::vector<const VtableWriters::writer_t *> stores;
+    const std::vector<VtableWriters::writer_t> &all = writers.get_writers ();
+
+    for (size_t i = 0; i < all.size (); i++) {
+        if (all[i].offset == 0) {
+            stores.push_back (&all[i]);
+        }
+    }
+
+    std::sort (stores.begin (), stores.end (), [] (const VtableWriters::writer_t *a, const VtableWriters::writer_t *b) {
+        if (a->func != b->func) return a->func < b->func;
+        return a->insn < b->insn;
+    });
+
+    std::vector<std::pair<ea_t, ea_t> > installs;
+    std::vector<ea_t> ctors;
+
+    for (size_t i = 0; i < stores.size (); i++) {
+        if (i + 1 == stores.size () || stores[i + 1]->func != stores[i]->func) {
+            installs.push_back (std::make_pair (stores[i]->func, stores[i]->vtable));
+            ctors.push_back (stores[i]->func);
+        }
+    }
+
+    std::vector<ea_t> news, newSlots;
+    for (size_t i = 0; i < qnumber (NEW_NAMES); i++)
+    {
+        qstring name (NEW_NAMES[i]);
+        ea_t ea = get_name_ea (BADADDR, name.c_str ());
+        if (ea != BADADDR) {
+            news.push_back (ea);
+        }
+
+        ea = get_name_ea (BADADDR, ("j_" + name).c_str ());
+        if (ea != BADADDR) {
+            news.push_back (ea);
+        }
+
+        ea = get_name_ea (BADADDR, ("__imp_" + name).c_str ());
+        if (ea != BADADDR) {
+            newSlots.push_back (ea);
+        }
+    }
+
+    if (ctors.empty () || (news.empty () && newSlots.empty ())) {
+        return;
+    }
+
+    std::sort (news.begin (), news.end ());
+    std::sort (newSlots.begin (), newSlots.end ());
+
+    // Callers of any constructor, in one walk of the stored call graph
+    CallGraphStore *store = CallGraphStore::get ();
+    store->ensure ();
+    store->compact ();
+
+    std::vector<ea_t> callers;
+    for (uint32 n = 0; n < store->node_count (); n++) {
+        for (const uint32 *s = store->succ_begin (n); s != store->succ_end (n); s++) {
+            if (std::binary_search (ctors.begin (), ctors.end (), store->node_ea (*s))) {
+                callers.push_back (store->node_ea (n));
+                break;
+            }
+        }
+    }
+
+    // Read the callers here, the kernel can't be used from the workers
+    std::vector<body_t> bodies;
+    {
+        PROFILE_SCOPE ("read");
+        for (size_t i = 0; i < callers.size (); i++)
+        {
+            func_t *pfn = get_func (callers[i]);
+            if (pfn == NULL) {
+                continue;
+            }
+
+            func_tail_iterator_t fti (pfn);
+            for (bool ok = fti.main (); ok; ok = fti.next ())
+            {
+                body_t body;
+                body.base = fti.chunk ().start_ea;
+                body.bytes.resize (fti.chunk ().size ());
+
+                ssize_t got = IDA_CALL (GET_BYTES, get_bytes (body.bytes.data (), body.bytes.size (), body.base));
+                body.bytes.resize (got > 0 ? (size_t) got : 0);
+                bodies.push_back (body);
+            }
+        }
+    }
+
+    std::vector<std::vector<site_t> > found (bodies.size ());
+    {
+        ScopedPhase phase ("search");
+        phase.add_items (bodies.size ());
+
+        parallel_for (bodies.size (), [&] (size_t i) {
+            search_body (bodies[i], ctors, news, newSlots, &found[i]);
+        });
+    }
+
+    // Every site counts for the vftable its constructor installs
+    std::vector<std::pair<ea_t, uint32> > byVtable;
+    for (size_t i = 0; i < found.size (); i++)
+    {
+        for (size_t j = 0; j < found[i].size (); j++)
+        {
+            std::vector<std::pair<ea_t, ea_t> >::const_iterator it = std::lower_bound (
+                installs.begin (), installs.end (), std::make_pair (found[i][j].ctor, (ea_t) 0));
+
+            for (; it != installs.end () && it->first == found[i][j].ctor; ++it) {
+                byVtable.push_back (std::make_pair (it->second, found[i][j].size));
+            }
+        }
+    }
+
+    std::sort (byVtable.begin (), byVtable.end ());
+
+    for (size_t i = 0; i < byVtable.size (); )
+    {
+        class_size_t cs = { byVtable[i].first, 0, byVtable[i].second, byVtable[i].second, 0 };
+        uint32 bestCount = 0;
+
+        // Sorted by size within a vftable, the runs give the most frequent one
+        while (i < byVtable.size () && byVtable[i].first == cs.vtable)
+        {
+            uint32 size = byVtable[i].second;
+            uint32 run = 0;
+
+            for (; i < byVtable.size () && byVtable[i].first == cs.vtable && byVtable[i].second == size; i++) {
+                run++;
+            }
+
+            if (run > bestCount) {
+                bestCount = run;
+                cs.size = size;
+            }
+
+            cs.max_size = size;
+            cs.sites += run;
+        }
+
+        this->sizes.push_back (cs);
+    }
+
+    MemStats::account (MEM_SCANNER, &this->memory,
+                       this->sizes.capacity () * sizeof (class_size_t), this->sizes.size ());
+}
+
+uint32
+ObjectSizes::get_size (
+    ea_t vtable
+) const {
+    std::vector<class_size_t>::const_iterator it = std::lower_bound (
+        this->sizes.begin (), this->sizes.end (), vtable,
+        [] (const class_size_t &cs, ea_t v) { return cs.vtable < v; });
+
+    return it != this->sizes.end () && it->vtable == vtable ? it->size : 0;
+}
@@ -0,0 +1,81 @@
+﻿/*
+    ██████╗ ███████╗ ██████╗██████╗ ██████╗ 
+    ██╔══██╗██╔════╝██╔════╝██╔══██╗██╔══██╗
+    ██████╔╝█████╗  ██║     ██████╔╝██████╔╝
+    ██╔══██╗██╔══╝  ██║     ██╔═══╝ ██╔═══╝ 
+    ██║  ██║███████╗╚██████╗██║     ██║     
+    ╚═╝  ╚═╝╚══════╝ ╚═════╝╚═╝     ╚═╝     
+* @license : <license placeholder>
+*/
+
+#pragma once
+
+
+// ---------- Includes ------------
+#include "RECPP.h"
+#include "VtableWriters.h"
+#include "MemStats.h"
+#include <vector>
+
+// ---------- Defines -------------
+#define OBJSIZE_WINDOW 64 // bytes searched before a constructor call for the allocation
+
+
+// ------ Class definition --------
+// Size of the classes, taken from the operator new calls whose result is
+// handed to their constructor :
+//
+//     push    20h                 ; or mov ecx, 20h
+//     call    operator new
+//     ...
+//     mov     ecx, eax
+//     call    A::A
+//
+// The constructors are the functions storing a vftable at offset 0, the
+// last such store telling their class. Their callers come from the call
+// graph store. Every caller is read once, then
+// all of them are searched in parallel for such sequences.
+class ObjectSizes
+{
+public:
+    struct class_size_t
+    {
+        ea_t vtable;
+        uint32 size;    // most frequent allocation size
+        uint32 min_size;
+        uint32 max_size;
+        uint32 sites;   // allocations seen
+    };
+
+    ObjectSizes ();
+    ~ObjectSizes ();
+
+    void
+    clear (
+        void
+    );
+
+    /*
+     * @brief : Find the allocation sizes of the classes whose vftables are in \writers
+     */
+    void
+    analyze (
+        const VtableWriters &writers
+    );
+
+    /*
+     * @brief : Get the object size of the class of a vftable
+     * @return The size, or 0 if no allocation was found
+     */
+    uint32
+    get_size (
+        ea_t vtable
+    ) const;
+
+    const std::vector<class_size_t> &get_sizes () const { return this->sizes; }
+
+private:
+    std::vector<class_size_t> sizes;   // sorted by vftable
+
+    MemStats::held_t memory;
+};
@@ -0,0 +1,74 @@
+﻿/*
+    ██████╗ ███████╗ ██████╗██████╗ ██████╗ 
+    ██╔══██╗██╔════╝██╔════╝██╔══██╗██╔══██╗
+    ██████╔╝█████╗  ██║     ██████╔╝██████╔╝
+    ██╔══██╗██╔══╝  ██║     ██╔═══╝ ██╔═══╝ 
+    ██║  ██║███████╗╚██████╗██║     ██║     
+    ╚═╝  ╚═╝╚══════╝ ╚═════╝╚═╝     ╚═╝     
+* @license : <license placeholder>
+*/
+
+#pragma once
+
+
+// ---------- Includes ------------
+#include <vector>
+#include <thread>
+#include <atomic>
+
+// ---------- Defines -------------
+// Below this many items a batch is run inline, threads would cost more than they save
+#define PARALLEL_FOR_MIN_ITEMS 64
+
+
+// ------ Function definition --------
+// Run fn(i) for every i in [0, count) on up to \threads workers.
+// The kernel database is not thread safe : fn must only touch memory that
+// was read beforehand, never call into the IDA SDK.
+template <typename Fn>
+void
+parallel_for (
+    size_t count,
+    Fn fn,
+    unsigned threads = 0
+) {
+    if (threads == 0) {
+        threads = std::thread::hardware_concurrency ();
+    }
+
+    if (threads <= 1 || count < PARALLEL_FOR_MIN_ITEMS) {
+        for (size_t i = 0; i < count; i++) {
+            fn (i);
+        }
+        return;
+    }
+
+    if (threads > count) {
+        threads = (unsigned) count;
+    }
+
+    // Workers pull small chunks so that an expensive item doesn't stall the rest
+    std::atomic<size_t> next (0);
+    const size_t chunk = count / (threads * 8) + 1;
+
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; t++) {
+        workers.push_back (std::thread ([&] () {
+            for (;;) {
+                size_t start = next.fetch_add (chunk);
+                if (start >= count) {
+                    break;
+                }
+
+                size_t end = start + chunk < count ? start + chunk : count;
+                for (size_t i = start; i < end; i++) {
+                    fn (i);
+                }
+            }
+        }));
+    }
+
+    for (size_t t = 0; t < workers.size (); t++) {
+        workers[t].join ();
+    }
+}
@@ -11,11 +11,170 @@
 #include "RECPP.h"
 #include "VtableScanner.h"
 #include "DecMap.h"
+#include "CallGraphStore.h"
+#include "Reachability.h"
+#include "PrefetchQueue.h"
+#include "ScanState.h"
+#include "ClassRegistry.h"
+#include "ClassBrowser.h"
+#include "ClassTree.h"
+#include "Profiler.h"
+#include "Bench.h"
+#include "FuncIndex.h"
+#include "FieldLayout.h"
+#include "MemStats.h"
 
 // Hex-Rays API pointer
 hexdsp_t *hexdsp = NULL;
 static bool inited = false;
 
+// Last scan results, the classes they describe kept up to date by the IDB
+// events, and reachability queries over them
+static VtableScanner *lastScanner = NULL;
+static ClassRegistry *classRegistry = NULL;
+static Reachability *reachability = NULL;
+
+// Background decompilation around what the analyst is looking at
+static PrefetchQueue *prefetchQueue = NULL;
+
+// Decompiled functions, handed to every hook as their user data
+static DecMap *decompilationCache = NULL;
+
+// Keeps the prefetch quiet while a wait box has the main thread
+struct prefetch_pause_t
+{
+    bool resume;
+
+    prefetch_pause_t () {
+        this->resume = prefetchQueue != NULL && !prefetchQueue->is_paused ();
+        if (this->resume) {
+            prefetchQueue->pause ();
+        }
+    }
+
+    ~prefetch_pause_t () {
+        if (this->resume && prefetchQueue != NULL) {
+            prefetchQueue->resume ();
+        }
+    }
+};
+
+
+// Scan results
+
+/*
+ * @brief : Make the decompilation cache keep the functions of the class slots
+ */
+static void
+watch_slots (
+    DecMap *decompilationMap,
+    const ClassRegistry *registry
+) {
+    for (size_t c = 0; c < registry->class_count (); c++)
+    {
+        const ClassRegistry::class_t &cls = registry->get_class ((int) c);
+
+        for (uint32 i = 0; i < cls.slot_count; i++)
+        {
+            ea_t func = registry->slot_func ((int) c, i);
+            if (func != BADADDR) {
+                decompilationMap->add_interesting (func);
+            }
+        }
+    }
+}
+
+/*
+ * @brief : Get the vftables of the database, reusing the stored scan while it is valid
+ * @param force : Scan again even if the stored result is valid
+ * @return The scanner holding the vftables, or NULL if the scan failed
+ */
+static VtableScanner *
+get_scan (
+    DecMap *decompilationMap,
+    bool force
+) {
+    ScanState *state = ScanState::get ();
+
+    if (!force && state->is_valid ()) {
+        if (lastScanner == NULL) {
+            lastScanner = new VtableScanner (decompilationMap);
+            lastScanner->restore (state);
+            classRegistry = new ClassRegistry ();
+            classRegistry->build (lastScanner->getVtables ());
+            watch_slots (decompilationMap, classRegistry);
+        }
+
+        return lastScanner;
+    }
+
+    VtableScanner *vScanner = new VtableScanner (decompilationMap);
+
+    // A cancelled scan goes on from where it stopped. A scan the user asked
+    // for does everything again, otherwise only what changed is walked
+    bool started;
+    if (state->is_partial ()) {
+        started = vScanner->resume (state);
+    }
+    else if (force) {
+        started = vScanner->begin ();
+    }
+    else {
+        started = vScanner->beginIncremental (state) || vScanner->begin ();
+    }
+    
+    if (!started) {
+        msg ("Cannot scan the virtual function tables.");
+        delete vScanner;
+        return NULL;
+    }
+
+    VtableScanner::scan_status_t status;
+    {
+        prefetch_pause_t quiet;
+        status = vScanner->run ();
+    }
+
+    if (status != VtableScanner::SCAN_DONE) {
+        // An incremental rescan is cheap enough to be redone from the start
+        if (!vScanner->isIncremental ()) {
+            state->record_partial (vScanner->getVtables (), vScanner->getCursor ());
+        }
+        msg ("RECPP: scan cancelled at %a (%d%%), scan again to resume.\n",
+             vScanner->getCursor (), vScanner->getProgress ());
+        delete vScanner;
+        return NULL;
+    }
+
+    state->record (vScanner->getVtables ());
+
+    delete lastScanner;
+    lastScanner = vScanner;
+
+    if (classRegistry == NULL) {
+        classRegistry = new ClassRegistry ();
+    }
+    classRegistry->build (lastScanner->getVtables ());
+    watch_slots (decompilationMap, classRegistry);
+
+    return lastScanner;
+}
+
+/*
+ * @brief : Get the classes of the database, without scanning
+ * @return The registry, or NULL if the database was never scanned
+ */
+static ClassRegistry *
+get_registry (
+    DecMap *decompilationMap
+) {
+    // Once built, the registry follows the changes by itself
+    if (classRegistry == NULL && ScanState::get ()->is_valid ()) {
+        get_scan (decompilationMap, false);
+    }
+
+    return classRegistry;
+}
 
 // UI callbacks
 
@@ -23,17 +182,193 @@ static bool idaapi
 user_menu_scan_vftable (
     void *ud
 ) {
-    DecMap *decompilationMap = (DecMap *) ud;
-    VtableScanner *vScanner = new VtableScanner (decompilationMap);
-    
-    if (!(vScanner->scan ())) {
-        msg ("Cannot scan the virtual function tables.");
+    return get_scan ((DecMap *) ud, true) != NULL;
+}
+
+static bool idaapi
+user_menu_find_reaching_slots (
+    void *ud
+) {
+    ClassRegistry *registry = get_registry ((DecMap *) ud);
+    if (registry == NULL) {
+        msg ("RECPP: scan the vftables first.\n");
+        return false;
+    }
+
+    qstring names ("memcpy");
+    if (!ask_str (&names, HIST_IDENT, "Sink functions (comma separated)")) {
         return false;
     }
 
+    std::vector<ea_t> sinks;
+    char *ctx = NULL;
+    for (char *tok = qstrtok (names.begin (), ", ", &ctx); tok != NULL; tok = qstrtok (NULL, ", ", &ctx))
+    {
+        if (Reachability::sink_by_name (tok, &sinks) == 0) {
+            msg ("RECPP: unknown function %s\n", tok);
+        }
+    }
+
+    if (reachability == NULL) {
+        reachability = new Reachability ();
+    }
+
+    std::vector<Reachability::slot_t> slots;
+    reachability->virtual_slots (sinks, registry, &slots);
+
+    qstring name;
+    for (size_t i = 0; i < slots.size (); i++) {
+        get_func_name (&name, slots[i].method);
+        msg ("%a: slot %d -> %a %s (%d call(s) to a sink)\n",
+             slots[i].vtable, (int) slots[i].index, slots[i].method, name.c_str (), (int) slots[i].depth);
+    }
+
+    msg ("RECPP: %d virtual method(s) reach the sinks.\n", (int) slots.size ());
+
     return true;
-}
+}
+
+struct scan_action_t : public action_handler_t
+{
+    DecMap *decMap;
+
+    virtual int idaapi activate (action_activation_ctx_t *) {
+        user_menu_scan_vftable (decMap);
+        return 1;
+    }
+
+    virtual action_state_t idaapi update (action_update_ctx_t *) {
+        return AST_ENABLE_ALWAYS;
+    }
+};
+static scan_action_t scan_action;
+
+struct reaching_slots_action_t : public action_handler_t
+{
+    DecMap *decMap;
+
+    virtual int idaapi activate (action_activation_ctx_t *) {
+        user_menu_find_reaching_slots (decMap);
+        return 1;
+    }
+
+    virtual action_state_t idaapi update (action_update_ctx_t *) {
+        return AST_ENABLE_ALWAYS;
+    }
+};
+static reaching_slots_action_t reaching_slots_action;
+
+struct class_browser_action_t : public action_handler_t
+{
+    DecMap *decMap;
+
+    virtual int idaapi activate (action_activation_ctx_t *) {
+        ClassRegistry *registry = get_registry (decMap);
+        if (registry == NULL) {
+            msg ("RECPP: scan the vftables first.\n");
+            return 0;
+        }
+
+        ClassBrowser::show (registry);
+        return 1;
+    }
+
+    virtual action_state_t idaapi update (action_update_ctx_t *) {
+        return AST_ENABLE_ALWAYS;
+    }
+};
+static class_browser_action_t class_browser_action;
+
+struct class_tree_action_t : public action_handler_t
+{
+    DecMap *decMap;
+
+    virtual int idaapi activate (action_activation_ctx_t *) {
+        ClassRegistry *registry = get_registry (decMap);
+        if (registry == NULL) {
+            msg ("RECPP: scan the vftables first.\n");
+            return 0;
+        }
+
+        ClassTree::show (registry);
+        return 1;
+    }
+
+    virtual action_state_t idaapi update (action_update_ctx_t *) {
+        return AST_ENABLE_ALWAYS;
+    }
+};
+static class_tree_action_t class_tree_action;
+
+struct memory_stats_action_t : public action_handler_t
+{
+    virtual int idaapi activate (action_activation_ctx_t *) {
+        MemStats::report ();
+        return 1;
+    }
+
+    virtual action_state_t idaapi update (action_update_ctx_t *) {
+        return AST_ENABLE_ALWAYS;
+    }
+};
+static memory_stats_action_t memory_stats_action;
 
+struct prefetch_pause_action_t : public action_handler_t
+{
+    virtual int idaapi activate (action_activation_ctx_t *) {
+        if (prefetchQueue->is_paused ()) {
+            prefetchQueue->resume ();
+            msg ("RECPP: prefetch resumed, %d function(s) queued.\n", (int) prefetchQueue->pending ());
+        }
+        else {
+            prefetchQueue->pause ();
+            msg ("RECPP: prefetch paused, %d function(s) queued.\n", (int) prefetchQueue->pending ());
+        }
+        return 1;
+    }
+
+    virtual action_state_t idaapi update (action_update_ctx_t *) {
+        return AST_ENABLE_ALWAYS;
+    }
+};
+static prefetch_pause_action_t prefetch_pause_action;
+
+struct prefetch_cancel_action_t : public action_handler_t
+{
+    virtual int idaapi activate (action_activation_ctx_t *) {
+        prefetchQueue->cancel ();
+        msg ("RECPP: prefetch cancelled.\n");
+        return 1;
+    }
+
+    virtual action_state_t idaapi update (action_update_ctx_t *) {
+        return AST_ENABLE_ALWAYS;
+    }
+};
+static prefetch_cancel_action_t prefetch_cancel_action;
+
+struct recover_layouts_action_t : public action_handler_t
+{
+    DecMap *decMap;
+
+    virtual int idaapi activate (action_activation_ctx_t *) {
+        ClassRegistry *registry = get_registry (decMap);
+        if (registry == NULL) {
+            msg ("RECPP: scan the vftables first.\n");
+            return 0;
+        }
+
+        prefetch_pause_t quiet;
+        FieldLayout::get ()->recover (registry, lastScanner, decMap);
+        return 1;
+    }
+
+    virtual action_state_t idaapi update (action_update_ctx_t *) {
+        return AST_ENABLE_ALWAYS;
+    }
+};
+static recover_layouts_action_t recover_layouts_action;
+
 // Callbacks
 
 static hook_cb_t idaapi
@@ -43,18 +378,226 @@ ui_callback (
     va_list va
 ) {
 	TWidget*view = va_arg (va, TWidget*);
-	const char* title = "Scan and rename vftables";
     switch (notification_code)
     {
         case view_created:
-			attach_action_to_popup(view, NULL, title);
-			user_menu_scan_vftable(ud);
+			attach_action_to_popup(view, NULL, "RECPP:ScanVftables");
+
+            // Scan once per database, the result is kept in the IDB after that.
+            // A scan the user cancelled is only resumed on request
+            if (!ScanState::get ()->is_valid () && !ScanState::get ()->is_partial ()) {
+                get_scan ((DecMap *) ud, false);
+            }
+        break;
+
+        // The user is working : the prefetch waits until they are idle
+        case view_keydown:
+        case view_click:
+        case view_dblclick:
+        case view_curpos:
+            if (prefetchQueue != NULL) {
+                prefetchQueue->user_input ();
+            }
         break;
     }
 
     return 0;
 }
 
+// A function appeared or disappeared : the vftables pointing to it may have
+// gained or lost slots, without any change the content hashes can see
+static void
+slot_targets_changed (
+    ScanState *scanState,
+    ea_t func_ea
+) {
+    xrefblk_t xb;
+    for (bool ok = xb.first_to (func_ea, XREF_DATA); ok; ok = xb.next_to ()) {
+        if (scanState->covers (xb.from)) {
+            scanState->mark_dirty (xb.from);
+        }
+    }
+}
+
+// A function changed : drop everything derived from its code
+static void
+function_changed (
+    DecMap *decompilationMap,
+    ea_t func_ea
+) {
+    CallGraphStore::get ()->invalidate (func_ea);
+    decompilationMap->invalidate (func_ea);
+    FieldLayout::get ()->invalidate (func_ea);
+
+    if (prefetchQueue != NULL) {
+        prefetchQueue->forget (func_ea);
+    }
+}
+
+static ssize_t idaapi
+idb_callback (
+    void *ud,
+    int notification_code,
+    va_list va
+) {
+    DecMap *decompilationMap = (DecMap *) ud;
+    CallGraphStore *store = CallGraphStore::get ();
+    ScanState *scanState = ScanState::get ();
+
+    switch (notification_code)
+    {
+        case idb_event::func_added: {
+            func_t *pfn = va_arg (va, func_t *);
+            store->invalidate (pfn->start_ea);
+
+            // The callers were walked while the target wasn't a function,
+            // their edge to it was dropped
+            xrefblk_t xb;
+            for (bool ok = xb.first_to (pfn->start_ea, XREF_FAR); ok; ok = xb.next_to ()) {
+                if (!xb.iscode) {
+                    continue;
+                }
+
+                func_t *caller = get_func (xb.from);
+                if (caller != NULL) {
+                    store->invalidate (caller->start_ea);
+                }
+            }
+
+            slot_targets_changed (scanState, pfn->start_ea);
+
+            if (classRegistry != NULL) {
+                classRegistry->on_func_added (pfn);
+
+                std::vector<ClassRegistry::slot_ref_t> refs;
+                if (classRegistry->find_slots (pfn->start_ea, &refs) != 0) {
+                    decompilationMap->add_interesting (pfn->start_ea);
+                }
+            }
+        } break;
+
+        case idb_event::deleting_func: {
+            func_t *pfn = va_arg (va, func_t *);
+            FuncIndex::get ()->invalidate ();
+            store->remove (pfn->start_ea);
+            decompilationMap->remove_interesting (pfn->start_ea);
+            FieldLayout::get ()->invalidate (pfn->start_ea);
+            slot_targets_changed (scanState, pfn->start_ea);
+
+            if (classRegistry != NULL) {
+                classRegistry->on_func_deleted (pfn);
+            }
+        } break;
+
+        case idb_event::func_updated: {
+            func_t *pfn = va_arg (va, func_t *);
+            function_changed (decompilationMap, pfn->start_ea);
+        } break;
+
+        case idb_event::set_func_end: {
+            func_t *pfn = va_arg (va, func_t *);
+            FuncIndex::get ()->invalidate ();
+            function_changed (decompilationMap, pfn->start_ea);
+        } break;
+
+        // Chunks moved between functions, the snapshot is wrong
+        case idb_event::func_tail_appended:
+        case idb_event::func_tail_deleted:
+        case idb_event::tail_owner_changed: {
+            FuncIndex::get ()->invalidate ();
+        } break;
+
+        case idb_event::set_func_start: {
+            func_t *pfn = va_arg (va, func_t *);
+            ea_t new_start = va_arg (va, ea_t);
+            FuncIndex::get ()->invalidate ();
+            store->remove (pfn->start_ea);
+            decompilationMap->invalidate (pfn->start_ea);
+            function_changed (decompilationMap, new_start);
+        } break;
+
+        case idb_event::byte_patched: {
+            ea_t ea = va_arg (va, ea_t);
+            func_t *pfn = get_func (ea);
+            if (pfn != NULL) {
+                function_changed (decompilationMap, pfn->start_ea);
+            }
+
+            if (scanState->follows (ea)) {
+                scanState->invalidate ();
+            }
+
+            if (classRegistry != NULL) {
+                classRegistry->on_data_changed (ea, 1);
+            }
+        } break;
+
+        case idb_event::make_data: {
+            ea_t ea = va_arg (va, ea_t);
+            va_arg (va, flags_t);
+            va_arg (va, tid_t);
+            asize_t len = va_arg (va, asize_t);
+
+            if (classRegistry != NULL) {
+                classRegistry->on_data_changed (ea, len);
+            }
+        } break;
+
+        case idb_event::destroyed_items: {
+            ea_t ea1 = va_arg (va, ea_t);
+            ea_t ea2 = va_arg (va, ea_t);
+
+            if (classRegistry != NULL) {
+                classRegistry->on_undefined (ea1, ea2);
+            }
+        } break;
+
+        case idb_event::renamed: {
+            ea_t ea = va_arg (va, ea_t);
+            CallGraph::names_changed ();
+
+            if (classRegistry != NULL) {
+                classRegistry->on_renamed (ea);
+            }
+        } break;
+
+        case idb_event::segm_added:
+        case idb_event::segm_deleted:
+        case idb_event::segm_moved: {
+            scanState->invalidate ();
+        } break;
+
+        case idb_event::make_code: {
+            const insn_t *insn = va_arg (va, const insn_t *);
+            func_t *pfn = get_func (insn->ea);
+            if (pfn != NULL) {
+                function_changed (decompilationMap, pfn->start_ea);
+            }
+        } break;
+
+        case idb_event::auto_empty_finally: {
+            store->ensure ();
+
+            // Batch benchmark : measure the scan and leave
+            if (Bench::requested ()) {
+                qexit (Bench::run (decompilationMap));
+            }
+        } break;
+
+        case idb_event::savebase: {
+            if (store->has_changes ()) {
+                store->save ();
+            }
+
+            if (scanState->has_changes ()) {
+                scanState->save ();
+            }
+        } break;
+    }
+
+    return 0;
+}
+
 static int idaapi hx_callback_i (void *ud, hexrays_event_t event, va_list va)
 {
     if (event == hxe_maturity)
@@ -63,15 +606,37 @@ static int idaapi hx_callback_i (void *ud, hexrays_event_t event, va_list va)
         ctree_maturity_t mat = va_argi(va, ctree_maturity_t);
         if (mat == CMAT_FINAL) {
             DecMap *decompilationMap = (DecMap *) ud;
-            msg ("Function %x decompiled, start processing...\n", cfunc->entry_ea);
             decompilationMap->process (cfunc);
+            FieldLayout::get ()->on_decompiled (cfunc);
         }
     }
+    else if (event == hxe_open_pseudocode && prefetchQueue != NULL)
+    {
+        vdui_t *vu = va_arg(va, vdui_t *);
+        ea_t func_ea = vu->cfunc->entry_ea;
+        bool isMethod = false;
+
+        // Prefetch the whole class when a method is opened
+        ClassRegistry *registry = get_registry ((DecMap *) ud);
+        if (registry != NULL) {
+            std::vector<ClassRegistry::slot_ref_t> refs;
+            registry->find_slots (func_ea, &refs);
+
+            for (size_t i = 0; i < refs.size (); i++) {
+                prefetchQueue->seed_class (registry, refs[i].cls);
+                isMethod = true;
+            }
+        }
+
+        if (!isMethod) {
+            prefetchQueue->seed_function (func_ea);
+        }
+    }
 
     return 0;
 }
 
-hexrays_cb_t* hx_callback = hx_callback;
+hexrays_cb_t* hx_callback = hx_callback_i;
 
 /*
  * @brief Initialize the RECPP plugin 
@@ -91,8 +656,68 @@ init (
          " |||  || |||||||`+||||||` |||     |||     \n"
          " +-`  +-` ------` +-----` +-`     +-`     \n");
 
+    // Call graph kept in the IDB. Without one it is built once the
+    // auto-analysis is done, or on first use, and saved with the database
+    CallGraphStore::get ()->load ();
+
+    ScanState::get ()->load ();
+
+    // The writers are no longer listed in an IDC array, drop the one older scans left
+    nodeidx_t addrList = IDAUtils::GetArrayId ("AddrList");
+    if (addrList != BADNODE) {
+        IDAUtils::DeleteArray (addrList);
+    }
+
     DecMap *decompilationMap = new DecMap ();
+    decompilationCache = decompilationMap;
     hook_to_notification_point(HT_VIEW, ui_callback, decompilationMap);
+    hook_to_notification_point(HT_IDB, idb_callback, decompilationMap);
+    prefetchQueue = new PrefetchQueue (decompilationMap);
+
+    scan_action.decMap = decompilationMap;
+    register_action (ACTION_DESC_LITERAL (
+        "RECPP:ScanVftables", "Scan and rename vftables",
+        &scan_action, NULL, NULL, -1));
+    attach_action_to_menu ("Edit/Other/", "RECPP:ScanVftables", SETMENU_APP);
+
+    reaching_slots_action.decMap = decompilationMap;
+    register_action (ACTION_DESC_LITERAL (
+        "RECPP:FindReachingSlots", "Virtual methods reaching...",
+        &reaching_slots_action, NULL, NULL, -1));
+    attach_action_to_menu ("Search/", "RECPP:FindReachingSlots", SETMENU_APP);
+
+    class_browser_action.decMap = decompilationMap;
+    register_action (ACTION_DESC_LITERAL (
+        "RECPP:ClassBrowser", "RECPP classes",
+        &class_browser_action, NULL, NULL, -1));
+    attach_action_to_menu ("View/Open subviews/", "RECPP:ClassBrowser", SETMENU_APP);
+
+    class_tree_action.decMap = decompilationMap;
+    register_action (ACTION_DESC_LITERAL (
+        "RECPP:ClassTree", "RECPP inheritance",
+        &class_tree_action, NULL, NULL, -1));
+    attach_action_to_menu ("View/Open subviews/", "RECPP:ClassTree", SETMENU_APP);
+
+    register_action (ACTION_DESC_LITERAL (
+        "RECPP:MemoryStats", "RECPP memory usage",
+        &memory_stats_action, NULL, NULL, -1));
+    attach_action_to_menu ("Edit/Other/", "RECPP:MemoryStats", SETMENU_APP);
+
+    register_action (ACTION_DESC_LITERAL (
+        "RECPP:PrefetchPause", "Pause / resume the decompilation prefetch",
+        &prefetch_pause_action, NULL, NULL, -1));
+    attach_action_to_menu ("Edit/Other/", "RECPP:PrefetchPause", SETMENU_APP);
+
+    register_action (ACTION_DESC_LITERAL (
+        "RECPP:PrefetchCancel", "Cancel the decompilation prefetch",
+        &prefetch_cancel_action, NULL, NULL, -1));
+    attach_action_to_menu ("Edit/Other/", "RECPP:PrefetchCancel", SETMENU_APP);
+
+    recover_layouts_action.decMap = decompilationMap;
+    register_action (ACTION_DESC_LITERAL (
+        "RECPP:RecoverLayouts", "Recover class layouts",
+        &recover_layouts_action, NULL, NULL, -1));
+    attach_action_to_menu ("Edit/Other/", "RECPP:RecoverLayouts", SETMENU_APP);
     install_hexrays_callback (hx_callback, decompilationMap);
     inited = true;
 
@@ -107,7 +732,39 @@ term (
     void
 ) {
     if (inited) {
-        // remove_hexrays_callback (callback, NULL);
+        // Nothing may call back into what is destroyed below
+        remove_hexrays_callback (hx_callback, decompilationCache);
+        unhook_from_notification_point (HT_VIEW, ui_callback, decompilationCache);
+        unhook_from_notification_point (HT_IDB, idb_callback, decompilationCache);
+        unregister_action ("RECPP:RecoverLayouts");
+        unregister_action ("RECPP:PrefetchCancel");
+        unregister_action ("RECPP:PrefetchPause");
+        unregister_action ("RECPP:MemoryStats");
+        unregister_action ("RECPP:ClassTree");
+        unregister_action ("RECPP:ClassBrowser");
+        unregister_action ("RECPP:FindReachingSlots");
+        unregister_action ("RECPP:ScanVftables");
+
+        delete prefetchQueue;
+        prefetchQueue = NULL;
+
+        delete reachability;
+        reachability = NULL;
+        delete lastScanner;
+        lastScanner = NULL;
+        ClassBrowser::term ();
+        ClassTree::term ();
+        delete classRegistry;
+        classRegistry = NULL;
+        ScanState::term ();
+        FuncIndex::term ();
+        FieldLayout::term ();
+        CallGraphStore::term ();
+        Profiler::term ();
+
+        // The cached cfuncs must be released while the decompiler is still there
+        delete decompilationCache;
+        decompilationCache = NULL;
         term_hexrays_plugin ();
     }
 }
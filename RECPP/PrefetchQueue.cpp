@@ -0,0 +1,229 @@
+﻿/*
+    ██████╗ ███████╗ ██████╗██████╗ ██████╗ 
+    ██╔══██╗██╔════╝██╔════╝██╔══██╗██╔══██╗
+    ██████╔╝█████╗  ██║     ██████╔╝██████╔╝
+    ██╔══██╗██╔══╝  ██║     ██╔═══╝ ██╔═══╝ 
+    ██║  ██║███████╗╚██████╗██║     ██║     
+    ╚═╝  ╚═╝╚══════╝ ╚═════╝╚═╝     ╚═╝     
+* @license : <license placeholder>
+*/
+
+#include "PrefetchQueue.h"
+#include "CallGraphStore.h"
+#include <algorithm>
+
+
+PrefetchQueue::PrefetchQueue (DecMap *decMap) {
+    this->decMap = decMap;
+    this->seq = 0;
+    this->seed = 0;
+    this->completed = 0;
+    this->last_input = 0;
+    this->timer = NULL;
+    this->paused = false;
+}
+
+PrefetchQueue::~PrefetchQueue () {
+    cancel ();
+}
+
+bool
+PrefetchQueue::push (
+    ea_t funcEa,
+    int distance
+) {
+    item_t item = { this->seed, distance, this->seq, funcEa };
+
+    std::map<ea_t, item_t>::iterator it = this->queued.find (funcEa);
+    if (it != this->queued.end ()) {
+        if (it->second.seed == item.seed && it->second.distance <= item.distance) {
+            return false;
+        }
+
+        // Moved up, the entry already in the heap goes stale
+        it->second = item;
+    }
+    else {
+        this->queued.insert (std::make_pair (funcEa, item));
+    }
+
+    this->seq++;
+    this->heap.push_back (item);
+    std::push_heap (this->heap.begin (), this->heap.end ());
+
+    // Opened by the user before its turn, its decompilation is kept all the same
+    this->decMap->add_interesting (funcEa);
+
+    return true;
+}
+
+void
+PrefetchQueue::push_neighborhood (
+    ea_t funcEa,
+    int distance
+) {
+    func_t *f = get_func (funcEa);
+    if (f == NULL) {
+        return;
+    }
+
+    // Breadth first over the callees, so the distances are the shortest ones
+    std::vector<ea_t> level (1, f->start_ea);
+    std::vector<ea_t> next;
+    std::vector<ea_t> callees;
+    CallGraphStore *store = CallGraphStore::get ();
+
+    // Not before the auto-analysis is done, the graph would miss functions
+    if (auto_is_ok ()) {
+        store->ensure ();
+    }
+
+    for (int depth = 0; depth <= PREFETCH_MAX_DEPTH && !level.empty (); depth++)
+    {
+        next.clear ();
+
+        for (size_t i = 0; i < level.size (); i++)
+        {
+            if (push (level[i], distance + depth) && depth < PREFETCH_MAX_DEPTH) {
+                store->callees (level[i], &callees);
+                next.insert (next.end (), callees.begin (), callees.end ());
+            }
+        }
+
+        level.swap (next);
+    }
+}
+
+void
+PrefetchQueue::seed_class (
+    const ClassRegistry *registry,
+    int cls
+) {
+    this->seed++;
+
+    for (uint32 i = 0; i < registry->get_class (cls).slot_count; i++) {
+        push_neighborhood (registry->slot_target (cls, i), 0);
+    }
+
+    arm ();
+}
+
+void
+PrefetchQueue::seed_function (
+    ea_t funcEa
+) {
+    this->seed++;
+
+    push_neighborhood (funcEa, 0);
+    arm ();
+}
+
+void
+PrefetchQueue::arm (
+    void
+) {
+    if (this->timer == NULL && !this->paused && !this->heap.empty ()) {
+        this->timer = register_timer (PREFETCH_TICK_MS, timer_cb, this);
+    }
+}
+
+void
+PrefetchQueue::pause (
+    void
+) {
+    this->paused = true;
+
+    if (this->timer != NULL) {
+        unregister_timer (this->timer);
+        this->timer = NULL;
+    }
+}
+
+void
+PrefetchQueue::resume (
+    void
+) {
+    this->paused = false;
+    arm ();
+}
+
+void
+PrefetchQueue::cancel (
+    void
+) {
+    pause ();
+
+    this->heap.clear ();
+    this->queued.clear ();
+    this->paused = false;
+}
+
+void
+PrefetchQueue::forget (
+    ea_t funcEa
+) {
+    this->queued.erase (funcEa);
+}
+
+void
+PrefetchQueue::user_input (
+    void
+) {
+    this->last_input = get_nsec_stamp ();
+}
+
+int
+PrefetchQueue::tick (
+    void
+) {
+    if (this->paused) {
+        this->timer = NULL;
+        return -1;
+    }
+
+    // The auto analysis still has work to do, don't compete with it
+    if (!auto_is_ok ()) {
+        return PREFETCH_TICK_MS;
+    }
+
+    // Nor with the user, a decompilation would make the UI stutter
+    uint64 now = get_nsec_stamp ();
+    if (now - this->last_input < (uint64) PREFETCH_IDLE_MS * 1000000) {
+        return PREFETCH_TICK_MS;
+    }
+
+    uint64 deadline = now + (uint64) PREFETCH_SLICE_MS * 1000000;
+
+    while (!this->heap.empty () && get_nsec_stamp () < deadline)
+    {
+        std::pop_heap (this->heap.begin (), this->heap.end ());
+        item_t item = this->heap.back ();
+        this->heap.pop_back ();
+
+        // Moved up by a later seed, or forgotten : not the live entry
+        std::map<ea_t, item_t>::iterator it = this->queued.find (item.ea);
+        if (it == this->queued.end () || it->second.seq != item.seq) {
+            continue;
+        }
+
+        // Done : the cache may evict it later, a new seed queues it again
+        this->queued.erase (it);
+        this->decMap->get (item.ea);
+        this->completed++;
+    }
+
+    if (this->heap.empty ()) {
+        // Unregistered by returning -1, armed again by the next seed
+        this->timer = NULL;
+        return -1;
+    }
+
+    return PREFETCH_TICK_MS;
+}
+
+int idaapi
+PrefetchQueue::timer_cb (
+    void *ud
+) {
+    return ((PrefetchQueue *) ud)->tick ();
+}
@@ -0,0 +1,162 @@
+﻿/*
+    ██████╗ ███████╗ ██████╗██████╗ ██████╗ 
+    ██╔══██╗██╔════╝██╔════╝██╔══██╗██╔══██╗
+    ██████╔╝█████╗  ██║     ██████╔╝██████╔╝
+    ██╔══██╗██╔══╝  ██║     ██╔═══╝ ██╔═══╝ 
+    ██║  ██║███████╗╚██████╗██║     ██║     
+    ╚═╝  ╚═╝╚══════╝ ╚═════╝╚═╝     ╚═╝     
+* @license : <license placeholder>
+*/
+
+#pragma once
+
+
+// ---------- Includes ------------
+#include "RECPP.h"
+#include "DecMap.h"
+#include "ClassRegistry.h"
+#include <vector>
+#include <map>
+
+// ---------- Defines -------------
+#define PREFETCH_TICK_MS   200 // how often we look for idle time
+#define PREFETCH_SLICE_MS  30  // how long one tick may decompile
+#define PREFETCH_MAX_DEPTH 2   // how far into the callees we go
+#define PREFETCH_IDLE_MS   500 // quiet time after the last user input before draining
+
+
+// ------ Class definition --------
+// Background decompilation of the functions the analyst is likely to open
+// next : the methods of the class being viewed first, then their callees in
+// call graph distance order.
+// The latest seed always goes first : functions it reaches that were queued
+// by an older seed are moved up, their old heap entries are skipped when
+// they come out.
+// The queue is drained from a timer, in short slices, and only while both
+// the auto analysis and the user are idle. It can be paused, resumed or
+// cancelled at any time.
+class PrefetchQueue
+{
+public:
+    PrefetchQueue (DecMap *decMap);
+    ~PrefetchQueue ();
+
+    /*
+     * @brief : Queue the methods of a class, and their callees
+     */
+    void
+    seed_class (
+        const ClassRegistry *registry,
+        int cls
+    );
+
+    /*
+     * @brief : Queue a function and its callees
+     */
+    void
+    seed_function (
+        ea_t funcEa
+    );
+
+    /*
+     * @brief : Stop draining, the queue is kept
+     */
+    void
+    pause (
+        void
+    );
+
+    /*
+     * @brief : Restart draining where it stopped
+     */
+    void
+    resume (
+        void
+    );
+
+    /*
+     * @brief : Stop draining and forget everything queued
+     */
+    void
+    cancel (
+        void
+    );
+
+    /*
+     * @brief : Drop a function from the queue because it changed, the next seed queues it again
+     */
+    void
+    forget (
+        ea_t funcEa
+    );
+
+    /*
+     * @brief : The user did something, hold the decompilations for PREFETCH_IDLE_MS
+     */
+    void
+    user_input (
+        void
+    );
+
+    bool is_paused () const { return this->paused; }
+    size_t pending () const { return this->queued.size (); }
+    size_t done () const { return this->completed; }
+
+private:
+    struct item_t
+    {
+        uint32 seed;    // seed generation, the latest one first
+        int distance;   // call graph distance from the seed
+        uint32 seq;     // insertion order, to break ties
+        ea_t ea;
+
+        // std heaps are max-heaps : the latest seed, then the smallest
+        // distance must compare greatest
+        bool operator< (const item_t &o) const {
+            if (seed != o.seed) return seed < o.seed;
+            if (distance != o.distance) return distance > o.distance;
+            return seq > o.seq;
+        }
+    };
+
+    DecMap *decMap;
+    std::vector<item_t> heap;           // may hold stale entries, see queued
+    std::map<ea_t, item_t> queued;      // live entry of every function queued and not decompiled yet
+    uint32 seq;
+    uint32 seed;
+    size_t completed;
+    uint64 last_input;
+    qtimer_t timer;
+    bool paused;
+
+    /*
+     * @brief : Queue a function for the current seed
+     * @return false if it was already queued as high
+     */
+    bool
+    push (
+        ea_t funcEa,
+        int distance
+    );
+
+    void
+    push_neighborhood (
+        ea_t funcEa,
+        int distance
+    );
+
+    void
+    arm (
+        void
+    );
+
+    int
+    tick (
+        void
+    );
+
+    static int idaapi
+    timer_cb (
+        void *ud
+    );
+};
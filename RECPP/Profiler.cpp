@@ -0,0 +1,209 @@
+﻿/*
+    ██████╗ ███████╗ ██████╗██████╗ ██████╗ 
+    ██╔══██╗██╔════╝██╔════╝██╔══██╗██╔══██╗
+    ██████╔╝█████╗  ██║     ██████╔╝██████╔╝
+    ██╔══██╗██╔══╝  ██║     ██╔═══╝ ██╔═══╝ 
+    ██║  ██║███████╗╚██████╗██║     ██║     
+    ╚═╝  ╚═╝╚══════╝ ╚═════╝╚═╝     ╚═╝     
+* @license : <license placeholder>
+*/
+
+#include "Profiler.h"
+
+Profiler *Profiler::instance = NULL;
+
+
+Profiler::Profiler () {
+    reset ();
+}
+
+Profiler *
+Profiler::get (
+    void
+) {
+    if (instance == NULL) {
+        instance = new Profiler ();
+    }
+
+    return instance;
+}
+
+void
+Profiler::term (
+    void
+) {
+    delete instance;
+    instance = NULL;
+}
+
+void
+Profiler::reset (
+    void
+) {
+    node_t root = { "total", -1, 0, 0, 0, std::vector<int> () };
+
+    this->nodes.assign (1, root);
+    this->current = 0;
+}
+
+int
+Profiler::enter (
+    const char *name
+) {
+    node_t &parent = this->nodes[this->current];
+
+    // Phase names are literals, the pointer is enough most of the time
+    for (size_t i = 0; i < parent.children.size (); i++) {
+        int c = parent.children[i];
+        if (this->nodes[c].name == name || strcmp (this->nodes[c].name, name) == 0) {
+            this->current = c;
+            return c;
+        }
+    }
+
+    node_t node = { name, this->current, 0, 0, 0, std::vector<int> () };
+    int id = (int) this->nodes.size ();
+
+    this->nodes[this->current].children.push_back (id);
+    this->nodes.push_back (node);
+    this->current = id;
+
+    return id;
+}
+
+void
+Profiler::leave (
+    int node,
+    uint64 elapsedNs,
+    uint64 items
+) {
+    node_t &n = this->nodes[node];
+
+    n.total_ns += elapsedNs;
+    n.calls++;
+    n.items += items;
+
+    this->current = n.parent >= 0 ? n.parent : 0;
+}
+
+// The root is never left, its time is the one of its children
+uint64
+Profiler::node_ns (
+    int n
+) const {
+    if (n != 0) {
+        return this->nodes[n].total_ns;
+    }
+
+    uint64 total = 0;
+    for (size_t i = 0; i < this->nodes[0].children.size (); i++) {
+        total += this->nodes[this->nodes[0].children[i]].total_ns;
+    }
+
+    return total;
+}
+
+void
+Profiler::sum (
+    const char *name,
+    uint64 *ns,
+    uint64 *calls,
+    uint64 *items
+) const {
+    *ns = *calls = *items = 0;
+
+    for (size_t n = 1; n < this->nodes.size (); n++)
+    {
+        const node_t &node = this->nodes[n];
+        if (strcmp (node.name, name) != 0) {
+            continue;
+        }
+
+        bool nested = false;
+        for (int p = node.parent; p > 0 && !nested; p = this->nodes[p].parent) {
+            nested = strcmp (this->nodes[p].name, name) == 0;
+        }
+
+        if (!nested) {
+            *ns += node.total_ns;
+            *calls += node.calls;
+            *items += node.items;
+        }
+    }
+}
+
+void
+Profiler::report_node (
+    int n,
+    int depth
+) const {
+    const node_t &node = this->nodes[n];
+    uint64 ns = node_ns (n);
+    uint64 parentNs = node.parent >= 0 ? node_ns (node.parent) : 0;
+
+    char rate[64] = "";
+    if (node.items != 0 && ns != 0) {
+        qsnprintf (rate, sizeof (rate), ", %.0f items/s", node.items * 1e9 / ns);
+    }
+
+    msg ("%*s%-*s %10.3f ms %5.1f%% %8d calls %8d items%s\n",
+         depth * 2, "", 32 - depth * 2, node.name,
+         ns / 1e6,
+         parentNs ? ns * 100.0 / parentNs : 100.0,
+         (int) node.calls, (int) node.items, rate);
+
+    for (size_t i = 0; i < node.children.size (); i++) {
+        report_node (node.children[i], depth + 1);
+    }
+}
+
+void
+Profiler::report (
+    void
+) const {
+    if (!PROFILER_ENABLED) {
+        return;
+    }
+
+    msg ("----- RECPP profile -----\n");
+    report_node (0, 0);
+}
+
+void
+Profiler::json_node (
+    FILE *fp,
+    int n,
+    int depth
+) const {
+    const node_t &node = this->nodes[n];
+
+    qfprintf (fp, "%*s{ \"name\": \"%s\", \"ns\": %" FMT_64 "u, \"calls\": %" FMT_64 "u, \"items\": %" FMT_64 "u, \"children\": [",
+              depth * 2, "", node.name, node_ns (n), node.calls, node.items);
+
+    for (size_t i = 0; i < node.children.size (); i++) {
+        qfprintf (fp, i == 0 ? "\n" : ",\n");
+        json_node (fp, node.children[i], depth + 1);
+    }
+
+    qfprintf (fp, "] }");
+}
+
+bool
+Profiler::export_json (
+    const char *path
+) const {
+    if (!PROFILER_ENABLED) {
+        return false;
+    }
+
+    FILE *fp = qfopen (path, "w");
+    if (fp == NULL) {
+        return false;
+    }
+
+    json_node (fp, 0, 0);
+    qfprintf (fp, "\n");
+    qfclose (fp);
+
+    return true;
+}
@@ -0,0 +1,199 @@
+﻿/*
+    ██████╗ ███████╗ ██████╗██████╗ ██████╗ 
+    ██╔══██╗██╔════╝██╔════╝██╔══██╗██╔══██╗
+    ██████╔╝█████╗  ██║     ██████╔╝██████╔╝
+    ██╔══██╗██╔══╝  ██║     ██╔═══╝ ██╔═══╝ 
+    ██║  ██║███████╗╚██████╗██║     ██║     
+    ╚═╝  ╚═╝╚══════╝ ╚═════╝╚═╝     ╚═╝     
+* @license : <license placeholder>
+*/
+
+#pragma once
+
+
+// ---------- Includes ------------
+#include "RECPP.h"
+#include <vector>
+
+// ---------- Defines -------------
+// Profiling is only built in the configurations defining RECPP_PROFILING,
+// everywhere else the scopes below are empty objects the compiler drops
+#ifdef RECPP_PROFILING
+#define PROFILER_ENABLED true
+#else
+#define PROFILER_ENABLED false
+#endif
+
+#define PROFILE_CONCAT2(a, b) a##b
+#define PROFILE_CONCAT(a, b)  PROFILE_CONCAT2(a, b)
+
+// Time the rest of the enclosing block as a phase, nested in the current one
+#define PROFILE_SCOPE(name)   ScopedPhase PROFILE_CONCAT(_phase_, __LINE__) (name)
+
+// Count items in a phase without timing it
+#define PROFILE_COUNT(name, n) Profiler::count<PROFILER_ENABLED> (name, n)
+
+
+// ------ Class definition --------
+// Hierarchical phase profiler.
+//
+// Phases form a tree following the nesting of the scopes : the same phase
+// entered from two different parents gets two nodes. Every node aggregates
+// its wall time, number of calls and number of processed items.
+// Only meant for the UI thread, workers of parallel_for must not open scopes.
+class Profiler
+{
+public:
+    struct node_t
+    {
+        const char *name;
+        int parent;
+        uint64 total_ns;
+        uint64 calls;
+        uint64 items;
+        std::vector<int> children;
+    };
+
+    static Profiler *
+    get (
+        void
+    );
+
+    static void
+    term (
+        void
+    );
+
+    /*
+     * @brief : Open a phase under the current one
+     * @return The node of the phase
+     */
+    int
+    enter (
+        const char *name
+    );
+
+    /*
+     * @brief : Close the phase opened by enter ()
+     */
+    void
+    leave (
+        int node,
+        uint64 elapsedNs,
+        uint64 items
+    );
+
+    template <bool Enabled>
+    static void
+    count (
+        const char *name,
+        uint64 n
+    ) {
+        if (Enabled) {
+            Profiler *p = get ();
+            p->leave (p->enter (name), 0, n);
+        }
+    }
+
+    /*
+     * @brief : Forget every measure
+     */
+    void
+    reset (
+        void
+    );
+
+    /*
+     * @brief : Print the phase tree to the output window
+     */
+    void
+    report (
+        void
+    ) const;
+
+    /*
+     * @brief : Write the phase tree as JSON
+     * @return false if the file can't be written
+     */
+    bool
+    export_json (
+        const char *path
+    ) const;
+
+    /*
+     * @brief : Sum a phase over every parent it was entered from. Phases
+     *          nested in a phase of the same name are only counted once
+     */
+    void
+    sum (
+        const char *name,
+        uint64 *ns,
+        uint64 *calls,
+        uint64 *items
+    ) const;
+
+    int current_node () const { return this->current; }
+    int node_count () const { return (int) this->nodes.size (); }
+    const node_t &get_node (int n) const { return this->nodes[n]; }
+
+private:
+    Profiler ();
+
+    static Profiler *instance;
+
+    std::vector<node_t> nodes;  // 0 is the root
+    int current;
+
+    uint64
+    node_ns (
+        int n
+    ) const;
+
+    void
+    report_node (
+        int n,
+        int depth
+    ) const;
+
+    void
+    json_node (
+        FILE *fp,
+        int n,
+        int depth
+    ) const;
+};
+
+// Timer of one phase, for the lifetime of the object
+template <bool Enabled>
+class ScopedPhaseT;
+
+template <>
+class ScopedPhaseT<true>
+{
+public:
+    ScopedPhaseT (const char *name) : items (0) {
+        this->node = Profiler::get ()->enter (name);
+        this->start = get_nsec_stamp ();
+    }
+
+    ~ScopedPhaseT () {
+        Profiler::get ()->leave (this->node, get_nsec_stamp () - this->start, this->items);
+    }
+
+    void add_items (uint64 n) { this->items += n; }
+
+private:
+    int node;
+    uint64 start;
+    uint64 items;
+};
+
+template <>
+class ScopedPhaseT<false>
+{
+public:
+    ScopedPhaseT (const char *) { }
+    void add_items (uint64) { }
+};
+
+typedef ScopedPhaseT<PROFILER_ENABLED> ScopedPhase;
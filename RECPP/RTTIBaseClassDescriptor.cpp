@@ -10,6 +10,7 @@
 #include "RTTIBaseClassDescriptor.h"
 #include "TypeDescriptor.h"
 #include "IDAUtils.h"
+#include "Profiler.h"
 
 
 char *
@@ -18,6 +19,8 @@ CRTTIBaseClassDescriptor::parse (
     char *buffer3,
     size_t bufferSize
 ) {
+    PROFILE_SCOPE ("RTTI base class");
+
     if (address == BADADDR || !address) {
         return NULL;
     }
@@ -34,12 +37,12 @@ CRTTIBaseClassDescriptor::parse (
     IDAUtils::DwordArrayCmt(address + 8, 3, "PMD where");
     IDAUtils::DwordCmt(address + 20, "attributes");
 
-    char *s = CTypeDescriptor::parse (get_dword (address), buffer3, bufferSize);
+    char *s = CTypeDescriptor::parse (IDAUtils::Dword (address), buffer3, bufferSize);
     //??_R1A@?0A@A@B@@8 = B::`RTTI Base Class Descriptor at (0,-1,0,0)'
-    IDAUtils::MangleNumber (get_dword (address + 8), m1, sizeof (m1));
-    IDAUtils::MangleNumber (get_dword (address + 12), m2, sizeof (m2));
-    IDAUtils::MangleNumber (get_dword (address + 16), m3, sizeof (m3));
-    IDAUtils::MangleNumber (get_dword (address + 20), m4, sizeof (m4));
+    IDAUtils::MangleNumber (IDAUtils::Dword (address + 8), m1, sizeof (m1));
+    IDAUtils::MangleNumber (IDAUtils::Dword (address + 12), m2, sizeof (m2));
+    IDAUtils::MangleNumber (IDAUtils::Dword (address + 16), m3, sizeof (m3));
+    IDAUtils::MangleNumber (IDAUtils::Dword (address + 20), m4, sizeof (m4));
 
     sprintf_s (buffer, sizeof (buffer), "??_R1%s%s%s%s%s8", m1, m2, m3, m4, &s[4]);
     IDAUtils::MakeName (address, buffer);
@@ -10,34 +10,37 @@
 #include "RTTIClassHierarchyDescriptor.h"
 #include "RTTIBaseClassDescriptor.h"
 #include "IDAUtils.h"
+#include "Profiler.h"
 
 
 void
 CRTTIClassHierarchyDescriptor::parse (
     ea_t address
 ) {
+    PROFILE_SCOPE ("RTTI hierarchy");
+
     if (address == BADADDR || !address) {
         return;
     }
 
     char buffer[2048] = {0};
 
-    ea_t a = get_dword (address + 4);
+    ea_t a = IDAUtils::Dword (address + 4);
 
     IDAUtils::DwordCmt(address, "signature");
     IDAUtils::DwordCmt(address + 4, "attributes");
     IDAUtils::DwordCmt(address + 8, "numBaseClasses");
     IDAUtils::OffCmt(address + 12, "pBaseClassArray");
 
-    a = get_dword (address + 12);
-    ea_t n = get_dword (address + 8);
+    a = IDAUtils::Dword (address + 12);
+    ea_t n = IDAUtils::Dword (address + 8);
     ea_t i = 0;
     
     // IDAUtils::DumpNestedClass (a, indent, n);
 
     while (i < n) 
     {
-        ea_t p = get_dword (a);
+        ea_t p = IDAUtils::Dword (a);
 
         sprintf_s (buffer, sizeof (buffer), "BaseClass[%02d]", i);
         IDAUtils::OffCmt(a, buffer);
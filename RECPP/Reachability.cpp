@@ -0,0 +1,233 @@
+﻿/*
+    ██████╗ ███████╗ ██████╗██████╗ ██████╗ 
+    ██╔══██╗██╔════╝██╔════╝██╔══██╗██╔══██╗
+    ██████╔╝█████╗  ██║     ██████╔╝██████╔╝
+    ██╔══██╗██╔══╝  ██║     ██╔═══╝ ██╔═══╝ 
+    ██║  ██║███████╗╚██████╗██║     ██║     
+    ╚═╝  ╚═╝╚══════╝ ╚═════╝╚═╝     ╚═╝     
+* @license : <license placeholder>
+*/
+
+#include "Reachability.h"
+#include <algorithm>
+
+
+Reachability::Reachability () {
+    this->store = CallGraphStore::get ();
+    this->store_gen = 0;
+    this->current = NULL;
+}
+
+void
+Reachability::clear (
+    void
+) {
+    this->memo.clear ();
+    this->scc.clear ();
+    this->current = NULL;
+    this->store_gen = 0;
+}
+
+void
+Reachability::sync (
+    void
+) {
+    // Pending IDB changes have to be in the compact view first
+    this->store->compact ();
+
+    if (this->store_gen == this->store->generation () && this->scc.comp_count () > 0) {
+        return;
+    }
+
+    uint32 n = this->store->node_count ();
+    std::vector<int> succStart (n + 1, 0);
+    std::vector<int> succ;
+    succ.reserve (this->store->edge_count ());
+
+    for (uint32 i = 0; i < n; i++) {
+        for (const uint32 *s = this->store->succ_begin (i); s != this->store->succ_end (i); s++) {
+            succ.push_back ((int) *s);
+        }
+        succStart[i + 1] = (int) succ.size ();
+    }
+
+    this->scc.compute ((int) n, succStart, succ);
+    this->memo.clear ();
+    this->current = NULL;
+    this->store_gen = this->store->generation ();
+}
+
+bool
+Reachability::query (
+    const std::vector<ea_t> &sinks
+) {
+    this->store->ensure ();
+    if (!this->store->is_loaded ()) {
+        return false;
+    }
+
+    sync ();
+
+    std::vector<ea_t> key (sinks);
+    std::sort (key.begin (), key.end ());
+    key.erase (std::unique (key.begin (), key.end ()), key.end ());
+
+    memo_t::iterator it = this->memo.find (key);
+    if (it != this->memo.end ()) {
+        this->current = &it->second;
+        return true;
+    }
+
+    // The components reaching a sink are the ones calling into them, one
+    // backward walk from all the sink components at once
+    std::vector<int> nodes;
+    for (size_t i = 0; i < key.size (); i++)
+    {
+        int node = this->store->find_node (key[i]);
+        if (node >= 0) {
+            nodes.push_back (node);
+        }
+    }
+
+    int compCount = this->scc.comp_count ();
+    std::vector<bool> reaching;
+    this->scc.dirty_closure (nodes, &reaching);
+
+    std::vector<bool> isSink (compCount, false);
+    for (size_t i = 0; i < nodes.size (); i++) {
+        isSink[this->scc.comp_of (nodes[i])] = true;
+    }
+
+    // Distance to the nearest sink, callees first : each component only
+    // reads the components below it, which are done
+    result_t result;
+    result.depth.assign (compCount, RCH_NO_PATH);
+
+    this->scc.run_bottom_up ([&] (int c) {
+        if (isSink[c]) {
+            result.depth[c] = 0;
+            return;
+        }
+
+        uint32 best = RCH_NO_PATH;
+        for (const int *d = this->scc.dag_begin (c); d != this->scc.dag_end (c); d++) {
+            if (result.depth[*d] != RCH_NO_PATH && result.depth[*d] + 1 < best) {
+                best = result.depth[*d] + 1;
+            }
+        }
+        result.depth[c] = best;
+    }, &reaching);
+
+    result.reach.assign ((compCount + 63) / 64, 0);
+    for (int c = 0; c < compCount; c++) {
+        if (reaching[c]) {
+            set (result.reach, c);
+        }
+    }
+
+    it = this->memo.insert (std::make_pair (key, result_t ())).first;
+    it->second.reach.swap (result.reach);
+    it->second.depth.swap (result.depth);
+    this->current = &it->second;
+
+    return true;
+}
+
+bool
+Reachability::reaches (
+    ea_t funcEa
+) const {
+    if (this->current == NULL) {
+        return false;
+    }
+
+    int node = this->store->find_node (funcEa);
+    if (node < 0) {
+        return false;
+    }
+
+    return test (this->current->reach, this->scc.comp_of (node));
+}
+
+uint32
+Reachability::depth (
+    ea_t funcEa
+) const {
+    if (this->current == NULL) {
+        return RCH_NO_PATH;
+    }
+
+    int node = this->store->find_node (funcEa);
+    if (node < 0) {
+        return RCH_NO_PATH;
+    }
+
+    return this->current->depth[this->scc.comp_of (node)];
+}
+
+size_t
+Reachability::virtual_slots (
+    const std::vector<ea_t> &sinks,
+    const ClassRegistry *registry,
+    std::vector<slot_t> *out
+) {
+    out->clear ();
+
+    if (!query (sinks)) {
+        return 0;
+    }
+
+    for (int c = 0; c < (int) registry->class_count (); c++)
+    {
+        const ClassRegistry::class_t &cls = registry->get_class (c);
+        if (!cls.alive) {
+            continue;
+        }
+
+        for (uint32 i = 0; i < cls.slot_count; i++)
+        {
+            ea_t func = registry->slot_func (c, i);
+
+            if (func != BADADDR && reaches (func)) {
+                slot_t slot = { cls.vtable, i, func, depth (func) };
+                out->push_back (slot);
+            }
+        }
+    }
+
+    return out->size ();
+}
+
+size_t
+Reachability::sink_by_name (
+    const char *name,
+    std::vector<ea_t> *out
+) {
+    ea_t ea = get_name_ea (BADADDR, name);
+    if (ea == BADADDR) {
+        return 0;
+    }
+
+    func_t *f = get_func (ea);
+    if (f != NULL) {
+        out->push_back (f->start_ea);
+        return 1;
+    }
+
+    // An import slot : its thunks and the functions calling through it
+    size_t count = 0;
+    xrefblk_t xb;
+
+    for (bool ok = xb.first_to (ea, XREF_DATA); ok; ok = xb.next_to ())
+    {
+        f = get_func (xb.from);
+        if (f == NULL) {
+            continue;
+        }
+
+        out->push_back (f->start_ea);
+        count++;
+    }
+
+    return count;
+}
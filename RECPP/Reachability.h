@@ -0,0 +1,130 @@
+﻿/*
+    ██████╗ ███████╗ ██████╗██████╗ ██████╗ 
+    ██╔══██╗██╔════╝██╔════╝██╔══██╗██╔══██╗
+    ██████╔╝█████╗  ██║     ██████╔╝██████╔╝
+    ██╔══██╗██╔══╝  ██║     ██╔═══╝ ██╔═══╝ 
+    ██║  ██║███████╗╚██████╗██║     ██║     
+    ╚═╝  ╚═╝╚══════╝ ╚═════╝╚═╝     ╚═╝     
+* @license : <license placeholder>
+*/
+
+#pragma once
+
+
+// ---------- Includes ------------
+#include "RECPP.h"
+#include "CallGraphStore.h"
+#include "SccCondensation.h"
+#include "ClassRegistry.h"
+#include <vector>
+#include <map>
+
+// ---------- Defines -------------
+#define RCH_NO_PATH 0xFFFFFFFF
+
+
+// ------ Class definition --------
+// "Which functions can reach one of these sinks ?" over the stored call graph.
+//
+// Answers are computed on the condensation of the graph : a function reaches
+// a sink iff its component does, so a result is one bit per component.
+// A sink set costs a single backward walk over the condensation DAG, then one
+// bottom-up pass over the reaching components, level by level in parallel,
+// for the number of calls to the nearest sink. Both are remembered until the
+// call graph changes.
+class Reachability
+{
+public:
+    struct slot_t
+    {
+        ea_t vtable;    // vtable address
+        size_t index;   // slot index in the vtable
+        ea_t method;    // function the slot points to
+        uint32 depth;   // calls from the method to the nearest sink
+    };
+
+    Reachability ();
+
+    /*
+     * @brief : Compute (or fetch) the set of functions reaching any of \sinks
+     * @param sinks : Function addresses, the order doesn't matter
+     * @return false if the call graph isn't available
+     */
+    bool
+    query (
+        const std::vector<ea_t> &sinks
+    );
+
+    /*
+     * @brief : Does \funcEa reach the sinks of the last query ?
+     */
+    bool
+    reaches (
+        ea_t funcEa
+    ) const;
+
+    /*
+     * @brief : Number of calls from \funcEa to the nearest sink of the last query
+     * @return 0 for a sink, RCH_NO_PATH if it doesn't reach any
+     */
+    uint32
+    depth (
+        ea_t funcEa
+    ) const;
+
+    /*
+     * @brief : Get every vtable slot whose method reaches one of \sinks
+     * @param registry : The classes whose slots are checked
+     * @param out : Receives the matching slots
+     * @return The number of matching slots
+     */
+    size_t
+    virtual_slots (
+        const std::vector<ea_t> &sinks,
+        const ClassRegistry *registry,
+        std::vector<slot_t> *out
+    );
+
+    /*
+     * @brief : Resolve a sink by name (e.g. "memcpy", "??2@YAPAXI@Z").
+     *          An import isn't a node of the graph, the functions using its
+     *          slot (thunks and call ds:[imp] sites) stand for it
+     * @param out : Receives the sink functions
+     * @return The number of functions added to \out
+     */
+    static size_t
+    sink_by_name (
+        const char *name,
+        std::vector<ea_t> *out
+    );
+
+    void
+    clear (
+        void
+    );
+
+private:
+    typedef std::vector<uint64> bitset_t;
+
+    struct result_t
+    {
+        bitset_t reach;                 // one bit per component
+        std::vector<uint32> depth;      // per component, RCH_NO_PATH if it doesn't reach
+    };
+
+    typedef std::map<std::vector<ea_t>, result_t> memo_t;
+
+    CallGraphStore *store;
+    uint32 store_gen;       // generation of the graph the caches were built on
+    SccCondensation scc;
+    memo_t memo;
+    const result_t *current;
+
+    void
+    sync (
+        void
+    );
+
+    static bool test (const bitset_t &b, int i) { return (b[i >> 6] >> (i & 63)) & 1; }
+    static void set (bitset_t &b, int i) { b[i >> 6] |= (uint64) 1 << (i & 63); }
+};
@@ -0,0 +1,520 @@
+﻿/*
+    ██████╗ ███████╗ ██████╗██████╗ ██████╗ 
+    ██╔══██╗██╔════╝██╔════╝██╔══██╗██╔══██╗
+    ██████╔╝█████╗  ██║     ██████╔╝██████╔╝
+    ██╔══██╗██╔══╝  ██║     ██╔═══╝ ██╔═══╝ 
+    ██║  ██║███████╗╚██████╗██║     ██║     
+    ╚═╝  ╚═╝╚══════╝ ╚═════╝╚═╝     ╚═╝     
+* @license : <license placeholder>
+*/
+
+#include "ScanState.h"
+#include <algorithm>
+
+ScanState *ScanState::instance = NULL;
+
+
+ScanState::ScanState () {
+    memset (&this->header, 0, sizeof (this->header));
+    this->header.magic = SCAN_MAGIC;
+    this->header.version = SCAN_VERSION;
+    this->changed = false;
+}
+
+ScanState *
+ScanState::get (
+    void
+) {
+    if (instance == NULL) {
+        instance = new ScanState ();
+    }
+
+    return instance;
+}
+
+ScanState::~ScanState () {
+    MemStats::account (MEM_SCANNER, &this->memory, 0, 0);
+}
+
+void
+ScanState::update_memory (
+    void
+) {
+    size_t bytes = this->vtables.capacity () * sizeof (vtable_rec_t)
+                 + this->hashes.capacity () * sizeof (uint64)
+                 + this->spans.capacity () * sizeof (span_t);
+
+    MemStats::account (MEM_SCANNER, &this->memory, bytes, this->vtables.size ());
+}
+
+void
+ScanState::term (
+    void
+) {
+    delete instance;
+    instance = NULL;
+}
+
+// Same segments as VtableScanner::scan
+bool
+ScanState::get_bounds (
+    scan_header_t *h
+) {
+    segment_t *textSeg  = get_segm_by_name (".text");
+    segment_t *rdataSeg = get_segm_by_name (".rdata");
+
+    if (!textSeg || !rdataSeg) {
+        return false;
+    }
+
+    h->text_start  = textSeg->start_ea;
+    h->text_end    = textSeg->end_ea;
+    h->rdata_start = rdataSeg->start_ea;
+    h->rdata_end   = rdataSeg->end_ea;
+
+    return true;
+}
+
+bool
+ScanState::load (
+    void
+) {
+    netnode n (SCAN_NETNODE_NAME);
+    if (n == BADNODE) {
+        return false;
+    }
+
+    bytevec_t blob;
+    if (n.getblob (&blob, 0, SCAN_BLOB_TAG) < (ssize_t) sizeof (scan_header_t)) {
+        return false;
+    }
+
+    scan_header_t h;
+    memcpy (&h, blob.begin (), sizeof (h));
+
+    if (h.magic != SCAN_MAGIC || h.version != SCAN_VERSION
+     || blob.size () != sizeof (h) + (size_t) h.vtable_count * sizeof (vtable_rec_t)
+                                   + (size_t) h.range_count * sizeof (uint64)
+                                   + (size_t) h.span_count * sizeof (span_t)) {
+        msg ("RECPP: stored scan result is invalid or outdated, it will be redone.\n");
+        return false;
+    }
+
+    this->header = h;
+    this->vtables.resize (h.vtable_count);
+    if (h.vtable_count != 0) {
+        memcpy (&this->vtables[0], blob.begin () + sizeof (h), h.vtable_count * sizeof (vtable_rec_t));
+    }
+    this->hashes.resize (h.range_count);
+    if (h.range_count != 0) {
+        memcpy (&this->hashes[0], blob.begin () + sizeof (h) + h.vtable_count * sizeof (vtable_rec_t),
+                h.range_count * sizeof (uint64));
+    }
+    this->spans.resize (h.span_count);
+    if (h.span_count != 0) {
+        memcpy (&this->spans[0], blob.begin () + sizeof (h) + h.vtable_count * sizeof (vtable_rec_t)
+                                               + h.range_count * sizeof (uint64),
+                h.span_count * sizeof (span_t));
+    }
+    this->changed = false;
+    update_memory ();
+
+    // Segments moved or resized while the plugin wasn't there to see it
+    scan_header_t current;
+    if (!get_bounds (&current)
+     || current.text_start != h.text_start || current.text_end != h.text_end
+     || current.rdata_start != h.rdata_start || current.rdata_end != h.rdata_end
+     || !spans_match ()) {
+        invalidate ();
+    }
+
+    return true;
+}
+
+bool
+ScanState::save (
+    void
+) {
+    bytevec_t blob;
+    blob.append (&this->header, sizeof (this->header));
+    if (!this->vtables.empty ()) {
+        blob.append (&this->vtables[0], this->vtables.size () * sizeof (vtable_rec_t));
+    }
+    if (!this->hashes.empty ()) {
+        blob.append (&this->hashes[0], this->hashes.size () * sizeof (uint64));
+    }
+    if (!this->spans.empty ()) {
+        blob.append (&this->spans[0], this->spans.size () * sizeof (span_t));
+    }
+
+    netnode n (SCAN_NETNODE_NAME, 0, true);
+    n.delblob (0, SCAN_BLOB_TAG);
+
+    if (!n.setblob (blob.begin (), blob.size (), 0, SCAN_BLOB_TAG)) {
+        return false;
+    }
+
+    this->changed = false;
+    return true;
+}
+
+void
+ScanState::set_vtables (
+    const std::vector<Vtable *> &vtables
+) {
+    get_bounds (&this->header);
+
+    this->vtables.resize (vtables.size ());
+    for (size_t i = 0; i < vtables.size (); i++)
+    {
+        vtable_rec_t &rec = this->vtables[i];
+        rec.address  = vtables[i]->getAddress ();
+        rec.methods  = (uint32) vtables[i]->getMethodsCount ();
+        rec.reserved = 0;
+        rec.col      = get_dword ((ea_t) rec.address - 4);
+        rec.type     = get_dword ((ea_t) rec.col + 12);
+        rec.chd      = get_dword ((ea_t) rec.col + 16);
+    }
+
+    this->header.vtable_count = (uint32) vtables.size ();
+    update_memory ();
+}
+
+void
+ScanState::record (
+    const std::vector<Vtable *> &vtables
+) {
+    set_vtables (vtables);
+
+    // Hashed after the scan, which renames and retypes the segment
+    set_spans ();
+    hash_ranges (&this->hashes);
+    this->header.range_count = (uint32) this->hashes.size ();
+    update_memory ();
+
+    this->header.generation++;
+    this->header.valid = 1;
+    this->header.cursor = 0;
+
+    // Written right away, a scan is too expensive to lose to a crash
+    save ();
+}
+
+void
+ScanState::record_partial (
+    const std::vector<Vtable *> &vtables,
+    ea_t cursor
+) {
+    set_vtables (vtables);
+
+    this->header.valid = 0;
+    this->header.cursor = cursor;
+
+    save ();
+}
+
+void
+ScanState::invalidate (
+    void
+) {
+    if (this->header.valid || this->header.cursor) {
+        this->header.valid = 0;
+        this->header.cursor = 0;
+        this->changed = true;
+    }
+}
+
+void
+ScanState::mark_dirty (
+    ea_t ea
+) {
+    size_t r = range_of (ea);
+    if (r >= this->hashes.size ()) {
+        return;
+    }
+
+    // The stored hash won't match the content any more
+    this->hashes[r] = 0;
+    this->changed = true;
+    invalidate ();
+}
+
+bool
+ScanState::covers (
+    ea_t ea
+) const {
+    if (this->header.rdata_start == 0) {
+        return ea >= this->header.text_start && ea < this->header.text_end;
+    }
+
+    return ea >= this->header.rdata_start && ea < this->header.rdata_end;
+}
+
+bool
+ScanState::follows (
+    ea_t ea
+) const {
+    return range_of (ea) < this->hashes.size ();
+}
+
+void
+ScanState::restore (
+    std::vector<Vtable *> *out,
+    const std::vector<size_t> *which
+) const {
+    size_t count = which ? which->size () : this->vtables.size ();
+
+    for (size_t k = 0; k < count; k++)
+    {
+        size_t i = which ? (*which)[k] : k;
+
+        // The scan already named the vftable and its methods, the class name
+        // comes from there and the slots aren't walked again
+        qstring name = get_short_name ((ea_t) this->vtables[i].address);
+        out->push_back (new Vtable ((ea_t) this->vtables[i].address, name.begin (), this->vtables[i].methods, false));
+    }
+}
+
+void
+ScanState::get_scan_segment (
+    ea_t *start,
+    ea_t *end
+) const {
+    if (this->header.rdata_start == 0) {
+        *start = (ea_t) this->header.text_start;
+        *end   = (ea_t) this->header.text_end;
+    }
+    else {
+        *start = (ea_t) this->header.rdata_start;
+        *end   = (ea_t) this->header.rdata_end;
+    }
+}
+
+void
+ScanState::set_spans (
+    void
+) {
+    ea_t start, end;
+    get_scan_segment (&start, &end);
+
+    this->spans.clear ();
+    for (size_t i = 0; i < this->vtables.size (); i++)
+    {
+        const vtable_rec_t &rec = this->vtables[i];
+        ea_t rtti[] = { (ea_t) rec.col, (ea_t) rec.type, (ea_t) rec.chd };
+
+        for (size_t t = 0; t < qnumber (rtti); t++)
+        {
+            if (rtti[t] >= start && rtti[t] < end) {
+                continue;
+            }
+
+            segment_t *seg = getseg (rtti[t]);
+            if (seg == NULL) {
+                continue;
+            }
+
+            bool seen = false;
+            for (size_t s = 0; s < this->spans.size () && !seen; s++) {
+                seen = this->spans[s].start == seg->start_ea;
+            }
+
+            if (!seen) {
+                span_t span = { seg->start_ea, seg->end_ea, 0, 0 };
+                this->spans.push_back (span);
+            }
+        }
+    }
+
+    // The spans are hashed after the scanned segment, in address order
+    std::sort (this->spans.begin (), this->spans.end (),
+               [] (const span_t &a, const span_t &b) { return a.start < b.start; });
+
+    uint32 first = (uint32) ((end - start + SCAN_RANGE_SIZE - 1) / SCAN_RANGE_SIZE);
+    for (size_t s = 0; s < this->spans.size (); s++) {
+        this->spans[s].first_range = first;
+        first += (uint32) ((this->spans[s].end - this->spans[s].start + SCAN_RANGE_SIZE - 1) / SCAN_RANGE_SIZE);
+    }
+
+    this->header.span_count = (uint32) this->spans.size ();
+    update_memory ();
+}
+
+bool
+ScanState::spans_match (
+    void
+) const {
+    for (size_t s = 0; s < this->spans.size (); s++)
+    {
+        segment_t *seg = getseg ((ea_t) this->spans[s].start);
+        if (seg == NULL || seg->start_ea != this->spans[s].start || seg->end_ea != this->spans[s].end) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+size_t
+ScanState::range_of (
+    ea_t ea
+) const {
+    ea_t start, end;
+    get_scan_segment (&start, &end);
+
+    if (ea >= start && ea < end) {
+        return (size_t) ((ea - start) / SCAN_RANGE_SIZE);
+    }
+
+    for (size_t s = 0; s < this->spans.size (); s++)
+    {
+        const span_t &span = this->spans[s];
+        if (ea >= span.start && ea < span.end) {
+            return span.first_range + (size_t) ((ea - span.start) / SCAN_RANGE_SIZE);
+        }
+    }
+
+    return (size_t) -1;
+}
+
+void
+ScanState::hash_ranges (
+    std::vector<uint64> *out
+) const {
+    ea_t start, end;
+    get_scan_segment (&start, &end);
+
+    out->clear ();
+    hash_segment (start, end, out);
+
+    for (size_t s = 0; s < this->spans.size (); s++) {
+        hash_segment ((ea_t) this->spans[s].start, (ea_t) this->spans[s].end, out);
+    }
+}
+
+// FNV-1a over the bytes of every range, and over the flags the scan looks at
+// for every dword of it : xrefs, names and item kinds change with the
+// analysis even when the bytes don't
+void
+ScanState::hash_segment (
+    ea_t start,
+    ea_t end,
+    std::vector<uint64> *out
+) {
+    if (end <= start) {
+        return;
+    }
+
+    out->reserve (out->size () + (end - start + SCAN_RANGE_SIZE - 1) / SCAN_RANGE_SIZE);
+    uchar buf[SCAN_RANGE_SIZE];
+
+    for (ea_t from = start; from < end; from += SCAN_RANGE_SIZE)
+    {
+        ea_t to = std::min ((ea_t) (from + SCAN_RANGE_SIZE), end);
+        uint64 h = 0xCBF29CE484222325ULL;
+
+        ssize_t got = get_bytes (buf, to - from, from, GMB_READALL);
+        for (ssize_t i = 0; i < got; i++) {
+            h = (h ^ buf[i]) * 0x100000001B3ULL;
+        }
+
+        for (ea_t ea = from; ea < to; ea += 4) {
+            flags_t f = get_flags (ea) & (MS_CLS | FF_REF | FF_NAME | FF_LABL);
+            h = (h ^ f) * 0x100000001B3ULL;
+        }
+
+        out->push_back (h);
+    }
+}
+
+bool
+ScanState::plan_rescan (
+    ranges_t *rescan,
+    std::vector<size_t> *keep
+) const {
+    rescan->clear ();
+    keep->clear ();
+
+    if (this->header.generation == 0 || this->hashes.empty ()) {
+        return false;
+    }
+
+    scan_header_t current;
+    if (!get_bounds (&current)
+     || current.text_start != this->header.text_start || current.text_end != this->header.text_end
+     || current.rdata_start != this->header.rdata_start || current.rdata_end != this->header.rdata_end
+     || !spans_match ()) {
+        return false;
+    }
+
+    std::vector<uint64> now;
+    hash_ranges (&now);
+    if (now.size () != this->hashes.size ()) {
+        return false;
+    }
+
+    std::vector<bool> dirty (now.size (), false);
+    for (size_t r = 0; r < now.size (); r++) {
+        dirty[r] = now[r] != this->hashes[r];
+    }
+
+    // A vftable is stale when its table or one of its RTTI records changed,
+    // the range it starts in has to be walked again then
+    ea_t start, end;
+    get_scan_segment (&start, &end);
+
+    // Only the scanned segment is walked, the spans only make vftables stale
+    size_t scanned = (size_t) ((end - start + SCAN_RANGE_SIZE - 1) / SCAN_RANGE_SIZE);
+    std::vector<bool> walk (dirty.begin (), dirty.begin () + std::min (scanned, dirty.size ()));
+    for (size_t i = 0; i < this->vtables.size (); i++)
+    {
+        const vtable_rec_t &rec = this->vtables[i];
+        ea_t rtti[] = { (ea_t) rec.col, (ea_t) rec.type, (ea_t) rec.chd };
+
+        // The table, with the COL pointer in front of it and the slot after
+        // it, which a new function can turn into one more method
+        ea_t lo = std::max ((ea_t) rec.address - 4, start);
+        ea_t hi = std::min ((ea_t) (rec.address + rec.methods * 4 + 4), end) - 1;
+
+        bool stale = false;
+        for (size_t r = range_of (lo); r <= range_of (hi) && r < dirty.size (); r++) {
+            stale = stale || dirty[r];
+        }
+        for (size_t t = 0; t < qnumber (rtti); t++) {
+            size_t r = range_of (rtti[t]);
+            stale = stale || (r < dirty.size () && dirty[r]);
+        }
+
+        size_t first = range_of ((ea_t) rec.address);
+        if (stale && first < walk.size ()) {
+            walk[first] = true;
+        }
+    }
+
+    // Everything starting in a walked range is found again by the rescan
+    for (size_t i = 0; i < this->vtables.size (); i++) {
+        size_t first = range_of ((ea_t) this->vtables[i].address);
+        if (first >= walk.size () || !walk[first]) {
+            keep->push_back (i);
+        }
+    }
+
+    for (size_t r = 0; r < walk.size (); r++)
+    {
+        if (!walk[r]) {
+            continue;
+        }
+
+        ea_t from = start + (ea_t) r * SCAN_RANGE_SIZE;
+        ea_t to = std::min ((ea_t) (from + SCAN_RANGE_SIZE), end);
+
+        if (!rescan->empty () && rescan->back ().second == from) {
+            rescan->back ().second = to;
+        }
+        else {
+            rescan->push_back (std::make_pair (from, to));
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,268 @@
+﻿/*
+    ██████╗ ███████╗ ██████╗██████╗ ██████╗ 
+    ██╔══██╗██╔════╝██╔════╝██╔══██╗██╔══██╗
+    ██████╔╝█████╗  ██║     ██████╔╝██████╔╝
+    ██╔══██╗██╔══╝  ██║     ██╔═══╝ ██╔═══╝ 
+    ██║  ██║███████╗╚██████╗██║     ██║     
+    ╚═╝  ╚═╝╚══════╝ ╚═════╝╚═╝     ╚═╝     
+* @license : <license placeholder>
+*/
+
+#pragma once
+
+
+// ---------- Includes ------------
+#include "RECPP.h"
+#include "Vtable.h"
+#include "MemStats.h"
+#include <vector>
+
+// ---------- Defines -------------
+#define SCAN_NETNODE_NAME "$ RECPP scan"
+#define SCAN_BLOB_TAG     'S'
+#define SCAN_MAGIC        0x4E435352 // 'RSCN'
+#define SCAN_VERSION      4
+#define SCAN_RANGE_SIZE   0x1000 // granularity of the content hashes
+
+
+// ------ Class definition --------
+// Result of the last vftable scan of the database, kept in the IDB.
+//
+// The scan renames and retypes what it finds, so once it has run the
+// database already holds its result : only the list of vftables is kept
+// here, enough to rebuild the scanner objects without scanning again.
+//
+// Every completed scan gets a new generation. Changes to the scanned
+// segments clear the valid flag, the next scan request then does the work
+// again while the others reuse the stored result.
+//
+// A cancelled scan is kept too, with the address it stopped at, so that the
+// next scan resumes from there.
+//
+// The scanned segment is also cut in SCAN_RANGE_SIZE ranges, each with a
+// hash of its bytes and item flags as they were after the scan. Comparing
+// them with the current content tells which ranges changed, so that a
+// rescan only has to walk these and the ranges of the vftables whose table
+// or RTTI records lie in them. The other segments holding RTTI records
+// (type descriptors usually live in .data) are hashed the same way after
+// the scanned one.
+class ScanState
+{
+public:
+    struct scan_header_t
+    {
+        uint32 magic;
+        uint32 version;
+        uint32 generation;
+        uint32 valid;
+        uint32 vtable_count;
+        uint32 reserved;
+        uint64 text_start;  // segment bounds at scan time
+        uint64 text_end;
+        uint64 rdata_start;
+        uint64 rdata_end;
+        uint64 cursor;      // where a cancelled scan stopped, 0 otherwise
+        uint32 range_count; // content hashes following the vftables
+        uint32 span_count;  // RTTI segments following the hashes
+    };
+
+    struct vtable_rec_t
+    {
+        uint64 address;
+        uint32 methods;
+        uint32 reserved;
+        uint64 col;         // RTTI Complete Object Locator
+        uint64 type;        // its Type Descriptor
+        uint64 chd;         // and Class Hierarchy Descriptor
+    };
+
+    // A segment outside of the scanned one that holds RTTI records
+    struct span_t
+    {
+        uint64 start;
+        uint64 end;
+        uint32 first_range; // index of its first hash
+        uint32 reserved;
+    };
+
+    typedef std::vector<std::pair<ea_t, ea_t> > ranges_t;
+
+    static ScanState *
+    get (
+        void
+    );
+
+    static void
+    term (
+        void
+    );
+
+    /*
+     * @brief : Read the state stored in the IDB
+     * @return false if there is none, or if it doesn't match the current segments
+     */
+    bool
+    load (
+        void
+    );
+
+    /*
+     * @brief : Write the state to the IDB
+     */
+    bool
+    save (
+        void
+    );
+
+    /*
+     * @brief : Store the result of a completed scan, as a new generation
+     */
+    void
+    record (
+        const std::vector<Vtable *> &vtables
+    );
+
+    /*
+     * @brief : Store the result of a cancelled scan
+     * @param cursor : The address the scan will resume from
+     */
+    void
+    record_partial (
+        const std::vector<Vtable *> &vtables,
+        ea_t cursor
+    );
+
+    /*
+     * @brief : Flag the stored result as outdated, a partial scan is dropped
+     */
+    void
+    invalidate (
+        void
+    );
+
+    /*
+     * @brief : Something the hashes don't see changed at \ea (e.g. a slot target
+     *          became a function), the next rescan walks its range again
+     */
+    void
+    mark_dirty (
+        ea_t ea
+    );
+
+    /*
+     * @brief : Is \ea in the segment the scan walks for vftables ?
+     */
+    bool
+    covers (
+        ea_t ea
+    ) const;
+
+    /*
+     * @brief : Is \ea in a range the content hashes follow (the scanned
+     *          segment or one holding RTTI records) ?
+     */
+    bool
+    follows (
+        ea_t ea
+    ) const;
+
+    /*
+     * @brief : Rebuild the vftable objects of the stored result, without touching the database
+     */
+    void
+    restore (
+        std::vector<Vtable *> *out,
+        const std::vector<size_t> *which = NULL
+    ) const;
+
+    /*
+     * @brief : Compare the stored content hashes with the database
+     * @param rescan : Receives the ranges to scan again, merged and sorted
+     * @param keep : Receives the indexes of the stored vftables that are still valid
+     * @return false if there is nothing to compare with, a full scan is needed
+     */
+    bool
+    plan_rescan (
+        ranges_t *rescan,
+        std::vector<size_t> *keep
+    ) const;
+
+    bool is_valid () const { return this->header.valid != 0; }
+    bool is_partial () const { return this->header.valid == 0 && this->header.cursor != 0; }
+    ea_t get_cursor () const { return (ea_t) this->header.cursor; }
+    bool has_changes () const { return this->changed; }
+    uint32 generation () const { return this->header.generation; }
+    const std::vector<vtable_rec_t> &get_vtables () const { return this->vtables; }
+
+private:
+    ScanState ();
+    ~ScanState ();
+
+    static ScanState *instance;
+
+    scan_header_t header;
+    std::vector<vtable_rec_t> vtables;
+    std::vector<uint64> hashes; // one per range of the scanned segment, then of the spans
+    std::vector<span_t> spans;
+    bool changed;   // not saved yet
+
+    MemStats::held_t memory;
+
+    /*
+     * @brief : Report the current size of the containers to MemStats
+     */
+    void
+    update_memory (
+        void
+    );
+
+    void
+    get_scan_segment (
+        ea_t *start,
+        ea_t *end
+    ) const;
+
+    /*
+     * @brief : Find the segments other than the scanned one holding the RTTI
+     *          records of the stored vftables
+     */
+    void
+    set_spans (
+        void
+    );
+
+    /*
+     * @brief : Do the spans still match the segments of the database ?
+     */
+    bool
+    spans_match (
+        void
+    ) const;
+
+    void
+    hash_ranges (
+        std::vector<uint64> *out
+    ) const;
+
+    static void
+    hash_segment (
+        ea_t start,
+        ea_t end,
+        std::vector<uint64> *out
+    );
+
+    size_t
+    range_of (
+        ea_t ea
+    ) const;
+
+    static bool
+    get_bounds (
+        scan_header_t *h
+    );
+
+    void
+    set_vtables (
+        const std::vector<Vtable *> &vtables
+    );
+};
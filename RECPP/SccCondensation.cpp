@@ -0,0 +1,249 @@
+﻿/*
+    ██████╗ ███████╗ ██████╗██████╗ ██████╗ 
+    ██╔══██╗██╔════╝██╔════╝██╔══██╗██╔══██╗
+    ██████╔╝█████╗  ██║     ██████╔╝██████╔╝
+    ██╔══██╗██╔══╝  ██║     ██╔═══╝ ██╔═══╝ 
+    ██║  ██║███████╗╚██████╗██║     ██║     
+    ╚═╝  ╚═╝╚══════╝ ╚═════╝╚═╝     ╚═╝     
+* @license : <license placeholder>
+*/
+
+#include "SccCondensation.h"
+#include <algorithm>
+
+
+SccCondensation::SccCondensation () {
+    clear ();
+}
+
+void
+SccCondensation::clear (
+    void
+) {
+    this->comp.clear ();
+    this->comp_start.assign (1, 0);
+    this->comp_nodes.clear ();
+    this->dag_start.assign (1, 0);
+    this->dag_succ.clear ();
+    this->dag_pred_start.assign (1, 0);
+    this->dag_pred.clear ();
+    this->comp_level.clear ();
+    this->level_start.assign (1, 0);
+    this->level_comps.clear ();
+}
+
+void
+SccCondensation::compute (
+    int nodeCount,
+    const std::vector<int> &succStart,
+    const std::vector<int> &succ
+) {
+    clear ();
+
+    if (nodeCount <= 0) {
+        return;
+    }
+
+    // Iterative Tarjan : call graphs are deep enough to blow the stack
+    // with the recursive version
+    std::vector<int> index (nodeCount, -1);
+    std::vector<int> lowlink (nodeCount, 0);
+    std::vector<bool> onStack (nodeCount, false);
+    std::vector<int> stack;
+    std::vector<std::pair<int, int> > callStack; // (node, next successor offset)
+    int counter = 0;
+
+    this->comp.assign (nodeCount, -1);
+    this->comp_start.clear ();
+
+    for (int root = 0; root < nodeCount; root++)
+    {
+        if (index[root] != -1) {
+            continue;
+        }
+
+        callStack.push_back (std::make_pair (root, succStart[root]));
+        index[root] = lowlink[root] = counter++;
+        stack.push_back (root);
+        onStack[root] = true;
+
+        while (!callStack.empty ())
+        {
+            int v = callStack.back ().first;
+            int &it = callStack.back ().second;
+
+            if (it < succStart[v + 1]) {
+                int w = succ[it++];
+
+                if (index[w] == -1) {
+                    index[w] = lowlink[w] = counter++;
+                    stack.push_back (w);
+                    onStack[w] = true;
+                    callStack.push_back (std::make_pair (w, succStart[w]));
+                }
+                else if (onStack[w]) {
+                    lowlink[v] = std::min (lowlink[v], index[w]);
+                }
+                continue;
+            }
+
+            // All successors done, v is the root of a component ?
+            if (lowlink[v] == index[v]) {
+                int c = (int) this->comp_start.size ();
+                this->comp_start.push_back ((int) this->comp_nodes.size ());
+
+                int w;
+                do {
+                    w = stack.back ();
+                    stack.pop_back ();
+                    onStack[w] = false;
+                    this->comp[w] = c;
+                    this->comp_nodes.push_back (w);
+                } while (w != v);
+            }
+
+            callStack.pop_back ();
+            if (!callStack.empty ()) {
+                int u = callStack.back ().first;
+                lowlink[u] = std::min (lowlink[u], lowlink[v]);
+            }
+        }
+    }
+
+    int compCount = (int) this->comp_start.size ();
+    this->comp_start.push_back ((int) this->comp_nodes.size ());
+
+    // Condensation DAG, without self loops nor duplicate edges
+    std::vector<int> mark (compCount, -1);
+    this->dag_start.clear ();
+    this->dag_start.reserve (compCount + 1);
+    std::vector<int> predCount (compCount, 0);
+
+    for (int c = 0; c < compCount; c++)
+    {
+        this->dag_start.push_back ((int) this->dag_succ.size ());
+
+        for (const int *n = comp_begin (c); n != comp_end (c); n++) {
+            for (int k = succStart[*n]; k < succStart[*n + 1]; k++) {
+                int d = this->comp[succ[k]];
+
+                if (d != c && mark[d] != c) {
+                    mark[d] = c;
+                    this->dag_succ.push_back (d);
+                    predCount[d]++;
+                }
+            }
+        }
+    }
+    this->dag_start.push_back ((int) this->dag_succ.size ());
+
+    // Reverse DAG, used to find the callers of dirty components
+    this->dag_pred_start.assign (compCount + 1, 0);
+    for (int c = 0; c < compCount; c++) {
+        this->dag_pred_start[c + 1] = this->dag_pred_start[c] + predCount[c];
+    }
+
+    this->dag_pred.resize (this->dag_succ.size ());
+    std::vector<int> fill (this->dag_pred_start.begin (), this->dag_pred_start.end () - 1);
+    for (int c = 0; c < compCount; c++) {
+        for (const int *d = dag_begin (c); d != dag_end (c); d++) {
+            this->dag_pred[fill[*d]++] = c;
+        }
+    }
+
+    // Tarjan emits a component after all the components it reaches, so
+    // successors always have a smaller id and one pass is enough
+    this->comp_level.assign (compCount, 0);
+    int levelCount = 0;
+
+    for (int c = 0; c < compCount; c++)
+    {
+        int level = 0;
+        for (const int *d = dag_begin (c); d != dag_end (c); d++) {
+            level = std::max (level, this->comp_level[*d] + 1);
+        }
+
+        this->comp_level[c] = level;
+        levelCount = std::max (levelCount, level + 1);
+    }
+
+    // Bucket the components by level
+    this->level_start.assign (levelCount + 1, 0);
+    for (int c = 0; c < compCount; c++) {
+        this->level_start[this->comp_level[c] + 1]++;
+    }
+    for (int l = 0; l < levelCount; l++) {
+        this->level_start[l + 1] += this->level_start[l];
+    }
+
+    this->level_comps.resize (compCount);
+    fill.assign (this->level_start.begin (), this->level_start.end () - 1);
+    for (int c = 0; c < compCount; c++) {
+        this->level_comps[fill[this->comp_level[c]]++] = c;
+    }
+}
+
+void
+SccCondensation::dirty_closure (
+    const std::vector<int> &nodes,
+    std::vector<bool> *dirty
+) const {
+    dirty->assign (comp_count (), false);
+
+    std::vector<int> queue;
+    for (size_t i = 0; i < nodes.size (); i++)
+    {
+        if (nodes[i] < 0 || nodes[i] >= (int) this->comp.size ()) {
+            continue;
+        }
+
+        int c = this->comp[nodes[i]];
+        if (!(*dirty)[c]) {
+            (*dirty)[c] = true;
+            queue.push_back (c);
+        }
+    }
+
+    // Everything that calls into a changed component has to be redone
+    while (!queue.empty ())
+    {
+        int c = queue.back ();
+        queue.pop_back ();
+
+        for (int k = this->dag_pred_start[c]; k < this->dag_pred_start[c + 1]; k++) {
+            int p = this->dag_pred[k];
+            if (!(*dirty)[p]) {
+                (*dirty)[p] = true;
+                queue.push_back (p);
+            }
+        }
+    }
+}
+
+void
+SccCondensation::for_each_level (
+    batch_cb_t cb,
+    void *ud,
+    const std::vector<bool> *dirty
+) const {
+    std::vector<int> batch;
+
+    for (int l = 0; l < level_count (); l++)
+    {
+        if (dirty == NULL) {
+            cb (ud, l, level_begin (l), level_end (l) - level_begin (l));
+            continue;
+        }
+
+        batch.clear ();
+        for (const int *c = level_begin (l); c != level_end (l); c++) {
+            if ((*dirty)[*c]) {
+                batch.push_back (*c);
+            }
+        }
+
+        if (!batch.empty ()) {
+            cb (ud, l, &batch[0], batch.size ());
+        }
+    }
+}
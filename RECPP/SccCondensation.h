@@ -0,0 +1,141 @@
+﻿/*
+    ██████╗ ███████╗ ██████╗██████╗ ██████╗ 
+    ██╔══██╗██╔════╝██╔════╝██╔══██╗██╔══██╗
+    ██████╔╝█████╗  ██║     ██████╔╝██████╔╝
+    ██╔══██╗██╔══╝  ██║     ██╔═══╝ ██╔═══╝ 
+    ██║  ██║███████╗╚██████╗██║     ██║     
+    ╚═╝  ╚═╝╚══════╝ ╚═════╝╚═╝     ╚═╝     
+* @license : <license placeholder>
+*/
+
+#pragma once
+
+
+// ---------- Includes ------------
+#include "RECPP.h"
+#include "ParallelFor.h"
+#include <vector>
+
+// ---------- Defines -------------
+
+
+// ------ Class definition --------
+// Strongly connected components of a directed graph given in CSR form
+// (successors of node n are succ[succ_start[n] .. succ_start[n + 1]]).
+//
+// Components are numbered in reverse topological order : a component only
+// has edges to components with a smaller id, so walking the ids upwards
+// visits callees before callers. They are also grouped by level, level 0
+// holding the components without any successor and level k the components
+// whose deepest successor is at level k - 1. Components of one level never
+// depend on each other and can be processed as a single batch.
+class SccCondensation
+{
+public:
+    SccCondensation ();
+
+    void
+    clear (
+        void
+    );
+
+    /*
+     * @brief : Compute the components (iterative Tarjan), the condensation DAG and its levels
+     * @param nodeCount : Number of nodes
+     * @param succStart : nodeCount + 1 offsets into \succ
+     * @param succ : Successor lists
+     */
+    void
+    compute (
+        int nodeCount,
+        const std::vector<int> &succStart,
+        const std::vector<int> &succ
+    );
+
+    int comp_count () const { return (int) this->comp_start.size () - 1; }
+    int level_count () const { return (int) this->level_start.size () - 1; }
+    int comp_of (int node) const { return this->comp[node]; }
+    int level_of_comp (int c) const { return this->comp_level[c]; }
+
+    // Nodes of component c
+    const int *comp_begin (int c) const { return this->comp_nodes.data () + this->comp_start[c]; }
+    const int *comp_end (int c) const { return this->comp_nodes.data () + this->comp_start[c + 1]; }
+
+    // Successor components of component c in the condensation DAG
+    const int *dag_begin (int c) const { return this->dag_succ.data () + this->dag_start[c]; }
+    const int *dag_end (int c) const { return this->dag_succ.data () + this->dag_start[c + 1]; }
+
+    // Predecessor components of component c in the condensation DAG
+    const int *pred_begin (int c) const { return this->dag_pred.data () + this->dag_pred_start[c]; }
+    const int *pred_end (int c) const { return this->dag_pred.data () + this->dag_pred_start[c + 1]; }
+
+    // Components of level l
+    const int *level_begin (int l) const { return this->level_comps.data () + this->level_start[l]; }
+    const int *level_end (int l) const { return this->level_comps.data () + this->level_start[l + 1]; }
+
+    /*
+     * @brief : Get the components affected by a change of some nodes, i.e. the
+     *          components of these nodes and everything that transitively reaches them
+     * @param nodes : The changed nodes
+     * @param dirty : Receives one flag per component
+     */
+    void
+    dirty_closure (
+        const std::vector<int> &nodes,
+        std::vector<bool> *dirty
+    ) const;
+
+    // Bottom-up batch callback : the components of one level, callees first
+    typedef void (idaapi *batch_cb_t) (void *ud, int level, const int *comps, size_t count);
+
+    /*
+     * @brief : Hand every level to \cb, from the leaves to the roots
+     * @param dirty : When not NULL, only the flagged components are dispatched
+     */
+    void
+    for_each_level (
+        batch_cb_t cb,
+        void *ud,
+        const std::vector<bool> *dirty = NULL
+    ) const;
+
+    /*
+     * @brief : Call task (c) on every component, callees first. The components
+     *          of a level run in parallel : task must not call into the SDK
+     * @param dirty : When not NULL, only the flagged components are run
+     */
+    template <typename Fn>
+    void
+    run_bottom_up (
+        Fn task,
+        const std::vector<bool> *dirty = NULL
+    ) const {
+        for_each_level (bottom_up_batch<Fn>, &task, dirty);
+    }
+
+private:
+    template <typename Fn>
+    static void idaapi
+    bottom_up_batch (
+        void *ud,
+        int level,
+        const int *comps,
+        size_t count
+    ) {
+        Fn &task = *(Fn *) ud;
+        parallel_for (count, [&] (size_t i) {
+            task (comps[i]);
+        });
+    }
+
+    std::vector<int> comp;         // node -> component
+    std::vector<int> comp_start;   // component -> range in comp_nodes
+    std::vector<int> comp_nodes;
+    std::vector<int> dag_start;    // component -> range in dag_succ
+    std::vector<int> dag_succ;
+    std::vector<int> dag_pred_start;
+    std::vector<int> dag_pred;
+    std::vector<int> comp_level;   // component -> level
+    std::vector<int> level_start;  // level -> range in level_comps
+    std::vector<int> level_comps;
+};
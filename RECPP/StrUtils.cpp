@@ -0,0 +1,206 @@
+﻿/*
+    ██████╗ ███████╗ ██████╗██████╗ ██████╗ 
+    ██╔══██╗██╔════╝██╔════╝██╔══██╗██╔══██╗
+    ██████╔╝█████╗  ██║     ██████╔╝██████╔╝
+    ██╔══██╗██╔══╝  ██║     ██╔═══╝ ██╔═══╝ 
+    ██║  ██║███████╗╚██████╗██║     ██║     
+    ╚═╝  ╚═╝╚══════╝ ╚═════╝╚═╝     ╚═╝     
+* @license : <license placeholder>
+*/
+
+#include "StrUtils.h"
+#include <string.h>
+
+
+int
+str_find (
+    const char *str,
+    size_t len,
+    const char *search
+) {
+    size_t searchLen = strlen (search);
+    if (searchLen == 0 || searchLen > len) {
+        return -1;
+    }
+
+    // memchr finds the candidates, memcmp confirms them
+    const char *end = str + len - searchLen + 1;
+    for (const char *p = str; p < end; p++)
+    {
+        p = (const char *) memchr (p, search[0], end - p);
+        if (p == NULL) {
+            break;
+        }
+
+        if (memcmp (p + 1, search + 1, searchLen - 1) == 0) {
+            return (int) (p - str);
+        }
+    }
+
+    return -1;
+}
+
+char *
+mangle_number (
+    int number,
+    char *buffer,
+    size_t bufferSize
+) {
+    if (bufferSize < MANGLED_NUMBER_SIZE) {
+        if (bufferSize != 0) {
+            buffer[0] = '\0';
+        }
+        return buffer;
+    }
+
+    char *p = buffer;
+    uint32_t value = (uint32_t) number;
+
+    if (number < 0) {
+        *p++ = '?';
+        value = 0 - value;
+    }
+
+    if (value == 0) {
+        memcpy (buffer, "A@", 3);
+        return buffer;
+    }
+
+    if (value <= 10) {
+        *p++ = (char) ('0' + value - 1);
+        *p = '\0';
+        return buffer;
+    }
+
+    // Most significant digit first, no leading zero
+    char digits[8];
+    int count = 0;
+    for (; value != 0; value >>= 4) {
+        digits[count++] = (char) ('A' + (value & 0xF));
+    }
+
+    while (count > 0) {
+        *p++ = digits[--count];
+    }
+
+    *p++ = '@';
+    *p = '\0';
+
+    return buffer;
+}
+
+void
+sanitize_name (
+    char *name
+) {
+    for (; *name != '\0'; name++)
+    {
+        switch (*name)
+        {
+        case '<': case '>': case ' ': case ',':
+        case '*': case '`': case '\'':
+            *name = '_';
+            break;
+        }
+    }
+}
+
+static int
+hex_digit (
+    char c
+) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+
+    return -1;
+}
+
+bool
+match_pattern (
+    const uint8_t *bytes,
+    const char *pattern
+) {
+    for (; pattern[0] != '\0' && pattern[1] != '\0'; pattern += 2, bytes++)
+    {
+        if (pattern[0] == '?' && pattern[1] == '?') {
+            continue;
+        }
+
+        int hi = hex_digit (pattern[0]);
+        int lo = hex_digit (pattern[1]);
+
+        if (hi < 0 || lo < 0 || *bytes != (uint8_t) (hi << 4 | lo)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool
+match_bytes (
+    bytes_reader_t readBytes,
+    byte_reader_t readByte,
+    void *ud,
+    uint32_t address,
+    const char *pattern
+) {
+    size_t len = strlen (pattern);
+    if (len % 2 || len / 2 > PATTERN_MAX_BYTES) {
+        return false;
+    }
+
+    // One read for the whole pattern
+    uint8_t bytes[PATTERN_MAX_BYTES];
+    size_t size = len / 2;
+
+    if (readBytes (ud, bytes, size, address) != (int) size) {
+        for (size_t i = 0; i < size; i++) {
+            bytes[i] = readByte (ud, address + (uint32_t) i);
+        }
+    }
+
+    return match_pattern (bytes, pattern);
+}
+
+char *
+get_asciiz_str (
+    bytes_reader_t readBytes,
+    byte_reader_t readByte,
+    void *ud,
+    uint32_t address,
+    char *buffer,
+    size_t bufferSize
+) {
+    size_t bufferPos = 0;
+
+    // Read by chunks rather than byte by byte, type names are a few dozen chars
+    while (bufferPos + 1 < bufferSize)
+    {
+        size_t chunk = bufferSize - 1 - bufferPos;
+        if (chunk > ASCIIZ_CHUNK) {
+            chunk = ASCIIZ_CHUNK;
+        }
+
+        int got = readBytes (ud, (uint8_t *) &buffer[bufferPos], chunk, address);
+        if (got <= 0) {
+            // Byte without value : the byte reader decides
+            buffer[bufferPos] = (char) readByte (ud, address);
+            got = 1;
+        }
+
+        if (memchr (&buffer[bufferPos], '\0', got) != NULL) {
+            return buffer;
+        }
+
+        bufferPos += got;
+        address += got;
+    }
+
+    return NULL;
+}
@@ -0,0 +1,106 @@
+﻿/*
+    ██████╗ ███████╗ ██████╗██████╗ ██████╗ 
+    ██╔══██╗██╔════╝██╔════╝██╔══██╗██╔══██╗
+    ██████╔╝█████╗  ██║     ██████╔╝██████╔╝
+    ██╔══██╗██╔══╝  ██║     ██╔═══╝ ██╔═══╝ 
+    ██║  ██║███████╗╚██████╗██║     ██║     
+    ╚═╝  ╚═╝╚══════╝ ╚═════╝╚═╝     ╚═╝     
+* @license : <license placeholder>
+*/
+
+#pragma once
+
+
+// ---------- Includes ------------
+#include <stddef.h>
+#include <stdint.h>
+
+// ---------- Defines -------------
+#define PATTERN_MAX_BYTES   128     // longest pattern matchBytes reads at once
+#define MANGLED_NUMBER_SIZE 12      // ? + 8 digits + @ + NUL, rounded
+#define ASCIIZ_CHUNK        64      // bytes read at once by get_asciiz_str
+
+
+// ------ Function definition --------
+// String and byte pattern primitives behind IDAUtils and Vtable, kept free
+// of the SDK so that RECPPBench can measure them and check them against
+// the implementations they replaced.
+
+// Image reads, the kernel in the plugin and a memory image in the bench.
+// byte_reader_t reads one byte like get_byte, bytes_reader_t a block like
+// get_bytes and returns the number of bytes read, <= 0 on failure.
+typedef uint8_t (*byte_reader_t) (void *ud, uint32_t address);
+typedef int (*bytes_reader_t) (void *ud, uint8_t *buffer, size_t size, uint32_t address);
+
+/*
+ * @brief : Position of the first occurrence of \search in the \len first chars of \str
+ * @return The position, or -1 if \search is not there
+ */
+int
+str_find (
+    const char *str,
+    size_t len,
+    const char *search
+);
+
+/*
+ * @brief : Encode a number the way MSVC decorated names do :
+ *          0 -> A@, 1..10 -> 0..9, else hex digits A..P ended by @,
+ *          prefixed by ? when negative
+ * @param bufferSize : At least MANGLED_NUMBER_SIZE, the result is empty otherwise
+ * @return \buffer
+ */
+char *
+mangle_number (
+    int number,
+    char *buffer,
+    size_t bufferSize
+);
+
+/*
+ * @brief : Replace in place the characters IDA refuses in names < > , * ` ' and space by '_'
+ */
+void
+sanitize_name (
+    char *name
+);
+
+/*
+ * @brief : Match bytes against a pattern of hex pairs such as "8BFF??E8",
+ *          ?? matching any byte. Hex digits are upper case.
+ * @param bytes : At least strlen (pattern) / 2 bytes
+ */
+bool
+match_pattern (
+    const uint8_t *bytes,
+    const char *pattern
+);
+
+/*
+ * @brief : match_pattern on the bytes at \address, read at once, or byte by
+ *          byte when the block read fails
+ * @return false if the pattern is longer than PATTERN_MAX_BYTES
+ */
+bool
+match_bytes (
+    bytes_reader_t readBytes,
+    byte_reader_t readByte,
+    void *ud,
+    uint32_t address,
+    const char *pattern
+);
+
+/*
+ * @brief : Read the NUL terminated string at \address by chunks of ASCIIZ_CHUNK,
+ *          a byte without value is read by \readByte
+ * @return \buffer, or NULL if the string does not fit in \bufferSize
+ */
+char *
+get_asciiz_str (
+    bytes_reader_t readBytes,
+    byte_reader_t readByte,
+    void *ud,
+    uint32_t address,
+    char *buffer,
+    size_t bufferSize
+);
@@ -0,0 +1,172 @@
+﻿/*
+    ██████╗ ███████╗ ██████╗██████╗ ██████╗ 
+    ██╔══██╗██╔════╝██╔════╝██╔══██╗██╔══██╗
+    ██████╔╝█████╗  ██║     ██████╔╝██████╔╝
+    ██╔══██╗██╔══╝  ██║     ██╔═══╝ ██╔═══╝ 
+    ██║  ██║███████╗╚██████╗██║     ██║     
+    ╚═╝  ╚═╝╚══════╝ ╚═════╝╚═╝     ╚═╝     
+* @license : <license placeholder>
+*/
+
+#include "TypeBatch.h"
+#include "Profiler.h"
+#include "IDACalls.h"
+
+
+TypeBatch::TypeBatch () {
+}
+
+TypeBatch::~TypeBatch () {
+    MemStats::account (MEM_SCANNER, &this->memory, 0, 0);
+}
+
+void
+TypeBatch::clear (
+    void
+) {
+    this->vtables.clear ();
+    MemStats::account (MEM_SCANNER, &this->memory, 0, 0);
+}
+
+void
+TypeBatch::add_vtable (
+    ea_t vtable,
+    size_t methodsCount,
+    const char *className
+) {
+    if (className == NULL || className[0] == '\0') {
+        return;
+    }
+
+    vtable_t v;
+    v.address = vtable;
+    v.methods = methodsCount;
+    v.name.sprnt ("%s_vtable", className);
+    this->vtables.push_back (v);
+
+    MemStats::account (MEM_SCANNER, &this->memory,
+                       this->vtables.capacity () * sizeof (vtable_t), this->vtables.size ());
+}
+
+void
+TypeBatch::unique_name (
+    std::set<qstring> *used,
+    qstring *name,
+    uint32 offset
+) {
+    if (used->insert (*name).second) {
+        return;
+    }
+
+    qstring candidate;
+    for (int suffix = 1; suffix <= TYPEBATCH_MAX_SUFFIX; suffix++)
+    {
+        candidate.sprnt ("%s_%d", name->c_str (), suffix);
+        if (used->insert (candidate).second) {
+            name->swap (candidate);
+            return;
+        }
+    }
+
+    name->sprnt ("field_%X", offset);
+    used->insert (*name);
+}
+
+bool
+TypeBatch::build (
+    const vtable_t &vtable,
+    tinfo_t *out
+) {
+    udt_type_data_t udt;
+    std::set<qstring> used;
+    qstring name;
+    size_t lastNamed = 0;
+    bool named = false;
+
+    for (size_t i = 0; i < vtable.methods; i++)
+    {
+        ea_t method = IDA_CALL (GET_DWORD, get_dword (vtable.address + i * 4));
+
+        name.clear ();
+        if (method != 0) {
+            IDA_CALL (GET_NAME, get_name (&name, method));
+        }
+
+        // Slots without a name are kept as plain dwords, so that the
+        // named ones stay at their offset
+        if (name.empty ()) {
+            name.sprnt ("field_%X", (uint32) (i * 4));
+        }
+        else {
+            lastNamed = i;
+            named = true;
+        }
+
+        unique_name (&used, &name, (uint32) (i * 4));
+
+        udt_member_t member;
+        member.offset = (uint64) i * 4 * 8;
+        member.size = 4 * 8;
+        member.name = name;
+        member.type = tinfo_t (BTF_UINT32);
+        udt.push_back (member);
+    }
+
+    if (!named) {
+        return false;
+    }
+
+    // The structure ends with the last named slot
+    udt.resize (lastNamed + 1);
+    udt.total_size = (lastNamed + 1) * 4;
+    udt.pack = 1;
+
+    return out->create_udt (udt, BTF_STRUCT);
+}
+
+size_t
+TypeBatch::commit (
+    void
+) {
+    PROFILE_SCOPE ("TypeBatch::commit");
+
+    til_t *til = (til_t *) get_idati ();
+    std::set<qstring> seen;
+    std::vector<const qstring *> created;
+    tinfo_t tif;
+
+    // Everything is built in memory first, types that already exist are
+    // left alone as the user may have edited them
+    for (size_t i = 0; i < this->vtables.size (); i++)
+    {
+        const vtable_t &v = this->vtables[i];
+
+        if (!seen.insert (v.name).second) {
+            continue;
+        }
+
+        if (get_struc_id (v.name.c_str ()) != BADADDR || tif.get_named_type (til, v.name.c_str ())) {
+            continue;
+        }
+
+        if (!build (v, &tif)) {
+            continue;
+        }
+
+        if (tif.set_named_type (til, v.name.c_str ()) != TERR_OK) {
+            msg ("Could not create the vtable structure %s !\n", v.name.c_str ());
+            continue;
+        }
+
+        created.push_back (&v.name);
+    }
+
+    // Then shown in the structures view, as the scan always did
+    for (size_t i = 0; i < created.size (); i++) {
+        import_type (til, -1, created[i]->c_str ());
+    }
+
+    clear ();
+
+    return created.size ();
+}
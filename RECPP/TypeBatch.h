@@ -0,0 +1,96 @@
+﻿/*
+    ██████╗ ███████╗ ██████╗██████╗ ██████╗ 
+    ██╔══██╗██╔════╝██╔════╝██╔══██╗██╔══██╗
+    ██████╔╝█████╗  ██║     ██████╔╝██████╔╝
+    ██╔══██╗██╔══╝  ██║     ██╔═══╝ ██╔═══╝ 
+    ██║  ██║███████╗╚██████╗██║     ██║     
+    ╚═╝  ╚═╝╚══════╝ ╚═════╝╚═╝     ╚═╝     
+* @license : <license placeholder>
+*/
+
+#pragma once
+
+
+// ---------- Includes ------------
+#include "RECPP.h"
+#include "MemStats.h"
+#include <vector>
+#include <set>
+
+// ---------- Defines -------------
+#define TYPEBATCH_MAX_SUFFIX 1000
+
+
+// ------ Class definition --------
+// Vftable structures of a scan, created together at the end of it.
+//
+// The scan only queues the vftables. On commit the slot names are read, the
+// member names made unique in memory (first one wins, the next ones get _1,
+// _2, ...), and every structure is built as a tinfo_t and stored in the
+// local types in one pass. They are then imported in the structures view,
+// so each type costs two database calls instead of one or more per slot.
+class TypeBatch
+{
+public:
+    TypeBatch ();
+    ~TypeBatch ();
+
+    void
+    clear (
+        void
+    );
+
+    /*
+     * @brief : Queue the "<class>_vtable" structure of a vftable
+     */
+    void
+    add_vtable (
+        ea_t vtable,
+        size_t methodsCount,
+        const char *className
+    );
+
+    /*
+     * @brief : Create every queued structure that doesn't exist yet, and empty the batch
+     * @return The number of structures created
+     */
+    size_t
+    commit (
+        void
+    );
+
+    size_t size () const { return this->vtables.size (); }
+
+private:
+    struct vtable_t
+    {
+        ea_t address;
+        size_t methods;
+        qstring name;       // structure name
+    };
+
+    std::vector<vtable_t> vtables;
+
+    MemStats::held_t memory;
+
+    /*
+     * @brief : Build the structure of a vftable
+     * @return false if no slot has a name
+     */
+    static bool
+    build (
+        const vtable_t &vtable,
+        tinfo_t *out
+    );
+
+    /*
+     * @brief : Make \name unique among \used, and add it. Past TYPEBATCH_MAX_SUFFIX
+     *          collisions the slot is named after its offset
+     */
+    static void
+    unique_name (
+        std::set<qstring> *used,
+        qstring *name,
+        uint32 offset
+    );
+};
@@ -13,9 +13,17 @@
 // ---------- Includes ------------
 #include "VtableScanner.h"
 #include "CompleteObjectLocator.h"
+#include "Profiler.h"
+#include "IDACalls.h"
+#include "FuncIndex.h"
+#include <algorithm>
 
 VtableScanner::VtableScanner (DecMap *decMap) {
     this->decMap = decMap;
+    this->rMin = this->rMax = this->cMin = this->cMax = 0;
+    this->range = 0;
+    this->cursor = BADADDR;
+    this->incremental = false;
 }
 
 VtableScanner::~VtableScanner () {
@@ -50,10 +58,10 @@ VtableScanner::getVtableMethodsCount (
             break;
         }
         
-        if ((curEntry = get_dword (curAddress))) {
+        if ((curEntry = IDAUtils::Dword (curAddress))) {
             flags = IDAUtils::GetFlags (curEntry);
             
-            if (!has_value(flags) || !is_code(flags) || get_dword (curEntry) == 0) {
+            if (!has_value(flags) || !is_code(flags) || IDAUtils::Dword (curEntry) == 0) {
                 break;
             }
         }
@@ -74,14 +82,22 @@ ea_t
 VtableScanner::checkVtable (
     ea_t address
 ) {
-    size_t vtableMethodsCount = getVtableMethodsCount (address);
+    size_t vtableMethodsCount;
     ea_t endTable;
     ea_t p;
+
+    {
+        PROFILE_SCOPE ("getVtableMethodsCount");
+        vtableMethodsCount = getVtableMethodsCount (address);
+    }
 
     if (!vtableMethodsCount) {
         // No vtable found at this address, return the next address
         return address + 4;
     }
+
+    ScopedPhase phase ("checkVtable");
+    phase.add_items (1);
     
     // Check if it's named as a vtable
     char bufName [4096];
@@ -90,13 +106,20 @@ VtableScanner::checkVtable (
         name = NULL;
     }
     
-    endTable = get_dword (address - 4);
+    endTable = IDAUtils::Dword (address - 4);
     
     char buffer[4096] = {0};
-    if (CompleteObjectLocator::isValid (endTable)) {
+    bool validCol;
+    {
+        PROFILE_SCOPE ("validateCOL");
+        validCol = CompleteObjectLocator::isValid (endTable);
+    }
+
+    if (validCol) {
         Vtable *vtable = Vtable::parse (address, vtableMethodsCount);
         if (vtable) {
             this->vtables.push_back (vtable);
+            this->types.add_vtable (address, vtableMethodsCount, vtable->getName ());
         }
         
         if (name == NULL) {
@@ -104,8 +127,9 @@ VtableScanner::checkVtable (
         }
 
         // only output object tree for main vtable
-        if (get_dword (endTable + 4) == 0) {
-            CRTTIClassHierarchyDescriptor::parse2 (get_dword (endTable + 16));
+        if (IDAUtils::Dword (endTable + 4) == 0) {
+            PROFILE_SCOPE ("hierarchy");
+            CRTTIClassHierarchyDescriptor::parse2 (IDAUtils::Dword (endTable + 16));
         }
 
         IDAUtils::MakeName (address, name);
@@ -120,56 +144,106 @@ VtableScanner::checkVtable (
         name = buffer2;
     }
     
-    IDAUtils::DeleteArray (IDAUtils::GetArrayId ("AddrList"));
-    int q = 0; int i = 1;
+    // The constructor is named once every vftable is known, by resolveWriters
+    pending_t pend;
+    pend.address = address;
+    if (name != NULL) {
+        pend.name = name;
+    }
+    this->pending.push_back (pend);
+
+    endTable = address;
 
-    for (endTable = IDAUtils::DfirstB (address); endTable != BADADDR; endTable = IDAUtils::DnextB (address, endTable))
     {
-        p = Vtable::getFuncStart (endTable);
+        ScopedPhase slots ("slots");
+        slots.add_items (vtableMethodsCount);
 
-        if (p != BADADDR)
+        while (vtableMethodsCount > 0)
         {
-            if (q == p) {
-                i++;
-            }
-
-            else {           
-                if (q) {
-                    IDAUtils::AddAddr(q);
-                }
-                i = 1;
-                q = p;
+            p = IDAUtils::Dword (endTable);
+            if (IDAUtils::GetFunctionFlags(p) == -1) {
+                PROFILE_SCOPE ("makeFunction");
+                IDAUtils::MakeCode(p);
+                IDAUtils::MakeFunction (p, BADADDR);
             }
+            
+            Vtable::checkSDD (p, name, address, 0);
+            vtableMethodsCount--;
+            endTable += 4;
         }
     }
-    if (q) {
-        IDAUtils::AddAddr(q);
+
+    return endTable;
+}
+
+void
+VtableScanner::resolveWriters (
+    void
+) {
+    if (this->pending.empty ()) {
+        return;
     }
-    
-    endTable = address;
 
-    while (vtableMethodsCount > 0)
+    std::vector<ea_t> addresses;
+    addresses.reserve (this->pending.size ());
+    for (size_t i = 0; i < this->pending.size (); i++) {
+        addresses.push_back (this->pending[i].address);
+    }
+
+    {
+        ScopedPhase phase ("writers");
+        phase.add_items (addresses.size ());
+        this->writers.build (addresses);
+    }
+
+    // The destructors were named by checkSDD, doAddrList tells them apart.
+    // The writers come out sorted and distinct, one scratch list is reused
     {
-        p = get_dword (endTable);
-        if (IDAUtils::GetFunctionFlags(p) == -1) {
-            IDAUtils::MakeCode(p);
-            IDAUtils::MakeFunction (p, BADADDR);
+        PROFILE_SCOPE ("doAddrList");
+        addr_list_t funcs;
+
+        for (size_t i = 0; i < this->pending.size (); i++)
+        {
+            this->writers.functions (this->pending[i].address, &funcs);
+            IDAUtils::doAddrList (this->pending[i].name.empty () ? NULL : this->pending[i].name.begin (), funcs);
         }
-        
-        Vtable::checkSDD (p, name, address, 0);
-        vtableMethodsCount--;
-        endTable += 4;
     }
 
-    IDAUtils::doAddrList (name);
-    
-    return endTable;
+    {
+        ScopedPhase phase ("sizes");
+        phase.add_items (this->pending.size ());
+        this->objectSizes.analyze (this->writers);
+    }
+
+    msg ("RECPP: object size found for %d of %d vftable(s)\n",
+         (int) this->objectSizes.get_sizes ().size (), (int) this->pending.size ());
+
+    // The slots carry their final names by now
+    {
+        ScopedPhase phase ("types");
+        phase.add_items (this->types.size ());
+        this->types.commit ();
+    }
+
+    this->pending.clear ();
+}
+
+void
+VtableScanner::restore (
+    const ScanState *state
+) {
+    state->restore (&this->vtables);
+    msg ("Vtable count = %d (from the last scan)\n", this->vtables.size());
 }
 
 bool
-VtableScanner::scan (
+VtableScanner::begin (
     void
 ) {
+    // Each report covers one scan
+    Profiler::get ()->reset ();
+    IDACalls::reset ();
+
     // Get .text and .rdata segments boundaries
     segment_t *textSeg  = get_segm_by_name (".text");
     segment_t *rdataSeg = get_segm_by_name (".rdata");
@@ -179,33 +253,201 @@ VtableScanner::scan (
         return false;
     }
 
-    ea_t rMin = rdataSeg->start_ea, 
-         rMax = rdataSeg->end_ea, 
-         cMin = textSeg->start_ea, 
-         cMax = textSeg->end_ea;
+    this->rMin = rdataSeg->start_ea;
+    this->rMax = rdataSeg->end_ea;
+    this->cMin = textSeg->start_ea;
+    this->cMax = textSeg->end_ea;
     
-    if (rMin == 0) {
-        rMin = cMin; 
-        rMax = cMax;
+    if (this->rMin == 0) {
+        this->rMin = this->cMin; 
+        this->rMax = this->cMax;
     }
 
-    ea_t curAddress = rMin;
-    ea_t curDword;
+    this->ranges.assign (1, std::make_pair (this->rMin, this->rMax));
+    this->range = 0;
+    this->cursor = this->rMin;
+    this->incremental = false;
+
+    // Function lookups of the scan (writers, registry) go through the snapshot
+    FuncIndex::get ()->ensure ();
+
+    return true;
+}
+
+bool
+VtableScanner::beginIncremental (
+    const ScanState *state
+) {
+    std::vector<size_t> keep;
+    ScanState::ranges_t dirty;
+
+    if (!begin () || !state->plan_rescan (&dirty, &keep)) {
+        return false;
+    }
+
+    state->restore (&this->vtables, &keep);
+
+    this->ranges = dirty;
+    this->range = 0;
+    this->cursor = dirty.empty () ? this->rMax : dirty[0].first;
+    this->incremental = true;
+
+    msg ("RECPP: rescanning %d range(s), %d vftable(s) unchanged\n",
+         (int) dirty.size (), (int) keep.size ());
+
+    return true;
+}
+
+bool
+VtableScanner::resume (
+    const ScanState *state
+) {
+    if (!begin ()) {
+        return false;
+    }
+
+    ea_t from = state->get_cursor ();
+    if (from > this->rMin && from < this->rMax) {
+        state->restore (&this->vtables);
+        this->cursor = from;
+    }
+
+    return true;
+}
 
-    while (curAddress < rMax) {
-        curDword = get_dword (curAddress);
+int
+VtableScanner::getProgress () const {
+    uint64 total = 0, done = 0;
 
-        // Methods should reside in .text
-        if (curDword >= cMin && curDword < cMax) {
-            curAddress = this->checkVtable (curAddress);
+    for (size_t i = 0; i < this->ranges.size (); i++)
+    {
+        ea_t from = this->ranges[i].first, to = this->ranges[i].second;
+        total += to - from;
+
+        if (i < this->range) {
+            done += to - from;
         }
-        else {
-            curAddress += 4;
+        else if (i == this->range && this->cursor > from) {
+            done += std::min (this->cursor, to) - from;
+        }
+    }
+
+    if (total == 0 || this->range >= this->ranges.size ()) {
+        return 100;
+    }
+
+    return (int) (done * 100 / total);
+}
+
+VtableScanner::scan_status_t
+VtableScanner::step (
+    uint32 sliceMs
+) {
+    ScopedPhase phase ("scan");
+    uint64 deadline = get_nsec_stamp () + (uint64) sliceMs * 1000000;
+    ea_t curDword;
+    int n = 0;
+
+    for (; this->range < this->ranges.size (); this->range++)
+    {
+        ea_t curAddress = std::max (this->cursor, this->ranges[this->range].first);
+        ea_t end = this->ranges[this->range].second;
+
+        while (curAddress < end) {
+            curDword = IDAUtils::Dword (curAddress);
+
+            // Methods should reside in .text
+            if (curDword >= this->cMin && curDword < this->cMax) {
+                ea_t next = this->checkVtable (curAddress);
+                phase.add_items (next - curAddress);
+                curAddress = next;
+            }
+            else {
+                curAddress += 4;
+                phase.add_items (4);
+            }
+
+            if (++n == SCAN_CLOCK_INTERVAL) {
+                n = 0;
+                if (get_nsec_stamp () >= deadline) {
+                    break;
+                }
+            }
         }
-    }
+
+        // A vftable found at the end of a range can run over the next ones
+        this->cursor = curAddress;
+        if (curAddress < end) {
+            return SCAN_RUNNING;
+        }
+    }
+
+    resolveWriters ();
+
+    // Kept and new vftables, back in address order
+    std::sort (this->vtables.begin (), this->vtables.end (), [] (const Vtable *a, const Vtable *b) {
+        return a->getAddress () < b->getAddress ();
+    });
 
     msg ("Finished !\n");
-    msg ("Vtable count = %d", this->vtables.size());
+    msg ("Vtable count = %d\n", this->vtables.size());
+    this->decMap->print_stats ();
+    MemStats::report ();
+
+    if (PROFILER_ENABLED) {
+        Profiler::get ()->report ();
+        IDACalls::report ();
+
+        qstring path (get_path (PATH_TYPE_IDB));
+        path += ".profile.json";
+        if (Profiler::get ()->export_json (path.c_str ())) {
+            msg ("Profile written to %s\n", path.c_str ());
+        }
+    }
 
+    return SCAN_DONE;
+}
+
+VtableScanner::scan_status_t
+VtableScanner::run (
+    void
+) {
+    scan_status_t status;
+
+    show_wait_box ("Scanning vftables...");
+
+    while ((status = step (SCAN_SLICE_MS)) == SCAN_RUNNING)
+    {
+        replace_wait_box ("Scanning vftables... %d%%, %d classes found",
+                          getProgress (), (int) this->vtables.size ());
+
+        if (user_cancelled ()) {
+            status = SCAN_CANCELLED;
+            break;
+        }
+    }
+
+    // The vftables found before a cancel keep their constructor names
+    if (status == SCAN_CANCELLED) {
+        replace_wait_box ("Naming constructors...");
+        resolveWriters ();
+    }
+
+    hide_wait_box ();
+
+    return status;
+}
+
+bool
+VtableScanner::scan (
+    void
+) {
+    if (!begin ()) {
+        return false;
+    }
+
+    while (step (UINT_MAX) == SCAN_RUNNING) {
+    }
+
     return true;
 }
\ No newline at end of file
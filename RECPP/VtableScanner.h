@@ -14,20 +14,94 @@
 #include "RECPP.h"
 #include "Vtable.h"
 #include "DecMap.h"
+#include "ScanState.h"
+#include "MemStats.h"
+#include "VtableWriters.h"
+#include "ObjectSizes.h"
+#include "TypeBatch.h"
 
 // ---------- Defines -------------
+#define SCAN_SLICE_MS       100 // work done between two wait box updates
+#define SCAN_CLOCK_INTERVAL 64  // addresses between two clock reads
 
 
 // ------ Class definition --------
-class VtableScanner {
+class VtableScanner : public MemTracked<MEM_SCANNER> {
     public:
     VtableScanner (DecMap *decMap);
     ~VtableScanner ();
+
+    enum scan_status_t
+    {
+        SCAN_RUNNING,
+        SCAN_DONE,
+        SCAN_CANCELLED,
+    };
     
+    /*
+    * @brief : Scan the whole .rdata segment, without interruption
+    */
     bool
     VtableScanner::scan (
         void
     );
+
+    /*
+    * @brief : Prepare a scan from the start of .rdata
+    * @return false if the segments are missing
+    */
+    bool
+    VtableScanner::begin (
+        void
+    );
+
+    /*
+    * @brief : Prepare a scan that continues a cancelled one
+    */
+    bool
+    VtableScanner::resume (
+        const ScanState *state
+    );
+
+    /*
+    * @brief : Prepare a scan of the ranges that changed since a completed scan,
+    *          keeping the vftables found outside of them
+    * @return false if the state can't tell what changed, begin () is needed then
+    */
+    bool
+    VtableScanner::beginIncremental (
+        const ScanState *state
+    );
+
+    /*
+    * @brief : Scan for about \sliceMs milliseconds, from where the previous step stopped
+    * @return SCAN_DONE once the end of the segment is reached
+    */
+    scan_status_t
+    VtableScanner::step (
+        uint32 sliceMs
+    );
+
+    /*
+    * @brief : Run the scan to the end in slices, under a wait box the user can cancel
+    * @return SCAN_DONE, or SCAN_CANCELLED with the cursor on the next address to scan
+    */
+    scan_status_t
+    VtableScanner::run (
+        void
+    );
+
+    ea_t getCursor () const { return this->cursor; }
+    bool isIncremental () const { return this->incremental; }
+    int getProgress () const;
+
+    /*
+    * @brief : Take the vftables of a previous scan instead of scanning
+    */
+    void
+    VtableScanner::restore (
+        const ScanState *state
+    );
     
 
     ea_t
@@ -35,9 +109,47 @@ class VtableScanner {
         ea_t address
     );
 
+    const std::vector <Vtable *> &getVtables () const { return this->vtables; }
+
+    // Instructions writing the vftables found by the last step, i.e. their ctors and dtors
+    const VtableWriters &getWriters () const { return this->writers; }
+
+    // Allocation sizes of the classes found by the last step
+    const ObjectSizes &getObjectSizes () const { return this->objectSizes; }
+
     private:
         std::vector <Vtable *> vtables;
         DecMap *decMap;
+
+        // Segment bounds, ranges to walk and scan position
+        ea_t rMin, rMax, cMin, cMax;
+        ScanState::ranges_t ranges;
+        size_t range;
+        ea_t cursor;
+        bool incremental;
+
+        // Vftables whose constructor still has to be named, and the
+        // type name it gets (".?AV...", empty if unknown)
+        struct pending_t
+        {
+            ea_t address;
+            qstring name;
+        };
+        std::vector<pending_t> pending;
+        VtableWriters writers;
+        ObjectSizes objectSizes;
+
+        // Vftable structures, created once the vftables are named
+        TypeBatch types;
+
+        /*
+        * @brief : Index the writers of the pending vftables in one sweep of the
+        *          code, and name their constructors
+        */
+        void
+        VtableScanner::resolveWriters (
+            void
+        );
         
         /*
         * @brief : Get a vtable size
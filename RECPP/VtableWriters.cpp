@@ -0,0 +1,245 @@
+﻿/*
+    ██████╗ ███████╗ ██████╗██████╗ ██████╗ 
+    ██╔══██╗██╔════╝██╔════╝██╔══██╗██╔══██╗
+    ██████╔╝█████╗  ██║     ██████╔╝██████╔╝
+    ██╔══██╗██╔══╝  ██║     ██╔═══╝ ██╔═══╝ 
+    ██║  ██║███████╗╚██████╗██║     ██║     
+    ╚═╝  ╚═╝╚══════╝ ╚═════╝╚═╝     ╚═╝     
+* @license : <license placeholder>
+*/
+
+#include "VtableWriters.h"
+#include "ParallelFor.h"
+#include "Profiler.h"
+#include "FuncIndex.h"
+#include "IDACalls.h"
+#include <allins.hpp>
+#include <segment.hpp>
+#include <algorithm>
+#include <thread>
+
+
+VtableWriters::VtableWriters () {
+}
+
+VtableWriters::~VtableWriters () {
+    MemStats::account (MEM_SCANNER, &this->memory, 0, 0);
+}
+
+void
+VtableWriters::clear (
+    void
+) {
+    this->writers.clear ();
+    MemStats::account (MEM_SCANNER, &this->memory, 0, 0);
+}
+
+// Runs on the workers of parallel_for : memory only, no kernel call
+void
+VtableWriters::search_chunk (
+    const uchar *bytes,
+    size_t len,
+    ea_t base,
+    const std::vector<ea_t> &vtables,
+    std::vector<ea_t> *hits
+) {
+    ea_t lo = vtables.front ();
+    ea_t hi = vtables.back ();
+
+    for (size_t i = 0; i + 4 <= len; i++)
+    {
+        ea_t value = (ea_t) bytes[i]
+                   | ((ea_t) bytes[i + 1] << 8)
+                   | ((ea_t) bytes[i + 2] << 16)
+                   | ((ea_t) bytes[i + 3] << 24);
+
+        // Most values aren't even in .rdata
+        if (value < lo || value > hi) {
+            continue;
+        }
+
+        if (std::binary_search (vtables.begin (), vtables.end (), value)) {
+            hits->push_back (base + (ea_t) i);
+        }
+    }
+}
+
+// The hit is the imm32 operand, which ends the instruction
+bool
+VtableWriters::confirm (
+    ea_t hit,
+    writer_t *out
+) {
+    ea_t head = get_item_head (hit);
+    if (!is_code (get_flags (head))) {
+        return false;
+    }
+
+    insn_t insn;
+    if (decode_insn (&insn, head) <= 0 || head + insn.size != hit + 4) {
+        return false;
+    }
+
+    if (insn.itype != NN_mov || insn.Op2.type != o_imm) {
+        return false;
+    }
+
+    switch (insn.Op1.type)
+    {
+        case o_phrase: out->offset = 0; break;
+        case o_displ:  out->offset = (int32) insn.Op1.addr; break;
+        case o_reg:    out->offset = VTW_OFFSET_REG; break;
+        case o_mem:    out->offset = VTW_OFFSET_MEM; break;
+        default:       return false;
+    }
+
+    ea_t func = FuncIndex::get ()->func_start (head);
+    if (func == BADADDR) {
+        return false;
+    }
+
+    out->vtable = (ea_t) insn.Op2.value;
+    out->func = func;
+    out->insn = head;
+
+    return true;
+}
+
+void
+VtableWriters::build (
+    const std::vector<ea_t> &vtables
+) {
+    PROFILE_SCOPE ("VtableWriters::build");
+
+    this->writers.clear ();
+
+    std::vector<ea_t> sorted (vtables);
+    std::sort (sorted.begin (), sorted.end ());
+    sorted.erase (std::unique (sorted.begin (), sorted.end ()), sorted.end ());
+
+    if (sorted.empty ()) {
+        return;
+    }
+
+    // Every code segment, the constructors aren't all in .text
+    std::vector<std::pair<ea_t, ea_t> > ranges;
+    for (int s = 0; s < get_segm_qty (); s++)
+    {
+        segment_t *seg = getnseg (s);
+        if (seg != NULL && seg->type == SEG_CODE && seg->end_ea > seg->start_ea) {
+            ranges.push_back (std::make_pair (seg->start_ea, seg->end_ea));
+        }
+    }
+
+    // A batch of chunks per round, read on this thread then searched in parallel
+    unsigned threads = std::thread::hardware_concurrency ();
+    size_t batch = threads > 1 ? threads * 2 : 1;
+
+    std::vector<std::vector<uchar> > buffers (batch);
+    std::vector<ea_t> bases (batch);
+    std::vector<std::vector<ea_t> > found (batch);
+    std::vector<ea_t> hits;
+
+    size_t r = 0;
+    ea_t from = ranges.empty () ? BADADDR : ranges[0].first;
+
+    while (r < ranges.size ())
+    {
+        size_t n = 0;
+
+        {
+            PROFILE_SCOPE ("read");
+            for (; n < batch && r < ranges.size (); n++)
+            {
+                ea_t end = ranges[r].second;
+                ea_t to = end - from > VTW_CHUNK_SIZE ? from + VTW_CHUNK_SIZE : end;
+
+                // 3 more bytes, for a value crossing the end of the chunk
+                ea_t readEnd = end - to > 3 ? to + 3 : end;
+
+                buffers[n].resize (readEnd - from);
+                ssize_t got = IDA_CALL (GET_BYTES, get_bytes (&buffers[n][0], buffers[n].size (), from));
+                buffers[n].resize (got > 0 ? (size_t) got : 0);
+                bases[n] = from;
+                found[n].clear ();
+
+                from = to;
+                if (from >= end && ++r < ranges.size ()) {
+                    from = ranges[r].first;
+                }
+            }
+        }
+
+        {
+            PROFILE_SCOPE ("search");
+            parallel_for (n, [&] (size_t i) {
+                if (!buffers[i].empty ()) {
+                    search_chunk (&buffers[i][0], buffers[i].size (), bases[i], sorted, &found[i]);
+                }
+            });
+        }
+
+        for (size_t i = 0; i < n; i++) {
+            hits.insert (hits.end (), found[i].begin (), found[i].end ());
+        }
+    }
+
+    {
+        ScopedPhase phase ("confirm");
+        phase.add_items (hits.size ());
+
+        for (size_t i = 0; i < hits.size (); i++)
+        {
+            writer_t w;
+            if (confirm (hits[i], &w)) {
+                this->writers.push_back (w);
+            }
+        }
+    }
+
+    std::sort (this->writers.begin (), this->writers.end (), [] (const writer_t &a, const writer_t &b) {
+        if (a.vtable != b.vtable) return a.vtable < b.vtable;
+        if (a.func != b.func) return a.func < b.func;
+        return a.insn < b.insn;
+    });
+
+    MemStats::account (MEM_SCANNER, &this->memory,
+                       this->writers.capacity () * sizeof (writer_t), this->writers.size ());
+}
+
+const VtableWriters::writer_t *
+VtableWriters::find (
+    ea_t vtable,
+    size_t *count
+) const {
+    std::vector<writer_t>::const_iterator first = std::lower_bound (
+        this->writers.begin (), this->writers.end (), vtable,
+        [] (const writer_t &w, ea_t v) { return w.vtable < v; });
+
+    std::vector<writer_t>::const_iterator last = first;
+    while (last != this->writers.end () && last->vtable == vtable) {
+        ++last;
+    }
+
+    *count = last - first;
+    return first != last ? &*first : NULL;
+}
+
+size_t
+VtableWriters::functions (
+    ea_t vtable,
+    std::vector<ea_t> *out
+) const {
+    out->clear ();
+
+    size_t count;
+    const writer_t *w = find (vtable, &count);
+
+    for (size_t i = 0; i < count; i++) {
+        if (out->empty () || out->back () != w[i].func) {
+            out->push_back (w[i].func);
+        }
+    }
+
+    return out->size ();
+}
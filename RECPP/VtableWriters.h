@@ -0,0 +1,103 @@
+﻿/*
+    ██████╗ ███████╗ ██████╗██████╗ ██████╗ 
+    ██╔══██╗██╔════╝██╔════╝██╔══██╗██╔══██╗
+    ██████╔╝█████╗  ██║     ██████╔╝██████╔╝
+    ██╔══██╗██╔══╝  ██║     ██╔═══╝ ██╔═══╝ 
+    ██║  ██║███████╗╚██████╗██║     ██║     
+    ╚═╝  ╚═╝╚══════╝ ╚═════╝╚═╝     ╚═╝     
+* @license : <license placeholder>
+*/
+
+#pragma once
+
+
+// ---------- Includes ------------
+#include "RECPP.h"
+#include "MemStats.h"
+#include <vector>
+
+// ---------- Defines -------------
+#define VTW_CHUNK_SIZE (1024 * 1024) // bytes of code read and searched at once
+#define VTW_OFFSET_REG 0x7FFFFFFF    // vftable loaded in a register, stored later
+#define VTW_OFFSET_MEM 0x7FFFFFFE    // vftable stored in a global, static object initializers
+
+
+// ------ Class definition --------
+// Index of the instructions writing a vftable address, i.e. the
+// constructors and destructors of the classes, built in one pass over the
+// code instead of one xref walk per vftable.
+//
+// The code segments are read in chunks, searched in parallel for 4 byte
+// values that are known vftables, and every hit is confirmed by decoding the
+// instruction around it : mov [reg+off], imm32, mov ds:global, imm32 or
+// mov reg, imm32 (32 bit code only).
+class VtableWriters
+{
+public:
+    struct writer_t
+    {
+        ea_t vtable;
+        ea_t func;      // start of the writing function
+        ea_t insn;
+        int32 offset;   // offset of the vfptr in the object, or VTW_OFFSET_REG / MEM
+    };
+
+    VtableWriters ();
+    ~VtableWriters ();
+
+    void
+    clear (
+        void
+    );
+
+    /*
+     * @brief : Find every write of the given vftables in the code segments
+     * @param vtables : The vftable addresses, in any order
+     */
+    void
+    build (
+        const std::vector<ea_t> &vtables
+    );
+
+    /*
+     * @brief : Get the writes of a vftable, ordered by function
+     * @return The first writer, or NULL if there is none
+     */
+    const writer_t *
+    find (
+        ea_t vtable,
+        size_t *count
+    ) const;
+
+    /*
+     * @brief : Get the distinct functions writing a vftable, in address order
+     */
+    size_t
+    functions (
+        ea_t vtable,
+        std::vector<ea_t> *out
+    ) const;
+
+    size_t size () const { return this->writers.size (); }
+    const std::vector<writer_t> &get_writers () const { return this->writers; }
+
+private:
+    std::vector<writer_t> writers;  // sorted by vtable, function, instruction
+
+    MemStats::held_t memory;
+
+    static void
+    search_chunk (
+        const uchar *bytes,
+        size_t len,
+        ea_t base,
+        const std::vector<ea_t> &vtables,
+        std::vector<ea_t> *hits
+    );
+
+    static bool
+    confirm (
+        ea_t hit,
+        writer_t *out
+    );
+};
@@ -1,7 +1,12 @@
 #include "CallGraph.h"
+#include "CallGraphStore.h"
+
+uint32 CallGraph::names_gen = 0;
 
 CallGraph::CallGraph () {
     this->node_count = 0;
+    this->name_index_gen = 0;
+    this->cur_node = 0;
     this->cur_text[0] = '\0';
 }
 
@@ -23,6 +28,38 @@ CallGraph::visited (
 }
 
 
+int
+CallGraph::walk_callee (
+    func_t *func,
+    ea_t to,
+    funcs_walk_options_t *opt,
+    int level
+) {
+    int id2;
+    if (visited (to, &id2)) {
+        return id2;
+    }
+
+    func_t *f = get_func (to);
+
+    if (f == NULL || func_contains (func, to)) {
+        return -1;
+    }
+
+    bool skip = false;
+
+    if (opt != NULL) {
+        // skip lib funcs?
+        skip = (  ((f->flags & FUNC_LIB) != 0) 
+               && ((opt->flags & FWO_SKIPLIB) != 0))
+             || ( ((opt->flags & FWO_RECURSE_UNLIM) == 0)
+               && (level > opt->recurse_limit));
+    }
+
+    return (skip) ? add (f->start_ea) 
+                  : walk_func (f, opt, level + 1);
+}
+
 int
 CallGraph::walk_func (
     func_t *func, 
@@ -32,6 +69,22 @@ CallGraph::walk_func (
     // add a node for this function
     int id = add (func->start_ea);
 
+    // use the stored call graph when there is one, instead of the xrefs
+    CallGraphStore *store = CallGraphStore::get ();
+    if (store->is_loaded ()) {
+        std::vector<ea_t> callees;
+        store->callees (func->start_ea, &callees);
+
+        for (size_t i = 0; i < callees.size (); i++) {
+            int id2 = walk_callee (func, callees[i], opt, level);
+            if (id2 != -1) {
+                create_edge (id, id2);
+            }
+        }
+
+        return id;
+    }
+
     func_item_iterator_t fii;
 
     for (bool fi_ok = fii.set (func); fi_ok; fi_ok = fii.next_code ()) 
@@ -42,36 +95,57 @@ CallGraph::walk_func (
             xb_ok && xb.iscode;
             xb_ok = xb.next_from ()
         ) {
-            int id2;
-            if (!visited (xb.to, &id2)) 
-            {
-                func_t *f = get_func (xb.to);
-                
-                if (f == NULL || func_contains (func, xb.to)) {
-                    continue;
-                }
-
-                bool skip = false;
-
-                if (opt != NULL) {
-                    // skip lib funcs?
-                    skip = (  ((f->flags & FUNC_LIB) != 0) 
-                           && ((opt->flags & FWO_SKIPLIB) != 0))
-                         || ( ((opt->flags & FWO_RECURSE_UNLIM) == 0)
-                           && (level > opt->recurse_limit));
-                }
-
-                id2 = (skip) ? add (f->start_ea) 
-                             : walk_func (f, opt, level + 1);
+            int id2 = walk_callee (func, xb.to, opt, level);
+            if (id2 != -1) {
+                create_edge (id, id2);
             }
-
-            create_edge (id, id2);
         }
     }
 
     return id;
 }
 
+void
+CallGraph::build_name_index (
+    void
+) {
+    this->name_index.clear ();
+
+    // Read the names straight from the database, there's no need to go
+    // through get_info and build a funcinfo_t for every node
+    qstring name;
+    for (int i = 0; i < node_count; i++) {
+        ea_t ea = get_addr (i);
+
+        if (ea == BADADDR || get_func_name (&name, ea) <= 0) {
+            this->name_index.add ("?");
+        }
+        else {
+            this->name_index.add (name.c_str ());
+        }
+    }
+
+    this->name_index.finalize ();
+    this->name_index_gen = names_gen;
+}
+
+size_t
+CallGraph::search (
+    const char *text,
+    size_t offset,
+    size_t limit,
+    std::vector<int> *out
+) {
+    // New nodes, or a name changed since the index was built
+    if (!this->name_index.is_ready ()
+     || this->name_index.size () != (size_t) node_count
+     || this->name_index_gen != names_gen) {
+        build_name_index ();
+    }
+
+    return this->name_index.search (text, offset, limit, out);
+}
+
 int
 CallGraph::find_first (
     const char *text
@@ -83,6 +157,8 @@ CallGraph::find_first (
     qstrncpy (this->cur_text, text, sizeof (this->cur_text));
     this->cur_node = 0;
 
+    search (this->cur_text, 0, 0, &this->cur_results);
+
     return find_next ();
 }
 
@@ -90,12 +166,8 @@ int
 CallGraph::find_next (
     void
 ) {
-    for (int i = this->cur_node; i < node_count; i++) {
-        const char *s = get_name (i);
-        if (stristr (s, this->cur_text) != NULL) {
-            this->cur_node = i + 1;
-            return i;
-        }
+    if (this->cur_node < (int) this->cur_results.size ()) {
+        return this->cur_results[this->cur_node++];
     }
 
     // reset search
@@ -124,6 +196,8 @@ CallGraph::reset (
     this->node2ea.clear ();
     this->cached_funcs.clear ();
     this->edges.clear ();
+    this->name_index.clear ();
+    this->cur_results.clear ();
 }
 
 const ea_t
@@ -162,13 +236,8 @@ CallGraph::get_info (
         funcinfo_t fi;
 
         // get name
-        // char buf [MAXSTR];
-		qstring *buf;
-        if (get_func_name(buf, it_ea->second/*, buf, sizeof (buf)) == NULL*/) {
+        if (get_func_name (&fi.name, it_ea->second) <= 0) {
             fi.name = "?";
-        } 
-        else {
-            fi.name = buf;
         }
         // get color
         fi.color = calc_bg_color (pfn->start_ea);
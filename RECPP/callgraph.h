@@ -13,6 +13,7 @@
 
 // ---------- Includes ------------
 #include "RECPP.h"
+#include "NameIndex.h"
 
 // ---------- Defines -------------
 
@@ -61,13 +62,17 @@ public:
     edge_iterator end_edges() { return edges.end(); }
     void clear_edges();
 
-    // find nodes by text
+    // find nodes by text, best matches first
     int find_first(const char *text);
     int find_next();
+    size_t search(const char *text, size_t offset, size_t limit, std::vector<int> *out);
     const char *get_findtext() { return cur_text; }
     const int count() const { return node_count; }
     void reset();
 
+    // a function was renamed, the name index is rebuilt on the next search
+    static void names_changed() { names_gen++; }
+
     // node / func info
     struct funcinfo_t
     {
@@ -87,10 +92,18 @@ public:
     func_t *CallGraph::get_function(int nid);
 
     int walk_func (func_t *func, funcs_walk_options_t *o = NULL, int level = 1);
+    int walk_callee (func_t *func, ea_t to, funcs_walk_options_t *o, int level);
 
 private:
     edges_t edges;
 
+    // name search index, built on the first search
+    NameIndex name_index;
+    std::vector<int> cur_results;
+    static uint32 names_gen;
+    uint32 name_index_gen; // names_gen when the index was built
+    void build_name_index();
+
     // node id to func addr and reverse lookup
     typedef std::map<ea_t, int> ea_int_map_t;
     typedef std::map<int, ea_t> int_ea_map_t;
@@ -13,21 +13,30 @@
 #include "IDAUtils.h"
 #include "VirtualMethod.h"
 #include "CompleteObjectLocator.h"
+#include "Profiler.h"
+#include "StrUtils.h"
+#include "FuncIndex.h"
 
 Vtable::Vtable (
     ea_t address, 
     char *className, 
-    size_t virtualMethodsCount
+    size_t virtualMethodsCount,
+    bool explore
 )  {
     char *forClass;
     filterClassName (&className, &forClass);
 
     this->address = address;
     this->className = strdup (className);
+    MemStats::on_alloc (MEM_NAMES, strlen (this->className) + 1);
     this->virtualMethodsCount = virtualMethodsCount;
     
     // msg ("=== Analyzing Vtable for '%s' ===\n", className);
 
+    if (!explore) {
+        return;
+    }
+
     for (size_t methodIndex = 0; methodIndex < virtualMethodsCount; methodIndex++) {
         VirtualMethod *m = new VirtualMethod (className, address, methodIndex, forClass);
         m->explore ();
@@ -83,28 +92,7 @@ Vtable::filterClassName (
     }
 
     // Remove forbidden characters
-    char *forbidden;
-    while (forbidden = strstr (className, "<")) {
-        *forbidden = '_';
-    }
-    while (forbidden = strstr (className, ">")) {
-        *forbidden = '_';
-    }
-    while (forbidden = strstr (className, " ")) {
-        *forbidden = '_';
-    }
-    while (forbidden = strstr (className, ",")) {
-        *forbidden = '_';
-    }
-    while (forbidden = strstr (className, "*")) {
-        *forbidden = '_';
-    }
-    while (forbidden = strstr (className, "`")) {
-        *forbidden = '_';
-    }
-    while (forbidden = strstr (className, "'")) {
-        *forbidden = '_';
-    }
+    sanitize_name (className);
     
     *_className = className;
 }
@@ -125,13 +113,13 @@ Vtable::getTypeName (
         return NULL;
     }
 
-    ea_t x = get_dword (vtable - 4);
+    ea_t x = IDAUtils::Dword (vtable - 4);
 
     if (!x || (x == BADADDR)) {
         return NULL;
     }
 
-    x = get_dword (x + 12);
+    x = IDAUtils::Dword (x + 12);
 
     if (!x || (x == BADADDR)) {
         return NULL;
@@ -142,7 +130,7 @@ Vtable::getTypeName (
     char curByte;
     size_t bufferPos = 0;
 
-    while (curByte = get_byte (x)) {
+    while (curByte = IDAUtils::Byte (x)) {
         result [bufferPos++] = curByte;
         x++;
         if (bufferPos > resultSize) {
@@ -163,10 +151,10 @@ Vtable::getClassName2 (
     char vtableType [4096] = {0};
 
     CompleteObjectLocator::get_type_name_by_col (colAddress, vtableType, sizeof (vtableType));
-    ea_t i = get_dword (colAddress + 16); // CHD
-    i = get_dword (i+4);  // Attributes
+    ea_t i = IDAUtils::Dword (colAddress + 16); // CHD
+    i = IDAUtils::Dword (i+4);  // Attributes
 
-    if ((i & 3) == 0 && get_dword (colAddress + 4) == 0) { 
+    if ((i & 3) == 0 && IDAUtils::Dword (colAddress + 4) == 0) { 
         //Single inheritance, so we don't need to worry about duplicate names (several vtables)
         sprintf_s (result, resultSize, "??_7%s6B@", &vtableType[4]);
         return result;
@@ -187,17 +175,8 @@ ea_t
 Vtable::getFuncStart (
     ea_t address
 ) {
-    if (IDAUtils::GetFunctionFlags (address) == -1) {
-        return -1;
-    }
-
-    if ((IDAUtils::GetFlags (address) & FF_FUNC) != 0) {
-        return address;
-    }
-
-    else {
-        return IDAUtils::PrevFunction (address);
-    }
+    // BADADDR when the address isn't in any function
+    return FuncIndex::get ()->func_start (address);
 }
 
 
@@ -208,21 +187,21 @@ Vtable::getClassName (
     char *result,
     size_t resultSize
 ) {
-    ea_t offset = get_dword (address + 4);
-    address = get_dword (address + 16); // Class Hierarchy Descriptor
+    ea_t offset = IDAUtils::Dword (address + 4);
+    address = IDAUtils::Dword (address + 16); // Class Hierarchy Descriptor
 
-    ea_t a = get_dword (address + 12); // pBaseClassArray
-    size_t numBaseClasses = get_dword (address + 8);  //numBaseClasses
+    ea_t a = IDAUtils::Dword (address + 12); // pBaseClassArray
+    size_t numBaseClasses = IDAUtils::Dword (address + 8);  //numBaseClasses
     size_t i = 0;
     result[0] = '\0';
     
     while (i < numBaseClasses) 
     {
-        ea_t p = get_dword (a);
+        ea_t p = IDAUtils::Dword (a);
 
-        if (get_dword (p + 8) == offset) {
+        if (IDAUtils::Dword (p + 8) == offset) {
             // Found it
-            return IDAUtils::GetAsciizStr (get_dword (p) + 8, result, resultSize);
+            return IDAUtils::GetAsciizStr (IDAUtils::Dword (p) + 8, result, resultSize);
         }
 
         i++;
@@ -231,14 +210,14 @@ Vtable::getClassName (
 
     // Didn't find matching one, let's get the first vbase
     i = 0;
-    a = get_dword (address + 12);
+    a = IDAUtils::Dword (address + 12);
 
     while (i < numBaseClasses) 
     {
-        ea_t p = get_dword (a);
+        ea_t p = IDAUtils::Dword (a);
 
-        if (get_dword (p + 12) != -1)  {
-            return IDAUtils::GetAsciizStr (get_dword (p) + 8, result, resultSize);
+        if (IDAUtils::Dword (p + 12) != -1)  {
+            return IDAUtils::GetAsciizStr (IDAUtils::Dword (p) + 8, result, resultSize);
         }
 
         i++;
@@ -248,55 +227,13 @@ Vtable::getClassName (
     return result;
 }
 
-void
-Vtable::createStruct (
-    ea_t vtableAddress,
-    size_t methodsCount,
-    char *className  
-) {
-    if (strlen (className) == 0) {
-        return;
-    }
-
-    char structName [4096] = {0};
-    sprintf_s (structName, sizeof (structName), "%s_vtable", className);
-
-    tid_t struct_id = IDAUtils::GetStrucIdByName (structName);
-
-    if (struct_id != -1) {
-        return;
-    }
-
-    struct_id = IDAUtils::AddStrucEx (-1, structName, 0);
-
-    if (struct_id == -1) {
-        msg ("Could not create the vtable structure %s !\n", structName);
-        return;
-    }
-
-    for (size_t i = 0 ; i < methodsCount ; i++)
-    {
-        char methodName[4096] = {0};
-        ea_t methodAddress = get_dword (vtableAddress + i * 4);
-        if (!methodAddress) {
-            continue;
-        }
-
-        IDAUtils::Name (methodAddress, methodName, sizeof (methodName));
-
-        if (strlen (methodName) == 0) {
-            continue;
-        }
-
-        IDAUtils::ForceMethodMember (struct_id, i * 4, methodName, sizeof (methodName));
-    }
-}
-
 Vtable *
 Vtable::parse (
     ea_t address,
     size_t methodsCount
 ) {
+    PROFILE_SCOPE ("Vtable::parse");
+
     char typeName [4096] = {0};
     char className [4096] = {0};
     char classNameMangled [4096] = {0};
@@ -309,10 +246,10 @@ Vtable::parse (
     {
         IDAUtils::Unknown (address - 4, 4);
         IDAUtils::SoftOff (address - 4);
-        ea_t i = get_dword (address - 4);  // COL
-        ea_t s2 = get_dword (i + 4); // offset
-        i = get_dword (i + 16); // CHD
-        i = get_dword (i + 4);  // Attributes
+        ea_t i = IDAUtils::Dword (address - 4);  // COL
+        ea_t s2 = IDAUtils::Dword (i + 4); // offset
+        i = IDAUtils::Dword (i + 16); // CHD
+        i = IDAUtils::Dword (i + 4);  // Attributes
 
         char className [4096] = {0};
 
@@ -330,14 +267,14 @@ Vtable::parse (
 
             // Set the RTTI Complete Object Locator name
             sprintf_s (COLName, sizeof (COLName), "??_R4%s6B@", &typeName[4]);
-            IDAUtils::MakeName (get_dword (address - 4), COLName);
+            IDAUtils::MakeName (IDAUtils::Dword (address - 4), COLName);
         }
 
         else {
             // Multiple inheritance
             char buffer [4096] = {0};
             char vtableName [4096] = {0};
-            getClassName (get_dword (address - 4), vtableName, sizeof (vtableName));
+            getClassName (IDAUtils::Dword (address - 4), vtableName, sizeof (vtableName));
             sprintf_s (buffer, sizeof (buffer), "%s6B%s@", &typeName[4], &vtableName[4]);
             sprintf_s (vtableName, sizeof (vtableName),  "??_7%s", buffer);
             sprintf_s (COLName, sizeof (COLName), "??_R4%s", buffer);
@@ -352,11 +289,7 @@ Vtable::parse (
             result = new Vtable (address, className, methodsCount);
             
             // Set the RTTI Complete Object Locator name
-            IDAUtils::MakeName (get_dword (address - 4), COLName);
-        }
-
-        if (result != NULL) {
-            createStruct (address, methodsCount, result->className);
+            IDAUtils::MakeName (IDAUtils::Dword (address - 4), COLName);
         }
     }
 
@@ -372,6 +305,8 @@ Vtable::checkSDD (
     ea_t vtable,
     ea_t gate
 ) {
+    PROFILE_SCOPE ("Vtable::checkSDD");
+
     ea_t a = BADADDR, t = 0;
     char buffer[2048];
     char *varName = IDAUtils::Name (address, buffer, sizeof (buffer));
@@ -14,18 +14,25 @@
 // ---------- Includes ------------
 #include "RECPP.h"
 #include "VirtualMethod.h"
+#include "MemStats.h"
 
 // ---------- Defines -------------
 
 
 // ------ Class definition --------
-class Vtable 
+class Vtable : public MemTracked<MEM_SCANNER>
 {
 
 public:
-    Vtable (ea_t address, char *className, size_t virtualMethodsCount);
+    // \explore : Walk the slots, naming and typing their targets. A vftable
+    // rebuilt from a stored scan was already explored
+    Vtable (ea_t address, char *className, size_t virtualMethodsCount, bool explore = true);
     ~Vtable ();
 
+    ea_t getAddress () const { return this->address; }
+    size_t getMethodsCount () const { return this->virtualMethodsCount; }
+    const char *getName () const { return this->className; }
+
     static Vtable *
     Vtable::parse (
         ea_t address,
@@ -71,13 +78,16 @@ public:
         size_t resultSize
     );
 
+    /*
+     * @brief : Turn a demangled vftable name into a class name, in place
+     *          ("const Foo::`vftable'{for `Bar'}" -> "Foo", \forClass -> "Bar")
+     */
     static void
-    Vtable::createStruct (
-        ea_t vtableAddress,
-        size_t methodsCount,
-        char *className  
+    Vtable::filterClassName (
+        char **className,
+        char **forClass
     );
-    
+
     /*
      * @brief : check for `scalar deleting destructor'
      * @return The type name, or NULL if an error occured
@@ -95,11 +105,5 @@ private:
     char *className;
     std::vector<VirtualMethod *> virtualMethods;
     size_t virtualMethodsCount;
-    
-    static void
-    Vtable::filterClassName (
-        char **className,
-        char **forClass
-    );
 };
 
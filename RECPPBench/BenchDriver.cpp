@@ -0,0 +1,303 @@
+﻿/*
+    ██████╗ ███████╗ ██████╗██████╗ ██████╗ 
+    ██╔══██╗██╔════╝██╔════╝██╔══██╗██╔══██╗
+    ██████╔╝█████╗  ██║     ██████╔╝██████╔╝
+    ██╔══██╗██╔══╝  ██║     ██╔═══╝ ██╔═══╝ 
+    ██║  ██║███████╗╚██████╗██║     ██║     
+    ╚═╝  ╚═╝╚══════╝ ╚═════╝╚═╝     ╚═╝     
+* @license : <license placeholder>
+*/
+
+#include "BenchDriver.h"
+#include "../RECPPCorpusGen/CorpusGen.h"
+#include <stdlib.h>
+#include <string.h>
+
+
+BenchDriver::BenchDriver (const options_t &opt) {
+    this->opt = opt;
+    this->thresholds[""] = BENCH_DEFAULT_THRESHOLD;
+
+    load_baseline ();
+}
+
+std::string
+BenchDriver::baseline_key (
+    uint32_t classes,
+    const std::string &key
+) {
+    char buffer[32];
+    snprintf (buffer, sizeof (buffer), "%u ", classes);
+
+    return buffer + key;
+}
+
+bool
+BenchDriver::load_baseline (
+    void
+) {
+    FILE *fp = fopen (this->opt.baseline.c_str (), "r");
+    if (fp == NULL) {
+        return false;
+    }
+
+    char line[512];
+    while (fgets (line, sizeof (line), fp) != NULL)
+    {
+        char key[256];
+        unsigned int classes;
+        double value;
+
+        if (line[0] == '#') {
+            continue;
+        }
+
+        if (strncmp (line, "threshold ", 10) == 0) {
+            if (sscanf (line + 10, "%255s %lf", key, &value) == 2) {
+                this->thresholds[key] = value;
+            }
+            else if (sscanf (line + 10, "%lf", &value) == 1) {
+                this->thresholds[""] = value;
+            }
+        }
+        else if (sscanf (line, "%u %255s %lf", &classes, key, &value) == 3) {
+            this->baseline[baseline_key (classes, key)] = value;
+        }
+    }
+
+    fclose (fp);
+    return true;
+}
+
+double
+BenchDriver::threshold (
+    const std::string &key
+) const {
+    std::map<std::string, double>::const_iterator it = this->thresholds.find (key);
+    if (it == this->thresholds.end ()) {
+        it = this->thresholds.find ("");
+    }
+
+    return it->second;
+}
+
+void
+BenchDriver::add (
+    uint32_t classes,
+    const std::string &key,
+    double value,
+    bool higherBetter
+) {
+    measure_t m = { classes, key, value, higherBetter };
+    this->measures.push_back (m);
+}
+
+// phase <name> <ns> <calls> <items> / metric <name> <value>
+bool
+BenchDriver::load_result (
+    const std::string &path,
+    uint32_t classes
+) {
+    FILE *fp = fopen (path.c_str (), "r");
+    if (fp == NULL) {
+        return false;
+    }
+
+    double expected = 0, matched = 0;
+    int profiling = 0;
+    char line[1024];
+
+    while (fgets (line, sizeof (line), fp) != NULL)
+    {
+        char name[256];
+        unsigned long long ns, calls, items;
+        double value;
+
+        if (sscanf (line, "profiling %d", &profiling) == 1) {
+            continue;
+        }
+
+        if (sscanf (line, "phase %255s %llu %llu %llu", name, &ns, &calls, &items) == 4) {
+            // Throughput in the unit of the phase : items when it counts
+            // them, calls otherwise
+            if (ns != 0) {
+                add (classes, std::string (name) + "_per_s", (items != 0 ? items : calls) * 1e9 / ns, true);
+            }
+            continue;
+        }
+
+        if (sscanf (line, "metric %255s %lf", name, &value) == 2) {
+            if (!strcmp (name, "expected")) {
+                expected = value;
+            }
+            else if (!strcmp (name, "matched")) {
+                matched = value;
+            }
+            else if (!strcmp (name, "vftables")) {
+                add (classes, name, value, true);
+            }
+            else {
+                add (classes, name, value, false);
+            }
+        }
+    }
+
+    fclose (fp);
+
+    if (expected != 0) {
+        add (classes, "recall", matched / expected, true);
+    }
+
+    if (!profiling) {
+        printf ("%s : plugin built without RECPP_PROFILING, only the total is measured\n", path.c_str ());
+    }
+
+    return true;
+}
+
+bool
+BenchDriver::run_corpus (
+    uint32_t classes
+) {
+    char base[64];
+    snprintf (base, sizeof (base), "corpus_%u", classes);
+    std::string stem = this->opt.work + "/" + base;
+    std::string image = stem + ".exe";
+    std::string manifest = stem + ".manifest";
+    std::string result = stem + ".bench";
+
+    CorpusGen::options_t genOpt;
+    CorpusGen::default_options (&genOpt);
+    genOpt.classes = classes;
+    genOpt.seed = this->opt.seed;
+
+    CorpusGen gen (genOpt);
+    gen.generate ();
+    if (!gen.write_image (image.c_str ()) || !gen.write_manifest (manifest.c_str (), image.c_str ())) {
+        fprintf (stderr, "Cannot write %s\n", image.c_str ());
+        return false;
+    }
+
+    remove (result.c_str ());
+
+    std::string cmd = "\"" + this->opt.ida + "\" -A -c"
+                    + " \"-L" + stem + ".log\""
+                    + " \"-o" + stem + ".idb\""
+                    + " \"-ORECPP:bench=" + result + ";manifest=" + manifest + "\""
+                    + " \"" + image + "\"";
+#ifdef _WIN32
+    // cmd.exe strips the outer quotes
+    cmd = "\"" + cmd + "\"";
+#endif
+
+    printf ("%s ...\n", base);
+    fflush (stdout);
+
+    int rc = system (cmd.c_str ());
+    if (rc != 0 || !load_result (result, classes)) {
+        fprintf (stderr, "%s : IDA failed (%d), see %s.log\n", base, rc, stem.c_str ());
+        return false;
+    }
+
+    return true;
+}
+
+void
+BenchDriver::report (
+    void
+) const {
+    printf ("%8s %-26s %16s %16s %8s\n", "classes", "measure", "value", "baseline", "delta");
+
+    for (size_t i = 0; i < this->measures.size (); i++)
+    {
+        const measure_t &m = this->measures[i];
+        std::map<std::string, double>::const_iterator it = this->baseline.find (baseline_key (m.classes, m.key));
+
+        if (it == this->baseline.end () || it->second == 0) {
+            printf ("%8u %-26s %16.2f %16s %8s\n", m.classes, m.key.c_str (), m.value, "-", "-");
+        }
+        else {
+            printf ("%8u %-26s %16.2f %16.2f %+7.1f%%\n", m.classes, m.key.c_str (), m.value, it->second,
+                    (m.value - it->second) * 100.0 / it->second);
+        }
+    }
+}
+
+int
+BenchDriver::compare (
+    void
+) const {
+    int regressions = 0;
+
+    for (size_t i = 0; i < this->measures.size (); i++)
+    {
+        const measure_t &m = this->measures[i];
+        std::map<std::string, double>::const_iterator it = this->baseline.find (baseline_key (m.classes, m.key));
+
+        if (it == this->baseline.end ()) {
+            continue;
+        }
+
+        // Finding fewer vftables is never noise
+        double tolerance = m.key == "recall" || m.key == "vftables" ? 0 : threshold (m.key) / 100.0;
+        bool regressed = m.higher_better ? m.value < it->second * (1.0 - tolerance)
+                                         : m.value > it->second * (1.0 + tolerance);
+
+        if (regressed) {
+            printf ("REGRESSION %u %s : %.2f, baseline %.2f, tolerance %.0f%%\n",
+                    m.classes, m.key.c_str (), m.value, it->second, tolerance * 100.0);
+            regressions++;
+        }
+    }
+
+    return regressions;
+}
+
+int
+BenchDriver::missing (
+    void
+) const {
+    int count = 0;
+
+    for (size_t i = 0; i < this->measures.size (); i++)
+    {
+        const measure_t &m = this->measures[i];
+        if (this->baseline.find (baseline_key (m.classes, m.key)) != this->baseline.end ()) {
+            continue;
+        }
+
+        printf ("NO BASELINE %u %s : %.2f, not checked\n", m.classes, m.key.c_str (), m.value);
+        count++;
+    }
+
+    return count;
+}
+
+bool
+BenchDriver::save_baseline (
+    void
+) const {
+    FILE *fp = fopen (this->opt.baseline.c_str (), "w");
+    if (fp == NULL) {
+        return false;
+    }
+
+    fprintf (fp, "# RECPP scan benchmark baseline, written by RECPPBench --update\n");
+    fprintf (fp, "# seed %u\n", this->opt.seed);
+
+    for (std::map<std::string, double>::const_iterator it = this->thresholds.begin (); it != this->thresholds.end (); ++it) {
+        if (it->first.empty ()) {
+            fprintf (fp, "threshold %g\n", it->second);
+        }
+        else {
+            fprintf (fp, "threshold %s %g\n", it->first.c_str (), it->second);
+        }
+    }
+
+    for (size_t i = 0; i < this->measures.size (); i++) {
+        const measure_t &m = this->measures[i];
+        fprintf (fp, "%u %s %.4f\n", m.classes, m.key.c_str (), m.value);
+    }
+
+    return fclose (fp) == 0;
+}
@@ -0,0 +1,146 @@
+﻿/*
+    ██████╗ ███████╗ ██████╗██████╗ ██████╗ 
+    ██╔══██╗██╔════╝██╔════╝██╔══██╗██╔══██╗
+    ██████╔╝█████╗  ██║     ██████╔╝██████╔╝
+    ██╔══██╗██╔══╝  ██║     ██╔═══╝ ██╔═══╝ 
+    ██║  ██║███████╗╚██████╗██║     ██║     
+    ╚═╝  ╚═╝╚══════╝ ╚═════╝╚═╝     ╚═╝     
+* @license : <license placeholder>
+*/
+
+#pragma once
+
+
+// ---------- Includes ------------
+#include <stdint.h>
+#include <stdio.h>
+#include <map>
+#include <string>
+#include <vector>
+
+// ---------- Defines -------------
+#define BENCH_DEFAULT_THRESHOLD 10.0
+
+
+// ------ Class definition --------
+// End-to-end benchmark of the vftable scan.
+//
+// Every corpus size gets an image from CorpusGen, analysed by idat in batch
+// mode with the plugin in bench mode (see RECPP/Bench.h). The measures read
+// back from the plugin are turned into throughputs per phase, memory and
+// recall, then checked against a baseline file :
+//
+//   threshold <percent>            default tolerance
+//   threshold <key> <percent>      tolerance of one measure (peak_rss_kb ...)
+//   <classes> <key> <value>        one measure of one corpus
+//
+// A phase regresses when its throughput falls more than its tolerance below
+// the baseline, memory when it grows more than its tolerance above it. The
+// recall (vftables of the manifest found by the scan) must never drop. A
+// measure the baseline doesn't hold can't be checked, it is reported apart.
+class BenchDriver
+{
+public:
+    struct options_t
+    {
+        std::string ida;            // idat executable
+        std::string work;           // corpora, databases and results
+        std::string baseline;
+        std::vector<uint32_t> sizes;
+        uint32_t seed;
+        bool update;                // write the measures as the new baseline
+    };
+
+    struct measure_t
+    {
+        uint32_t classes;
+        std::string key;
+        double value;
+        bool higher_better;
+    };
+
+    BenchDriver (const options_t &opt);
+
+    /*
+     * @brief : Generate one corpus, analyse it and collect its measures
+     * @return false if the corpus can't be written or IDA failed
+     */
+    bool
+    run_corpus (
+        uint32_t classes
+    );
+
+    /*
+     * @brief : Print the measures, along with the baseline ones when known
+     */
+    void
+    report (
+        void
+    ) const;
+
+    /*
+     * @brief : Check the measures against the baseline
+     * @return The number of regressions
+     */
+    int
+    compare (
+        void
+    ) const;
+
+    /*
+     * @brief : Report the measures the baseline has no value for
+     * @return Their number
+     */
+    int
+    missing (
+        void
+    ) const;
+
+    /*
+     * @brief : Write the measures as the baseline, keeping its thresholds
+     */
+    bool
+    save_baseline (
+        void
+    ) const;
+
+    bool has_baseline () const { return !this->baseline.empty (); }
+
+private:
+    options_t opt;
+    std::vector<measure_t> measures;
+
+    // "<classes> <key>" -> value, and tolerance per key ("" is the default)
+    std::map<std::string, double> baseline;
+    std::map<std::string, double> thresholds;
+
+    static std::string
+    baseline_key (
+        uint32_t classes,
+        const std::string &key
+    );
+
+    bool
+    load_baseline (
+        void
+    );
+
+    bool
+    load_result (
+        const std::string &path,
+        uint32_t classes
+    );
+
+    double
+    threshold (
+        const std::string &key
+    ) const;
+
+    void
+    add (
+        uint32_t classes,
+        const std::string &key,
+        double value,
+        bool higherBetter
+    );
+};
@@ -0,0 +1,167 @@
+﻿/*
+    ██████╗ ███████╗ ██████╗██████╗ ██████╗ 
+    ██╔══██╗██╔════╝██╔════╝██╔══██╗██╔══██╗
+    ██████╔╝█████╗  ██║     ██████╔╝██████╔╝
+    ██╔══██╗██╔══╝  ██║     ██╔═══╝ ██╔═══╝ 
+    ██║  ██║███████╗╚██████╗██║     ██║     
+    ╚═╝  ╚═╝╚══════╝ ╚═════╝╚═╝     ╚═╝     
+* @license : <license placeholder>
+*/
+
+#include "Legacy.h"
+#include <stdio.h>
+#include <string.h>
+
+
+int
+legacy_str_n_pos (
+    const char *str,
+    const char *search,
+    int len_str
+) {
+	int i,  len_string = len_str,
+            len_search = (int) strlen (search);
+	int count = 0;
+
+	for (i = 0; i < len_string; i++)
+	{
+		if (str[i] == search[count])
+			count++;
+		else
+			count = 0;
+
+		if (count == len_search)
+		{
+			return i - len_search + 1;
+		}
+	}
+
+	return -1;
+}
+
+char *
+legacy_mangle_number (
+    int number,
+    char *buffer,
+    size_t bufferSize
+) {
+    char tmp[2048];
+
+    buffer[0] = '\0';
+    int sign = 0;
+
+    if (number < 0) {
+        sign = 1;
+        number = -number;
+    }
+
+    if (number == 0) {
+        snprintf (buffer, bufferSize, "A@");
+        return buffer;
+    }
+
+    else if (number <= 10) {
+        snprintf (buffer, bufferSize, "%s%d", sign ? "?" : "", number - 1);
+        return buffer;
+    }
+
+    else {
+        while (number > 0)
+        {
+            snprintf (tmp, sizeof (tmp), "%s", buffer);
+            snprintf (buffer, bufferSize, "%c%s", 'A' + (number % 16), tmp);
+            number = number / 16;
+        }
+        snprintf (tmp, sizeof (tmp), "%s", buffer);
+        snprintf (buffer, bufferSize, "%s%s@", sign ? "?" : "", tmp);
+        return buffer;
+    }
+}
+
+void
+legacy_sanitize_name (
+    char *className
+) {
+    char *forbidden;
+    while ((forbidden = strstr (className, "<"))) {
+        *forbidden = '_';
+    }
+    while ((forbidden = strstr (className, ">"))) {
+        *forbidden = '_';
+    }
+    while ((forbidden = strstr (className, " "))) {
+        *forbidden = '_';
+    }
+    while ((forbidden = strstr (className, ","))) {
+        *forbidden = '_';
+    }
+    while ((forbidden = strstr (className, "*"))) {
+        *forbidden = '_';
+    }
+    while ((forbidden = strstr (className, "`"))) {
+        *forbidden = '_';
+    }
+    while ((forbidden = strstr (className, "'"))) {
+        *forbidden = '_';
+    }
+}
+
+bool
+legacy_match_bytes (
+    byte_reader_t read,
+    void *ud,
+    uint32_t address,
+    const char *match
+) {
+    size_t len = strlen(match);
+
+    if (len % 2) { 
+        return false;
+    }
+
+    size_t i = 0;
+    char s[3] = {0};
+    char s2[3] = {0};
+
+    while (i < len)
+    {
+        s[0] = match[i];
+        s[1] = match[i+1];
+        snprintf (s2, sizeof (s2), "%02X", read (ud, address));
+
+        if ((strncmp (s, "??", 2) != 0)
+        &&  (strncmp (s2, s, 2) != 0)
+        ) {
+            // Mismatch
+            return false;
+        }
+
+        i += 2;
+        address++;
+    }
+
+    return true;
+}
+
+char *
+legacy_get_asciiz_str (
+    byte_reader_t read,
+    void *ud,
+    uint32_t address,
+    char *buffer,
+    size_t bufferSize
+) {
+    char curByte;
+    size_t bufferPos = 0;
+
+    while ((curByte = (char) read (ud, address))) {
+        buffer [bufferPos++] = curByte;
+        address++;
+        if (bufferPos > bufferSize) {
+            return NULL;
+        }
+    }
+
+    buffer[bufferPos] = '\0';
+    return buffer;
+}
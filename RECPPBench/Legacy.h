@@ -0,0 +1,70 @@
+﻿/*
+    ██████╗ ███████╗ ██████╗██████╗ ██████╗ 
+    ██╔══██╗██╔════╝██╔════╝██╔══██╗██╔══██╗
+    ██████╔╝█████╗  ██║     ██████╔╝██████╔╝
+    ██╔══██╗██╔══╝  ██║     ██╔═══╝ ██╔═══╝ 
+    ██║  ██║███████╗╚██████╗██║     ██║     
+    ╚═╝  ╚═╝╚══════╝ ╚═════╝╚═╝     ╚═╝     
+* @license : <license placeholder>
+*/
+
+#pragma once
+
+
+// ---------- Includes ------------
+#include <stddef.h>
+#include <stdint.h>
+#include "../RECPP/StrUtils.h"
+
+// ---------- Defines -------------
+
+
+// ------ Function definition --------
+// The string and pattern primitives as they were before StrUtils, kept as
+// the reference the new ones are checked against. Kernel reads go through
+// the callback, one call per byte like get_byte.
+
+int
+legacy_str_n_pos (
+    const char *str,
+    const char *search,
+    int len_str
+);
+
+/*
+ * @brief : IDAUtils::MangleNumber. The original built the digits with
+ *          sprintf (buffer, "%c%s", c, buffer), which is undefined as the
+ *          source and the destination overlap : this one goes through a copy,
+ *          which is what that code meant. 0 also returned a strdup'ed "A@".
+ */
+char *
+legacy_mangle_number (
+    int number,
+    char *buffer,
+    size_t bufferSize
+);
+
+/*
+ * @brief : The strstr loops of Vtable::filterClassName
+ */
+void
+legacy_sanitize_name (
+    char *className
+);
+
+bool
+legacy_match_bytes (
+    byte_reader_t read,
+    void *ud,
+    uint32_t address,
+    const char *match
+);
+
+char *
+legacy_get_asciiz_str (
+    byte_reader_t read,
+    void *ud,
+    uint32_t address,
+    char *buffer,
+    size_t bufferSize
+);
@@ -0,0 +1,505 @@
+﻿/*
+    ██████╗ ███████╗ ██████╗██████╗ ██████╗ 
+    ██╔══██╗██╔════╝██╔════╝██╔══██╗██╔══██╗
+    ██████╔╝█████╗  ██║     ██████╔╝██████╔╝
+    ██╔══██╗██╔══╝  ██║     ██╔═══╝ ██╔═══╝ 
+    ██║  ██║███████╗╚██████╗██║     ██║     
+    ╚═╝  ╚═╝╚══════╝ ╚═════╝╚═╝     ╚═╝     
+* @license : <license placeholder>
+*/
+
+#include "MicroBench.h"
+#include "Legacy.h"
+#include "../RECPP/StrUtils.h"
+#include "../RECPPCorpusGen/CorpusGen.h"
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+
+
+// Patterns of Vtable::checkSDD, in the order it tries them
+static const char *SDD_PATTERNS[] = {
+    "83E9??E9",
+    "81E9????????E9",
+    "568BF1E8????????F64424080174",
+    "568BF1FF15????????F64424080174",
+    "558BEC51894DFC8B4DFCE8????????8B450883E00185C0740C8B4DFC51E8????????83C4048B45FC8BE55DC20400",
+    "558BEC51894DFC8B4DFCE8????????8B450883E00185C074098B4DFC51E8????????8B45FC8BE55DC20400",
+    "568D71??578D7E??8BCFE8????????F644240C01",
+    "568DB1????????578DBE????????8BCFE8????????F644240C01",
+    "F644240401568BF1C706",
+    "8A442404568BF1A801C706",
+    "568BF1C706????????E8????????F64424080174",
+    "538A5C2408568BF1F6C302742B8B46FC578D7EFC68????????506A??56E8",
+    "538A5C2408F6C302568BF1742E8B46FC5768????????8D7EFC5068????????56E8",
+};
+
+static const char *IDENTS[] = {
+    "Widget", "CString", "allocator", "basic_string", "char_traits", "Node", "Stream",
+    "Logger", "ios_base", "CWnd", "IUnknown", "Observer", "Handler", "exception", "CObject"
+};
+
+static const char *NAMESPACES[] = {
+    "std", "boost", "detail", "Gfx", "ATL", "Concurrency"
+};
+
+// Keeps the compiler from dropping the measured calls
+static volatile uint64_t sink;
+
+template <typename Fn>
+static double
+time_ns (
+    uint32_t iterations,
+    size_t opsPerIteration,
+    Fn fn
+) {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+
+    for (uint32_t i = 0; i < iterations; i++) {
+        fn ();
+    }
+
+    std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now () - start;
+    double ns = (double) std::chrono::duration_cast<std::chrono::nanoseconds> (elapsed).count ();
+
+    return opsPerIteration != 0 ? ns / ((double) iterations * opsPerIteration) : 0;
+}
+
+
+MicroBench::MicroBench (uint32_t seed, uint32_t iterations) {
+    this->seed = seed;
+    this->rng = seed != 0 ? seed : 1;
+    this->iterations = iterations != 0 ? iterations : MICRO_DEFAULT_ITERATIONS;
+    this->image.base = 0;
+    this->image.reads = 0;
+}
+
+uint32_t
+MicroBench::next_random (
+    uint32_t range
+) {
+    this->rng ^= this->rng << 13;
+    this->rng ^= this->rng >> 17;
+    this->rng ^= this->rng << 5;
+
+    return range != 0 ? this->rng % range : this->rng;
+}
+
+// Decorated class name : Widget@, Widget@std@, ?$basic_string@VNode@@@std@ ...
+std::string
+MicroBench::random_class (
+    void
+) {
+    const size_t identCount = sizeof (IDENTS) / sizeof (IDENTS[0]);
+    const size_t nsCount = sizeof (NAMESPACES) / sizeof (NAMESPACES[0]);
+
+    std::string name;
+    uint32_t kind = next_random (100);
+
+    if (kind < 70) {
+        name = std::string (IDENTS[next_random (identCount)]) + "@";
+    }
+    else {
+        // Template, its arguments are builtins or classes
+        name = std::string ("?$") + IDENTS[next_random (identCount)] + "@";
+        for (uint32_t n = 1 + next_random (2); n > 0; n--) {
+            switch (next_random (3)) {
+            case 0: name += "H"; break;
+            case 1: name += "D"; break;
+            case 2: name += std::string ("V") + IDENTS[next_random (identCount)] + "@@"; break;
+            }
+        }
+        name += "@";
+    }
+
+    if (next_random (100) < 40) {
+        name += std::string (NAMESPACES[next_random (nsCount)]) + "@";
+    }
+
+    return name;
+}
+
+void
+MicroBench::make_inputs (
+    void
+) {
+    const size_t identCount = sizeof (IDENTS) / sizeof (IDENTS[0]);
+    const size_t nsCount = sizeof (NAMESPACES) / sizeof (NAMESPACES[0]);
+
+    // ??_7<class>@6B@ and ??_7<class>@6B<base>@@ for the secondary vftables
+    for (int i = 0; i < 4000; i++)
+    {
+        std::string name = "??_7" + random_class () + "@6B";
+        if (next_random (100) < 20) {
+            name += random_class () + "@@";
+        }
+        else {
+            name += "@";
+        }
+        this->mangled.push_back (name);
+    }
+
+    // Demangled : Gfx::Widget::`vftable', std::basic_string<char,struct std::char_traits<char> >::`vftable'{for `Node'}
+    for (int i = 0; i < 4000; i++)
+    {
+        std::string name;
+        if (next_random (100) < 10) {
+            name = "const ";
+        }
+        if (next_random (100) < 40) {
+            name += std::string (NAMESPACES[next_random (nsCount)]) + "::";
+        }
+        name += IDENTS[next_random (identCount)];
+
+        if (next_random (100) < 35) {
+            name += "<char,struct std::char_traits<char> ,class std::allocator<";
+            name += IDENTS[next_random (identCount)];
+            name += " *> >";
+        }
+
+        name += "::`vftable'";
+        if (next_random (100) < 20) {
+            name += std::string ("{for `") + IDENTS[next_random (identCount)] + "'}";
+        }
+        this->demangled.push_back (name);
+    }
+
+    // mdisp, pdisp, vdisp and attributes of base class descriptors
+    for (int i = 0; i < 4000; i++)
+    {
+        uint32_t kind = next_random (100);
+        int value;
+
+        if (kind < 50) {
+            value = 0;
+        }
+        else if (kind < 80) {
+            value = 4 * (1 + (int) next_random (16));
+        }
+        else if (kind < 90) {
+            value = -1;
+        }
+        else if (kind < 95) {
+            value = 0x40;
+        }
+        else {
+            value = (int) next_random (0x10000) - 0x100;
+        }
+        this->numbers.push_back (value);
+    }
+
+    // Slots and type descriptors of a synthetic corpus
+    CorpusGen::options_t opt;
+    CorpusGen::default_options (&opt);
+    opt.classes = 2000;
+    opt.seed = this->seed;
+
+    CorpusGen gen (opt);
+    gen.generate ();
+    gen.slot_targets (&this->functions);
+    gen.type_descriptors (&this->type_names);
+
+    // One flat image, the sections at their address
+    static const char *sections[] = { ".text", ".rdata", ".data" };
+    uint32_t end = 0;
+    for (int s = 0; s < 3; s++)
+    {
+        uint32_t va;
+        const std::vector<uint8_t> *bytes = gen.section (sections[s], &va);
+
+        if (this->image.base == 0) {
+            this->image.base = va;
+        }
+
+        end = va - this->image.base + (uint32_t) bytes->size ();
+        this->image.bytes.resize (end, 0);
+        memcpy (&this->image.bytes[va - this->image.base], &(*bytes)[0], bytes->size ());
+    }
+
+    for (size_t i = 0; i < this->type_names.size (); i++) {
+        this->type_names[i] += 8;
+    }
+}
+
+uint8_t
+MicroBench::read_byte (
+    void *ud,
+    uint32_t address
+) {
+    image_t *image = (image_t *) ud;
+    image->reads++;
+
+    uint32_t off = address - image->base;
+    return off < image->bytes.size () ? image->bytes[off] : 0xFF;
+}
+
+int
+MicroBench::read_bytes (
+    void *ud,
+    uint8_t *buffer,
+    size_t size,
+    uint32_t address
+) {
+    image_t *image = (image_t *) ud;
+    image->reads++;
+
+    uint32_t off = address - image->base;
+    if (off >= image->bytes.size ()) {
+        return -1;
+    }
+
+    size_t avail = image->bytes.size () - off;
+    if (size > avail) {
+        size = avail;
+    }
+
+    memcpy (buffer, &image->bytes[off], size);
+    return (int) size;
+}
+
+void
+MicroBench::print (
+    const char *name,
+    double oldNs,
+    double newNs,
+    uint64_t oldReads,
+    uint64_t newReads
+) const {
+    if (oldReads != 0 || newReads != 0) {
+        printf ("%-16s %10.1f %10.1f %8.1fx %12llu %12llu\n", name, oldNs, newNs,
+                newNs != 0 ? oldNs / newNs : 0, (unsigned long long) oldReads, (unsigned long long) newReads);
+    }
+    else {
+        printf ("%-16s %10.1f %10.1f %8.1fx %12s %12s\n", name, oldNs, newNs,
+                newNs != 0 ? oldNs / newNs : 0, "-", "-");
+    }
+}
+
+int
+MicroBench::bench_str_pos (
+    void
+) {
+    int errors = 0, legacyMisses = 0;
+
+    for (size_t i = 0; i < this->mangled.size (); i++)
+    {
+        const std::string &s = this->mangled[i];
+        const char *hit = strstr (s.c_str (), "@@6B");
+        int expected = hit != NULL ? (int) (hit - s.c_str ()) : -1;
+
+        if (str_find (s.c_str (), s.size (), "@@6B") != expected) {
+            printf ("str_pos mismatch on %s\n", s.c_str ());
+            errors++;
+        }
+
+        // The legacy search doesn't step back after a partial match : @@@6B is missed
+        if (legacy_str_n_pos (s.c_str (), "@@6B", (int) s.size ()) != expected) {
+            legacyMisses++;
+        }
+    }
+
+    double oldNs = time_ns (this->iterations, this->mangled.size (), [&] () {
+        for (size_t i = 0; i < this->mangled.size (); i++) {
+            sink += legacy_str_n_pos (this->mangled[i].c_str (), "@@6B", (int) this->mangled[i].size ());
+        }
+    });
+
+    double newNs = time_ns (this->iterations, this->mangled.size (), [&] () {
+        for (size_t i = 0; i < this->mangled.size (); i++) {
+            sink += str_find (this->mangled[i].c_str (), this->mangled[i].size (), "@@6B");
+        }
+    });
+
+    print ("str_pos", oldNs, newNs, 0, 0);
+    if (legacyMisses != 0) {
+        printf ("  legacy str_n_pos missed %d of %d names (partial match before the real one)\n",
+                legacyMisses, (int) this->mangled.size ());
+    }
+
+    return errors;
+}
+
+int
+MicroBench::bench_sanitize (
+    void
+) {
+    int errors = 0;
+    char a[1024], b[1024];
+
+    for (size_t i = 0; i < this->demangled.size (); i++)
+    {
+        snprintf (a, sizeof (a), "%s", this->demangled[i].c_str ());
+        snprintf (b, sizeof (b), "%s", this->demangled[i].c_str ());
+        legacy_sanitize_name (a);
+        sanitize_name (b);
+
+        if (strcmp (a, b) != 0) {
+            printf ("filterClassName mismatch on %s : %s / %s\n", this->demangled[i].c_str (), a, b);
+            errors++;
+        }
+    }
+
+    double oldNs = time_ns (this->iterations, this->demangled.size (), [&] () {
+        for (size_t i = 0; i < this->demangled.size (); i++) {
+            memcpy (a, this->demangled[i].c_str (), this->demangled[i].size () + 1);
+            legacy_sanitize_name (a);
+            sink += a[0];
+        }
+    });
+
+    double newNs = time_ns (this->iterations, this->demangled.size (), [&] () {
+        for (size_t i = 0; i < this->demangled.size (); i++) {
+            memcpy (b, this->demangled[i].c_str (), this->demangled[i].size () + 1);
+            sanitize_name (b);
+            sink += b[0];
+        }
+    });
+
+    print ("filterClassName", oldNs, newNs, 0, 0);
+    return errors;
+}
+
+int
+MicroBench::bench_mangle (
+    void
+) {
+    int errors = 0;
+    char a[2048], b[2048];
+
+    // The distribution, then the edges
+    std::vector<int> checked (this->numbers);
+    static const int edges[] = { 0, 1, 10, 11, 15, 16, 17, 255, 256, 0x7FFFFFFF, -1, -10, -11, -0x7FFFFFFF };
+    checked.insert (checked.end (), edges, edges + sizeof (edges) / sizeof (edges[0]));
+
+    for (size_t i = 0; i < checked.size (); i++)
+    {
+        legacy_mangle_number (checked[i], a, sizeof (a));
+        mangle_number (checked[i], b, sizeof (b));
+
+        if (strcmp (a, b) != 0) {
+            printf ("MangleNumber mismatch on %d : %s / %s\n", checked[i], a, b);
+            errors++;
+        }
+    }
+
+    double oldNs = time_ns (this->iterations, this->numbers.size (), [&] () {
+        for (size_t i = 0; i < this->numbers.size (); i++) {
+            sink += legacy_mangle_number (this->numbers[i], a, sizeof (a))[0];
+        }
+    });
+
+    double newNs = time_ns (this->iterations, this->numbers.size (), [&] () {
+        for (size_t i = 0; i < this->numbers.size (); i++) {
+            sink += mangle_number (this->numbers[i], b, sizeof (b))[0];
+        }
+    });
+
+    print ("MangleNumber", oldNs, newNs, 0, 0);
+    return errors;
+}
+
+int
+MicroBench::bench_match (
+    void
+) {
+    const size_t patternCount = sizeof (SDD_PATTERNS) / sizeof (SDD_PATTERNS[0]);
+    int errors = 0, matches = 0;
+
+    for (size_t f = 0; f < this->functions.size (); f++) {
+        for (size_t p = 0; p < patternCount; p++)
+        {
+            bool a = legacy_match_bytes (read_byte, &this->image, this->functions[f], SDD_PATTERNS[p]);
+            bool b = match_bytes (read_bytes, read_byte, &this->image, this->functions[f], SDD_PATTERNS[p]);
+
+            if (a != b) {
+                printf ("matchBytes mismatch at 0x%X on %s\n", this->functions[f], SDD_PATTERNS[p]);
+                errors++;
+            }
+            matches += b;
+        }
+    }
+
+    size_t ops = this->functions.size () * patternCount;
+
+    this->image.reads = 0;
+    double oldNs = time_ns (this->iterations, ops, [&] () {
+        for (size_t f = 0; f < this->functions.size (); f++) {
+            for (size_t p = 0; p < patternCount; p++) {
+                sink += legacy_match_bytes (read_byte, &this->image, this->functions[f], SDD_PATTERNS[p]);
+            }
+        }
+    });
+    uint64_t oldReads = this->image.reads / this->iterations;
+
+    this->image.reads = 0;
+    double newNs = time_ns (this->iterations, ops, [&] () {
+        for (size_t f = 0; f < this->functions.size (); f++) {
+            for (size_t p = 0; p < patternCount; p++) {
+                sink += match_bytes (read_bytes, read_byte, &this->image, this->functions[f], SDD_PATTERNS[p]);
+            }
+        }
+    });
+    uint64_t newReads = this->image.reads / this->iterations;
+
+    print ("matchBytes", oldNs, newNs, oldReads, newReads);
+    printf ("  %d matches over %d slots\n", matches, (int) this->functions.size ());
+
+    return errors;
+}
+
+int
+MicroBench::bench_asciiz (
+    void
+) {
+    int errors = 0;
+    char a[4096], b[4096];
+
+    for (size_t i = 0; i < this->type_names.size (); i++)
+    {
+        const char *sa = legacy_get_asciiz_str (read_byte, &this->image, this->type_names[i], a, sizeof (a) - 1);
+        const char *sb = get_asciiz_str (read_bytes, read_byte, &this->image, this->type_names[i], b, sizeof (b));
+
+        if ((sa == NULL) != (sb == NULL) || (sa != NULL && strcmp (sa, sb) != 0)) {
+            printf ("GetAsciizStr mismatch at 0x%X\n", this->type_names[i]);
+            errors++;
+        }
+    }
+
+    this->image.reads = 0;
+    double oldNs = time_ns (this->iterations, this->type_names.size (), [&] () {
+        for (size_t i = 0; i < this->type_names.size (); i++) {
+            sink += legacy_get_asciiz_str (read_byte, &this->image, this->type_names[i], a, sizeof (a) - 1)[0];
+        }
+    });
+    uint64_t oldReads = this->image.reads / this->iterations;
+
+    this->image.reads = 0;
+    double newNs = time_ns (this->iterations, this->type_names.size (), [&] () {
+        for (size_t i = 0; i < this->type_names.size (); i++) {
+            sink += get_asciiz_str (read_bytes, read_byte, &this->image, this->type_names[i], b, sizeof (b))[0];
+        }
+    });
+    uint64_t newReads = this->image.reads / this->iterations;
+
+    print ("GetAsciizStr", oldNs, newNs, oldReads, newReads);
+    return errors;
+}
+
+int
+MicroBench::run (
+    void
+) {
+    make_inputs ();
+
+    printf ("%-16s %10s %10s %9s %12s %12s\n", "primitive", "old ns/op", "new ns/op", "speedup", "old reads", "new reads");
+
+    int errors = 0;
+    errors += bench_str_pos ();
+    errors += bench_sanitize ();
+    errors += bench_mangle ();
+    errors += bench_match ();
+    errors += bench_asciiz ();
+
+    printf ("%d output(s) differ from the legacy implementations\n", errors);
+    return errors;
+}
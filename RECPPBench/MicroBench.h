@@ -0,0 +1,115 @@
+﻿/*
+    ██████╗ ███████╗ ██████╗██████╗ ██████╗ 
+    ██╔══██╗██╔════╝██╔════╝██╔══██╗██╔══██╗
+    ██████╔╝█████╗  ██║     ██████╔╝██████╔╝
+    ██╔══██╗██╔══╝  ██║     ██╔═══╝ ██╔═══╝ 
+    ██║  ██║███████╗╚██████╗██║     ██║     
+    ╚═╝  ╚═╝╚══════╝ ╚═════╝╚═╝     ╚═╝     
+* @license : <license placeholder>
+*/
+
+#pragma once
+
+
+// ---------- Includes ------------
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+// ---------- Defines -------------
+#define MICRO_DEFAULT_ITERATIONS 200
+
+
+// ------ Class definition --------
+// Microbenchmarks of the string and pattern primitives, new (StrUtils)
+// against legacy (Legacy.h), over inputs shaped like what a scan of an
+// MSVC binary feeds them :
+//
+//   str_pos         "@@6B" in decorated vftable names, templates included
+//   filterClassName forbidden characters of demangled vftable names
+//   MangleNumber    base class displacements and attributes
+//   matchBytes      the `scalar deleting destructor' patterns of
+//                   Vtable::checkSDD on every slot of a synthetic corpus
+//   GetAsciizStr    the type descriptor names of the same corpus
+//
+// Every output of the new code is checked against the legacy one, the run
+// fails on the first difference. Reads of the image are counted, they
+// stand for the kernel calls of the plugin.
+class MicroBench
+{
+public:
+    MicroBench (uint32_t seed, uint32_t iterations);
+
+    /*
+     * @brief : Validate and time every primitive
+     * @return The number of outputs that differ from the legacy ones
+     */
+    int
+    run (
+        void
+    );
+
+private:
+    // Bytes of the corpus image, and the number of reads they served
+    struct image_t
+    {
+        uint32_t base;
+        std::vector<uint8_t> bytes;
+        uint64_t reads;
+    };
+
+    uint32_t seed;
+    uint32_t rng;
+    uint32_t iterations;
+    image_t image;
+
+    std::vector<std::string> mangled;
+    std::vector<std::string> demangled;
+    std::vector<int> numbers;
+    std::vector<uint32_t> functions;
+    std::vector<uint32_t> type_names;
+
+    uint32_t
+    next_random (
+        uint32_t range
+    );
+
+    std::string
+    random_class (
+        void
+    );
+
+    void
+    make_inputs (
+        void
+    );
+
+    static uint8_t
+    read_byte (
+        void *ud,
+        uint32_t address
+    );
+
+    static int
+    read_bytes (
+        void *ud,
+        uint8_t *buffer,
+        size_t size,
+        uint32_t address
+    );
+
+    void
+    print (
+        const char *name,
+        double oldNs,
+        double newNs,
+        uint64_t oldReads,
+        uint64_t newReads
+    ) const;
+
+    int bench_str_pos ();
+    int bench_sanitize ();
+    int bench_mangle ();
+    int bench_match ();
+    int bench_asciiz ();
+};
@@ -0,0 +1,145 @@
+﻿/*
+    ██████╗ ███████╗ ██████╗██████╗ ██████╗ 
+    ██╔══██╗██╔════╝██╔════╝██╔══██╗██╔══██╗
+    ██████╔╝█████╗  ██║     ██████╔╝██████╔╝
+    ██╔══██╗██╔══╝  ██║     ██╔═══╝ ██╔═══╝ 
+    ██║  ██║███████╗╚██████╗██║     ██║     
+    ╚═╝  ╚═╝╚══════╝ ╚═════╝╚═╝     ╚═╝     
+* @license : <license placeholder>
+*/
+
+#include "BenchDriver.h"
+#include "MicroBench.h"
+#include <stdlib.h>
+#include <string.h>
+
+
+static void
+usage (
+    void
+) {
+    printf ("usage: RECPPBench --ida <idat.exe> [options]\n");
+    printf ("       RECPPBench --micro [--iterations N] [--seed N]\n");
+    printf ("  --sizes N,N,...     classes of each corpus (1000,10000,50000)\n");
+    printf ("  --seed N            corpus seed (1)\n");
+    printf ("  --work DIR          corpora, databases and results (.)\n");
+    printf ("  --baseline PATH     baseline file (baseline.txt)\n");
+    printf ("  --update            store the measures as the new baseline\n");
+    printf ("  --micro             string and pattern primitives against their legacy versions\n");
+    printf ("  --iterations N      passes over the microbenchmark inputs (%d)\n", MICRO_DEFAULT_ITERATIONS);
+    printf ("Exit code : 0 ok, 1 regression, 2 error, 3 measures missing from the baseline\n");
+}
+
+int
+main (
+    int argc,
+    char **argv
+) {
+    BenchDriver::options_t opt;
+    opt.work = ".";
+    opt.baseline = "baseline.txt";
+    opt.seed = 1;
+    opt.update = false;
+
+    bool micro = false;
+    uint32_t iterations = MICRO_DEFAULT_ITERATIONS;
+
+    const char *sizes = "1000,10000,50000";
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char *arg = argv[i];
+        bool more = i + 1 < argc;
+
+        if (!strcmp (arg, "--ida") && more) {
+            opt.ida = argv[++i];
+        }
+        else if (!strcmp (arg, "--sizes") && more) {
+            sizes = argv[++i];
+        }
+        else if (!strcmp (arg, "--seed") && more) {
+            opt.seed = (uint32_t) strtoul (argv[++i], NULL, 0);
+        }
+        else if (!strcmp (arg, "--work") && more) {
+            opt.work = argv[++i];
+        }
+        else if (!strcmp (arg, "--baseline") && more) {
+            opt.baseline = argv[++i];
+        }
+        else if (!strcmp (arg, "--update")) {
+            opt.update = true;
+        }
+        else if (!strcmp (arg, "--micro")) {
+            micro = true;
+        }
+        else if (!strcmp (arg, "--iterations") && more) {
+            iterations = (uint32_t) strtoul (argv[++i], NULL, 0);
+        }
+        else {
+            usage ();
+            return 2;
+        }
+    }
+
+    for (char *end; *sizes != '\0'; sizes = *end == ',' ? end + 1 : end) {
+        uint32_t n = (uint32_t) strtoul (sizes, &end, 0);
+        if (end == sizes) {
+            break;
+        }
+        if (n != 0) {
+            opt.sizes.push_back (n);
+        }
+    }
+
+    if (micro) {
+        MicroBench bench (opt.seed, iterations);
+        return bench.run () != 0 ? 1 : 0;
+    }
+
+    if (opt.ida.empty () || opt.sizes.empty ()) {
+        usage ();
+        return 2;
+    }
+
+    BenchDriver driver (opt);
+
+    for (size_t i = 0; i < opt.sizes.size (); i++) {
+        if (!driver.run_corpus (opt.sizes[i])) {
+            return 2;
+        }
+    }
+
+    driver.report ();
+
+    if (opt.update) {
+        if (!driver.save_baseline ()) {
+            fprintf (stderr, "Cannot write %s\n", opt.baseline.c_str ());
+            return 2;
+        }
+        printf ("Baseline written to %s\n", opt.baseline.c_str ());
+        return 0;
+    }
+
+    if (!driver.has_baseline ()) {
+        fprintf (stderr, "WARNING : no baseline in %s, nothing was checked. Run with --update to record one\n",
+                 opt.baseline.c_str ());
+        return 3;
+    }
+
+    int regressions = driver.compare ();
+    int missing = driver.missing ();
+    printf ("%d regression(s), %d measure(s) without baseline\n", regressions, missing);
+
+    if (regressions != 0) {
+        return 1;
+    }
+
+    // A baseline that doesn't cover the run lets regressions through silently
+    if (missing != 0) {
+        fprintf (stderr, "WARNING : %d measure(s) missing from %s, run with --update to record them\n",
+                 missing, opt.baseline.c_str ());
+        return 3;
+    }
+
+    return 0;
+}
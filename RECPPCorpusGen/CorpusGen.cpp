@@ -0,0 +1,941 @@
+﻿/*
+    ██████╗ ███████╗ ██████╗██████╗ ██████╗ 
+    ██╔══██╗██╔════╝██╔════╝██╔══██╗██╔══██╗
+    ██████╔╝█████╗  ██║     ██████╔╝██████╔╝
+    ██╔══██╗██╔══╝  ██║     ██╔═══╝ ██╔═══╝ 
+    ██║  ██║███████╗╚██████╗██║     ██║     
+    ╚═╝  ╚═╝╚══════╝ ╚═════╝╚═╝     ╚═╝     
+* @license : <license placeholder>
+*/
+
+#include "CorpusGen.h"
+#include <string.h>
+
+
+static const char *SHAPE_NAMES[CorpusGen::DTOR_COUNT] = {
+    "call", "import", "frame", "frame_short", "inline_test", "inline_al",
+    "inline_call", "jmp", "vector", "lea8", "lea32"
+};
+
+static const char *KIND_NAMES[] = {
+    "own", "inherited", "icf", "thunk", "dtor"
+};
+
+// Bodies of the functions folded by the linker : return 0, return 1,
+// return this, nop, _purecall ...
+static const char *ICF_BODIES[CORPUS_ICF_POOL] = {
+    "33C0C3", "B801000000C3", "8BC1C3", "C3", "CCC3", "C20400", "32C0C3", "B001C3"
+};
+
+
+void
+CorpusGen::default_options (
+    options_t *opt
+) {
+    opt->classes = 1000;
+    opt->max_depth = 6;
+    opt->min_methods = 1;
+    opt->max_methods = 8;
+    opt->mi_percent = 15;
+    opt->vi_percent = 25;
+    opt->icf_percent = 10;
+    opt->override_percent = 30;
+    opt->seed = 1;
+    opt->raw = false;
+}
+
+CorpusGen::CorpusGen (const options_t &opt) {
+    this->opt = opt;
+    this->rng = opt.seed != 0 ? opt.seed : 1;
+    this->method_count = 0;
+
+    this->sections[SEC_TEXT].name = ".text";
+    this->sections[SEC_TEXT].characteristics = 0x60000020;   // code, execute, read
+    this->sections[SEC_RDATA].name = ".rdata";
+    this->sections[SEC_RDATA].characteristics = 0x40000040;  // initialized data, read
+    this->sections[SEC_DATA].name = ".data";
+    this->sections[SEC_DATA].characteristics = 0xC0000040;   // initialized data, read, write
+
+    for (int s = 0; s < SEC_COUNT; s++) {
+        this->sections[s].rva = 0;
+    }
+}
+
+const char *
+CorpusGen::shape_name (
+    int shape
+) {
+    return shape >= 0 && shape < DTOR_COUNT ? SHAPE_NAMES[shape] : "?";
+}
+
+// xorshift32, the corpus only depends on the seed
+uint32_t
+CorpusGen::next_random (
+    uint32_t range
+) {
+    this->rng ^= this->rng << 13;
+    this->rng ^= this->rng >> 17;
+    this->rng ^= this->rng << 5;
+
+    return range != 0 ? this->rng % range : this->rng;
+}
+
+int
+CorpusGen::new_symbol (
+    void
+) {
+    symbol_t sym = { -1, 0 };
+    this->symbols.push_back (sym);
+
+    return (int) this->symbols.size () - 1;
+}
+
+void
+CorpusGen::define (
+    int symbol,
+    int sec
+) {
+    this->symbols[symbol].sec = sec;
+    this->symbols[symbol].off = (uint32_t) this->sections[sec].bytes.size ();
+}
+
+int
+CorpusGen::here (
+    int sec
+) {
+    int sym = new_symbol ();
+    define (sym, sec);
+
+    return sym;
+}
+
+void
+CorpusGen::emit (
+    int sec,
+    const char *hex
+) {
+    std::vector<uint8_t> &bytes = this->sections[sec].bytes;
+
+    for (; hex[0] != '\0' && hex[1] != '\0'; hex += 2) {
+        unsigned int b;
+        sscanf (hex, "%2x", &b);
+        bytes.push_back ((uint8_t) b);
+    }
+}
+
+void
+CorpusGen::emit32 (
+    int sec,
+    uint32_t value
+) {
+    std::vector<uint8_t> &bytes = this->sections[sec].bytes;
+
+    for (int i = 0; i < 4; i++) {
+        bytes.push_back ((uint8_t) (value >> (i * 8)));
+    }
+}
+
+void
+CorpusGen::emit_abs (
+    int sec,
+    int target
+) {
+    fixup_t fix = { sec, (uint32_t) this->sections[sec].bytes.size (), target, false };
+    this->fixups.push_back (fix);
+    emit32 (sec, 0);
+}
+
+void
+CorpusGen::emit_rel (
+    int sec,
+    int target
+) {
+    fixup_t fix = { sec, (uint32_t) this->sections[sec].bytes.size (), target, true };
+    this->fixups.push_back (fix);
+    emit32 (sec, 0);
+}
+
+void
+CorpusGen::align (
+    int sec,
+    uint32_t alignment,
+    uint8_t fill
+) {
+    std::vector<uint8_t> &bytes = this->sections[sec].bytes;
+
+    while (bytes.size () % alignment != 0) {
+        bytes.push_back (fill);
+    }
+}
+
+// mov eax, <unique id> / ret
+int
+CorpusGen::emit_method (
+    void
+) {
+    align (SEC_TEXT, 16, 0xCC);
+    int sym = here (SEC_TEXT);
+
+    emit (SEC_TEXT, "B8");
+    emit32 (SEC_TEXT, 0x1000 + this->method_count++);
+    emit (SEC_TEXT, "C3");
+
+    return sym;
+}
+
+// Adjustor thunk : sub ecx, <adjust> / jmp target
+int
+CorpusGen::emit_thunk (
+    uint32_t adjust,
+    int target
+) {
+    align (SEC_TEXT, 16, 0xCC);
+    int sym = here (SEC_TEXT);
+
+    if (adjust < 0x80) {
+        emit (SEC_TEXT, "83E9");
+        this->sections[SEC_TEXT].bytes.push_back ((uint8_t) adjust);
+    }
+    else {
+        emit (SEC_TEXT, "81E9");
+        emit32 (SEC_TEXT, adjust);
+    }
+
+    emit (SEC_TEXT, "E9");
+    emit_rel (SEC_TEXT, target);
+
+    return sym;
+}
+
+// mov [reg + offset], vftable for every vftable of the class
+void
+CorpusGen::emit_vftable_stores (
+    int c,
+    uint8_t reg
+) {
+    const class_t &k = this->classes[c];
+    std::vector<uint8_t> &bytes = this->sections[SEC_TEXT].bytes;
+
+    for (size_t v = 0; v < k.vftables.size (); v++)
+    {
+        uint32_t offset = k.vftables[v].offset;
+
+        bytes.push_back (0xC7);
+        if (offset == 0) {
+            bytes.push_back (reg);
+        }
+        else if (offset < 0x80) {
+            bytes.push_back ((uint8_t) (0x40 | reg));
+            bytes.push_back ((uint8_t) offset);
+        }
+        else {
+            bytes.push_back ((uint8_t) (0x80 | reg));
+            emit32 (SEC_TEXT, offset);
+        }
+
+        emit_abs (SEC_TEXT, k.vftables[v].symbol);
+    }
+}
+
+void
+CorpusGen::emit_sdd (
+    int c,
+    int shape
+) {
+    class_t &k = this->classes[c];
+    int vftable = k.vftables[0].symbol;
+
+    // ~class of the base, for the shapes calling it after an inlined vftable store
+    int baseDtor = k.primary != -1 ? this->classes[k.primary].dtor : k.dtor;
+
+    align (SEC_TEXT, 16, 0xCC);
+
+    if (shape == DTOR_JMP) {
+        // Incremental linking : the slot points to a jump to the real body
+        int body = new_symbol ();
+        define (k.sdd, SEC_TEXT);
+        emit (SEC_TEXT, "E9");
+        emit_rel (SEC_TEXT, body);
+        align (SEC_TEXT, 16, 0xCC);
+        define (body, SEC_TEXT);
+        shape = DTOR_CALL;
+    }
+    else {
+        define (k.sdd, SEC_TEXT);
+    }
+
+    switch (shape)
+    {
+    case DTOR_CALL:
+        emit (SEC_TEXT, "568BF1E8");
+        emit_rel (SEC_TEXT, k.dtor);
+        emit (SEC_TEXT, "F64424080174075" "6E8");
+        emit_rel (SEC_TEXT, this->op_delete);
+        emit (SEC_TEXT, "598BC65EC20400");
+        break;
+
+    case DTOR_IMPORT:
+        k.iat = new_symbol ();
+        emit (SEC_TEXT, "568BF1FF15");
+        emit_abs (SEC_TEXT, k.iat);
+        emit (SEC_TEXT, "F644240801740756E8");
+        emit_rel (SEC_TEXT, this->op_delete);
+        emit (SEC_TEXT, "598BC65EC20400");
+        break;
+
+    case DTOR_FRAME:
+    case DTOR_FRAME_SHORT:
+        emit (SEC_TEXT, "558BEC51894DFC8B4DFCE8");
+        emit_rel (SEC_TEXT, k.dtor);
+        emit (SEC_TEXT, shape == DTOR_FRAME ? "8B450883E00185C0740C8B4DFC51E8"
+                                            : "8B450883E00185C074098B4DFC51E8");
+        emit_rel (SEC_TEXT, this->op_delete);
+        if (shape == DTOR_FRAME) {
+            emit (SEC_TEXT, "83C404");
+        }
+        emit (SEC_TEXT, "8B45FC8BE55DC20400");
+        break;
+
+    case DTOR_INLINE_TEST:
+        emit (SEC_TEXT, "F644240401568BF1C706");
+        emit_abs (SEC_TEXT, vftable);
+        emit (SEC_TEXT, "740756E8");
+        emit_rel (SEC_TEXT, this->op_delete);
+        emit (SEC_TEXT, "598BC65EC20400");
+        break;
+
+    case DTOR_INLINE_AL:
+        emit (SEC_TEXT, "8A442404568BF1A801C706");
+        emit_abs (SEC_TEXT, vftable);
+        emit (SEC_TEXT, "740756E8");
+        emit_rel (SEC_TEXT, this->op_delete);
+        emit (SEC_TEXT, "598BC65EC20400");
+        break;
+
+    case DTOR_INLINE_CALL:
+        emit (SEC_TEXT, "568BF1C706");
+        emit_abs (SEC_TEXT, vftable);
+        emit (SEC_TEXT, "E8");
+        emit_rel (SEC_TEXT, baseDtor);
+        emit (SEC_TEXT, "F644240801740756E8");
+        emit_rel (SEC_TEXT, this->op_delete);
+        emit (SEC_TEXT, "598BC65EC20400");
+        break;
+
+    case DTOR_VECTOR:
+        // Array path : `eh vector destructor iterator'(ptr, size, count, ~class)
+        emit (SEC_TEXT, "538A5C2408568BF1F6C302742B8B46FC578D7EFC68");
+        emit_abs (SEC_TEXT, k.dtor);
+        emit (SEC_TEXT, "506A");
+        this->sections[SEC_TEXT].bytes.push_back ((uint8_t) k.size);
+        emit (SEC_TEXT, "56E8");
+        emit_rel (SEC_TEXT, this->vec_iterator);
+        emit (SEC_TEXT, "F6C301740757E8");
+        emit_rel (SEC_TEXT, this->op_delete);
+        emit (SEC_TEXT, "598BC75F5E5BC204009090");
+        // Scalar path
+        emit (SEC_TEXT, "8BCEE8");
+        emit_rel (SEC_TEXT, k.dtor);
+        emit (SEC_TEXT, "F6C301740756E8");
+        emit_rel (SEC_TEXT, this->op_delete);
+        emit (SEC_TEXT, "598BC65E5BC20400");
+        break;
+
+    case DTOR_LEA8:
+        emit (SEC_TEXT, "568D71FC578D7E048BCFE8");
+        emit_rel (SEC_TEXT, k.dtor);
+        emit (SEC_TEXT, "F644240C01740756E8");
+        emit_rel (SEC_TEXT, this->op_delete);
+        emit (SEC_TEXT, "598BC75F5EC20400");
+        break;
+
+    case DTOR_LEA32:
+        emit (SEC_TEXT, "568DB1");
+        emit32 (SEC_TEXT, (uint32_t) -(int32_t) (k.size - 4));
+        emit (SEC_TEXT, "578DBE");
+        emit32 (SEC_TEXT, k.size - 4);
+        emit (SEC_TEXT, "8BCFE8");
+        emit_rel (SEC_TEXT, k.dtor);
+        emit (SEC_TEXT, "F644240C01740756E8");
+        emit_rel (SEC_TEXT, this->op_delete);
+        emit (SEC_TEXT, "598BC75F5EC20400");
+        break;
+    }
+}
+
+void
+CorpusGen::build_class (
+    int c
+) {
+    class_t &k = this->classes[c];
+
+    char name[32];
+    snprintf (name, sizeof (name), "C%d", c);
+    k.name = name;
+
+    // Primary base : any earlier class that keeps the chain short enough
+    k.primary = -1;
+    k.depth = 0;
+    if (c > 0 && next_random (100) >= 15) {
+        for (int attempt = 0; attempt < 8; attempt++) {
+            int b = (int) next_random ((uint32_t) c);
+            if ((uint32_t) this->classes[b].depth + 1 <= this->opt.max_depth) {
+                k.primary = b;
+                k.depth = this->classes[b].depth + 1;
+                break;
+            }
+        }
+    }
+
+    // Second base, must not already be one of the primary's bases
+    k.second = -1;
+    k.virtual_base = false;
+    if (c > 1 && next_random (100) < this->opt.mi_percent) {
+        int b = (int) next_random ((uint32_t) c);
+        bool dup = b == k.primary;
+
+        if (k.primary != -1) {
+            const class_t &p = this->classes[k.primary];
+            for (size_t i = 0; i < p.bases.size () && !dup; i++) {
+                dup = p.bases[i].cls == b;
+            }
+            for (size_t i = 0; i < this->classes[b].bases.size () && !dup; i++) {
+                dup = this->classes[b].bases[i].cls == k.primary;
+            }
+        }
+
+        if (!dup) {
+            k.second = b;
+            k.virtual_base = next_random (100) < this->opt.vi_percent;
+        }
+    }
+
+    // Object layout : primary subobject, members, [vbptr], second subobject
+    k.size = (k.primary != -1 ? this->classes[k.primary].size : 4) + 4 * next_random (4);
+    uint32_t secondOffset = 0;
+    int32_t vbptr = -1;
+    if (k.second != -1) {
+        if (k.virtual_base) {
+            vbptr = (int32_t) k.size;
+            k.size += 4;
+        }
+        secondOffset = k.size;
+        k.size += this->classes[k.second].size;
+    }
+
+    base_t self = { c, 0, -1, 0 };
+    k.bases.push_back (self);
+    if (k.primary != -1) {
+        const class_t &p = this->classes[k.primary];
+        k.bases.insert (k.bases.end (), p.bases.begin (), p.bases.end ());
+    }
+    if (k.second != -1) {
+        const class_t &s = this->classes[k.second];
+        for (size_t i = 0; i < s.bases.size (); i++) {
+            base_t b = s.bases[i];
+            if (k.virtual_base) {
+                b.pdisp = vbptr;
+                b.vdisp = 4;
+            }
+            else {
+                b.mdisp += (int32_t) secondOffset;
+            }
+            k.bases.push_back (b);
+        }
+    }
+
+    k.td = new_symbol ();
+    k.chd = new_symbol ();
+    k.bca = new_symbol ();
+    k.ctor = new_symbol ();
+    k.dtor = new_symbol ();
+    k.sdd = new_symbol ();
+    k.iat = -1;
+
+    // Primary vftable : inherited slots, some of them overridden, then the new methods
+    vftable_t primary;
+    primary.symbol = new_symbol ();
+    primary.col = new_symbol ();
+    primary.offset = 0;
+    primary.base = -1;
+
+    if (k.primary != -1) {
+        const std::vector<slot_t> &inherited = this->classes[k.primary].vftables[0].slots;
+        for (size_t i = 0; i < inherited.size (); i++) {
+            slot_t slot = { inherited[i].target, SLOT_INHERITED };
+            if (i > 0 && next_random (100) < this->opt.override_percent) {
+                slot.target = emit_method ();
+                slot.kind = SLOT_OWN;
+            }
+            primary.slots.push_back (slot);
+        }
+    }
+    else {
+        slot_t slot = { -1, SLOT_DTOR };
+        primary.slots.push_back (slot);
+    }
+    primary.slots[0].target = k.sdd;
+    primary.slots[0].kind = SLOT_DTOR;
+
+    uint32_t span = this->opt.max_methods >= this->opt.min_methods ? this->opt.max_methods - this->opt.min_methods + 1 : 1;
+    uint32_t added = this->opt.min_methods + next_random (span);
+    for (uint32_t i = 0; i < added; i++) {
+        slot_t slot;
+        if (next_random (100) < this->opt.icf_percent) {
+            slot.target = this->icf_pool[next_random (CORPUS_ICF_POOL)];
+            slot.kind = SLOT_ICF;
+        }
+        else {
+            slot.target = emit_method ();
+            slot.kind = SLOT_OWN;
+        }
+        primary.slots.push_back (slot);
+    }
+    k.vftables.push_back (primary);
+
+    // Secondary vftables, the destructor and the overrides go through thunks
+    for (int from = 0; from < 2; from++)
+    {
+        int b = from == 0 ? k.primary : k.second;
+        if (b == -1) {
+            continue;
+        }
+
+        const class_t &base = this->classes[b];
+        for (size_t v = from == 0 ? 1 : 0; v < base.vftables.size (); v++)
+        {
+            vftable_t sec;
+            sec.symbol = new_symbol ();
+            sec.col = new_symbol ();
+            sec.offset = base.vftables[v].offset + (from == 0 ? 0 : secondOffset);
+            sec.base = base.vftables[v].base != -1 ? base.vftables[v].base : b;
+
+            for (size_t i = 0; i < base.vftables[v].slots.size (); i++) {
+                slot_t slot = { base.vftables[v].slots[i].target, SLOT_INHERITED };
+                if (i == 0) {
+                    slot.target = emit_thunk (sec.offset, k.sdd);
+                    slot.kind = SLOT_THUNK;
+                }
+                else if (next_random (100) < this->opt.override_percent) {
+                    slot.target = emit_thunk (sec.offset, emit_method ());
+                    slot.kind = SLOT_THUNK;
+                }
+                sec.slots.push_back (slot);
+            }
+            k.vftables.push_back (sec);
+        }
+    }
+
+    // Constructor and destructor store the vftables, the destructor then chains to the base one
+    align (SEC_TEXT, 16, 0xCC);
+    define (k.ctor, SEC_TEXT);
+    emit (SEC_TEXT, "8BC1");
+    emit_vftable_stores (c, 0);
+    emit (SEC_TEXT, "C3");
+
+    align (SEC_TEXT, 16, 0xCC);
+    define (k.dtor, SEC_TEXT);
+    emit_vftable_stores (c, 1);
+    if (k.primary != -1) {
+        emit (SEC_TEXT, "E9");
+        emit_rel (SEC_TEXT, this->classes[k.primary].dtor);
+    }
+    else {
+        emit (SEC_TEXT, "C3");
+    }
+
+    // Classes with a virtual base get the vbase adjusting destructors
+    if (k.virtual_base) {
+        k.shape = next_random (2) == 0 ? DTOR_LEA8 : DTOR_LEA32;
+    }
+    else {
+        k.shape = (int) next_random (DTOR_LEA8);
+    }
+    emit_sdd (c, k.shape);
+}
+
+void
+CorpusGen::emit_rtti (
+    int c
+) {
+    const class_t &k = this->classes[c];
+
+    // TypeDescriptor, in .data as its spare field is written at runtime
+    align (SEC_DATA, 4, 0);
+    define (k.td, SEC_DATA);
+    emit_abs (SEC_DATA, this->type_info_vftable);
+    emit32 (SEC_DATA, 0);
+    std::string decorated = ".?AV" + k.name + "@@";
+    this->sections[SEC_DATA].bytes.insert (this->sections[SEC_DATA].bytes.end (), decorated.begin (), decorated.end ());
+    this->sections[SEC_DATA].bytes.push_back (0);
+
+    if (k.iat != -1) {
+        align (SEC_DATA, 4, 0);
+        define (k.iat, SEC_DATA);
+        emit_abs (SEC_DATA, k.dtor);
+    }
+
+    // ClassHierarchyDescriptor
+    uint32_t attributes = 0;
+    if (k.second != -1) {
+        attributes |= k.virtual_base ? 3 : 1;
+    }
+
+    define (k.chd, SEC_RDATA);
+    emit32 (SEC_RDATA, 0);
+    emit32 (SEC_RDATA, attributes);
+    emit32 (SEC_RDATA, (uint32_t) k.bases.size ());
+    emit_abs (SEC_RDATA, k.bca);
+
+    // BaseClassDescriptors then the BaseClassArray pointing to them
+    std::vector<int> bcds;
+    for (size_t i = 0; i < k.bases.size (); i++)
+    {
+        const class_t &b = this->classes[k.bases[i].cls];
+
+        bcds.push_back (here (SEC_RDATA));
+        emit_abs (SEC_RDATA, b.td);
+        emit32 (SEC_RDATA, (uint32_t) b.bases.size () - 1);
+        emit32 (SEC_RDATA, (uint32_t) k.bases[i].mdisp);
+        emit32 (SEC_RDATA, (uint32_t) k.bases[i].pdisp);
+        emit32 (SEC_RDATA, (uint32_t) k.bases[i].vdisp);
+        emit32 (SEC_RDATA, 0x40);
+        emit_abs (SEC_RDATA, b.chd);
+    }
+
+    define (k.bca, SEC_RDATA);
+    for (size_t i = 0; i < bcds.size (); i++) {
+        emit_abs (SEC_RDATA, bcds[i]);
+    }
+    emit32 (SEC_RDATA, 0);
+
+    // One CompleteObjectLocator per vftable, followed by the vftable itself
+    for (size_t v = 0; v < k.vftables.size (); v++)
+    {
+        const vftable_t &vt = k.vftables[v];
+
+        define (vt.col, SEC_RDATA);
+        emit32 (SEC_RDATA, 0);
+        emit32 (SEC_RDATA, vt.offset);
+        emit32 (SEC_RDATA, 0);
+        emit_abs (SEC_RDATA, k.td);
+        emit_abs (SEC_RDATA, k.chd);
+
+        emit_abs (SEC_RDATA, vt.col);
+        define (vt.symbol, SEC_RDATA);
+        for (size_t i = 0; i < vt.slots.size (); i++) {
+            emit_abs (SEC_RDATA, vt.slots[i].target);
+        }
+    }
+}
+
+void
+CorpusGen::generate (
+    void
+) {
+    // Runtime functions shared by every class
+    align (SEC_TEXT, 16, 0xCC);
+    this->op_delete = here (SEC_TEXT);
+    emit (SEC_TEXT, "C3");
+
+    align (SEC_TEXT, 16, 0xCC);
+    this->vec_iterator = here (SEC_TEXT);
+    emit (SEC_TEXT, "C21000");
+
+    for (int i = 0; i < CORPUS_ICF_POOL; i++) {
+        align (SEC_TEXT, 16, 0xCC);
+        this->icf_pool[i] = here (SEC_TEXT);
+        emit (SEC_TEXT, ICF_BODIES[i]);
+    }
+
+    // type_info::`vftable', no locator in front of it
+    int typeInfoDtor = emit_method ();
+    emit32 (SEC_RDATA, 0);
+    this->type_info_vftable = here (SEC_RDATA);
+    emit_abs (SEC_RDATA, typeInfoDtor);
+
+    this->classes.resize (this->opt.classes);
+    for (uint32_t c = 0; c < this->opt.classes; c++) {
+        build_class ((int) c);
+    }
+
+    for (uint32_t c = 0; c < this->opt.classes; c++) {
+        emit_rtti ((int) c);
+    }
+
+    // Entry point constructing and destroying one object of every class,
+    // so that the auto analysis reaches all the code
+    align (SEC_TEXT, 16, 0xCC);
+    this->entry = here (SEC_TEXT);
+    for (size_t c = 0; c < this->classes.size (); c++) {
+        emit (SEC_TEXT, "E8");
+        emit_rel (SEC_TEXT, this->classes[c].ctor);
+        emit (SEC_TEXT, "E8");
+        emit_rel (SEC_TEXT, this->classes[c].dtor);
+    }
+    emit (SEC_TEXT, "33C0C3");
+
+    layout ();
+}
+
+void
+CorpusGen::layout (
+    void
+) {
+    uint32_t rva = CORPUS_SECTION_ALIGN;
+    for (int s = 0; s < SEC_COUNT; s++) {
+        if (this->sections[s].bytes.empty ()) {
+            this->sections[s].bytes.push_back (0);
+        }
+        this->sections[s].rva = rva;
+        rva += ((uint32_t) this->sections[s].bytes.size () + CORPUS_SECTION_ALIGN - 1) & ~(CORPUS_SECTION_ALIGN - 1);
+    }
+
+    for (size_t i = 0; i < this->fixups.size (); i++)
+    {
+        const fixup_t &fix = this->fixups[i];
+        uint32_t site = CORPUS_IMAGE_BASE + this->sections[fix.sec].rva + fix.off;
+        uint32_t value = va (fix.target);
+
+        if (fix.rel) {
+            value -= site + 4;
+        }
+
+        uint8_t *p = &this->sections[fix.sec].bytes[fix.off];
+        for (int b = 0; b < 4; b++) {
+            p[b] = (uint8_t) (value >> (b * 8));
+        }
+    }
+}
+
+uint32_t
+CorpusGen::va (
+    int symbol
+) const {
+    const symbol_t &sym = this->symbols[symbol];
+    if (sym.sec < 0) {
+        fprintf (stderr, "CorpusGen: symbol %d never defined\n", symbol);
+        return 0;
+    }
+
+    return CORPUS_IMAGE_BASE + this->sections[sym.sec].rva + sym.off;
+}
+
+const std::vector<uint8_t> *
+CorpusGen::section (
+    const char *name,
+    uint32_t *va
+) const {
+    for (int s = 0; s < SEC_COUNT; s++) {
+        if (strcmp (this->sections[s].name, name) == 0) {
+            *va = CORPUS_IMAGE_BASE + this->sections[s].rva;
+            return &this->sections[s].bytes;
+        }
+    }
+
+    return NULL;
+}
+
+void
+CorpusGen::slot_targets (
+    std::vector<uint32_t> *out
+) const {
+    out->clear ();
+
+    for (size_t c = 0; c < this->classes.size (); c++) {
+        for (size_t v = 0; v < this->classes[c].vftables.size (); v++) {
+            const std::vector<slot_t> &slots = this->classes[c].vftables[v].slots;
+            for (size_t i = 0; i < slots.size (); i++) {
+                out->push_back (va (slots[i].target));
+            }
+        }
+    }
+}
+
+void
+CorpusGen::type_descriptors (
+    std::vector<uint32_t> *out
+) const {
+    out->clear ();
+
+    for (size_t c = 0; c < this->classes.size (); c++) {
+        out->push_back (va (this->classes[c].td));
+    }
+}
+
+static void
+put16 (
+    std::vector<uint8_t> &buf,
+    size_t off,
+    uint16_t value
+) {
+    buf[off] = (uint8_t) value;
+    buf[off + 1] = (uint8_t) (value >> 8);
+}
+
+static void
+put32 (
+    std::vector<uint8_t> &buf,
+    size_t off,
+    uint32_t value
+) {
+    put16 (buf, off, (uint16_t) value);
+    put16 (buf, off + 2, (uint16_t) (value >> 16));
+}
+
+bool
+CorpusGen::write_image (
+    const char *path
+) const {
+    const uint32_t peOffset = 0x80;
+    const uint32_t optOffset = peOffset + 4 + 20;
+    const uint32_t secOffset = optOffset + 0xE0;
+
+    uint32_t fileOffset[SEC_COUNT];
+    uint32_t rawSize[SEC_COUNT];
+    uint32_t fileEnd = CORPUS_HEADERS_SIZE;
+    for (int s = 0; s < SEC_COUNT; s++) {
+        fileOffset[s] = fileEnd;
+        rawSize[s] = ((uint32_t) this->sections[s].bytes.size () + CORPUS_FILE_ALIGN - 1) & ~(CORPUS_FILE_ALIGN - 1);
+        fileEnd += rawSize[s];
+    }
+
+    const section_t &last = this->sections[SEC_COUNT - 1];
+    uint32_t imageSize = last.rva + (((uint32_t) last.bytes.size () + CORPUS_SECTION_ALIGN - 1) & ~(CORPUS_SECTION_ALIGN - 1));
+
+    std::vector<uint8_t> hdr (CORPUS_HEADERS_SIZE, 0);
+
+    // IMAGE_DOS_HEADER
+    hdr[0] = 'M';
+    hdr[1] = 'Z';
+    put32 (hdr, 0x3C, peOffset);
+
+    // IMAGE_FILE_HEADER
+    memcpy (&hdr[peOffset], "PE\0\0", 4);
+    put16 (hdr, peOffset + 4, 0x14C);           // i386
+    put16 (hdr, peOffset + 6, SEC_COUNT);
+    put16 (hdr, peOffset + 20, 0xE0);           // SizeOfOptionalHeader
+    put16 (hdr, peOffset + 22, 0x0103);         // relocs stripped, executable, 32 bit
+
+    // IMAGE_OPTIONAL_HEADER32
+    put16 (hdr, optOffset, 0x10B);
+    hdr[optOffset + 2] = 12;                    // MSVC 2013 linker
+    put32 (hdr, optOffset + 4, rawSize[SEC_TEXT]);
+    put32 (hdr, optOffset + 8, rawSize[SEC_RDATA] + rawSize[SEC_DATA]);
+    put32 (hdr, optOffset + 16, va (this->entry) - CORPUS_IMAGE_BASE);
+    put32 (hdr, optOffset + 20, this->sections[SEC_TEXT].rva);
+    put32 (hdr, optOffset + 24, this->sections[SEC_RDATA].rva);
+    put32 (hdr, optOffset + 28, CORPUS_IMAGE_BASE);
+    put32 (hdr, optOffset + 32, CORPUS_SECTION_ALIGN);
+    put32 (hdr, optOffset + 36, CORPUS_FILE_ALIGN);
+    put16 (hdr, optOffset + 40, 6);             // OS version
+    put16 (hdr, optOffset + 48, 6);             // subsystem version
+    put32 (hdr, optOffset + 56, imageSize);
+    put32 (hdr, optOffset + 60, CORPUS_HEADERS_SIZE);
+    put16 (hdr, optOffset + 68, 3);             // console
+    put32 (hdr, optOffset + 72, 0x100000);
+    put32 (hdr, optOffset + 76, 0x1000);
+    put32 (hdr, optOffset + 80, 0x100000);
+    put32 (hdr, optOffset + 84, 0x1000);
+    put32 (hdr, optOffset + 92, 16);            // NumberOfRvaAndSizes, all empty
+
+    // IMAGE_SECTION_HEADERs
+    for (int s = 0; s < SEC_COUNT; s++)
+    {
+        const section_t &sec = this->sections[s];
+        uint32_t h = secOffset + s * 40;
+
+        memcpy (&hdr[h], sec.name, strlen (sec.name));
+        put32 (hdr, h + 8, (uint32_t) sec.bytes.size ());
+        put32 (hdr, h + 12, sec.rva);
+        put32 (hdr, h + 16, rawSize[s]);
+        put32 (hdr, h + 20, fileOffset[s]);
+        put32 (hdr, h + 36, sec.characteristics);
+    }
+
+    FILE *f = fopen (path, "wb");
+    if (f == NULL) {
+        return false;
+    }
+
+    // Mapped image : every section at its RVA, to be loaded as a binary file at the image base
+    std::vector<uint8_t> image;
+    if (this->opt.raw) {
+        image.assign (imageSize, 0);
+        memcpy (&image[0], &hdr[0], hdr.size ());
+        for (int s = 0; s < SEC_COUNT; s++) {
+            memcpy (&image[this->sections[s].rva], &this->sections[s].bytes[0], this->sections[s].bytes.size ());
+        }
+    }
+    else {
+        image.assign (fileEnd, 0);
+        memcpy (&image[0], &hdr[0], hdr.size ());
+        for (int s = 0; s < SEC_COUNT; s++) {
+            memcpy (&image[fileOffset[s]], &this->sections[s].bytes[0], this->sections[s].bytes.size ());
+        }
+    }
+
+    bool ok = fwrite (&image[0], 1, image.size (), f) == image.size ();
+    return fclose (f) == 0 && ok;
+}
+
+bool
+CorpusGen::write_manifest (
+    const char *path,
+    const char *imagePath
+) const {
+    FILE *f = fopen (path, "w");
+    if (f == NULL) {
+        return false;
+    }
+
+    size_t vftableCount = 0;
+    size_t slotCount = 0;
+    for (size_t c = 0; c < this->classes.size (); c++) {
+        vftableCount += this->classes[c].vftables.size ();
+        for (size_t v = 0; v < this->classes[c].vftables.size (); v++) {
+            slotCount += this->classes[c].vftables[v].slots.size ();
+        }
+    }
+
+    fprintf (f, "# RECPP synthetic corpus\n");
+    fprintf (f, "# seed %u classes %u depth %u methods %u-%u mi %u%% vi %u%% icf %u%% override %u%%\n",
+             this->opt.seed, this->opt.classes, this->opt.max_depth, this->opt.min_methods, this->opt.max_methods,
+             this->opt.mi_percent, this->opt.vi_percent, this->opt.icf_percent, this->opt.override_percent);
+    fprintf (f, "image %s base 0x%X format %s\n", imagePath, CORPUS_IMAGE_BASE, this->opt.raw ? "raw" : "pe");
+    fprintf (f, "totals classes %u vftables %u slots %u\n",
+             (unsigned) this->classes.size (), (unsigned) vftableCount, (unsigned) slotCount);
+
+    for (size_t c = 0; c < this->classes.size (); c++)
+    {
+        const class_t &k = this->classes[c];
+
+        fprintf (f, "class %s td 0x%X chd 0x%X bases %u primary %s second %s virtual %d size %u shape %s sdd 0x%X dtor 0x%X ctor 0x%X\n",
+                 k.name.c_str (), va (k.td), va (k.chd), (unsigned) k.bases.size (),
+                 k.primary != -1 ? this->classes[k.primary].name.c_str () : "-",
+                 k.second != -1 ? this->classes[k.second].name.c_str () : "-",
+                 k.virtual_base ? 1 : 0, k.size, SHAPE_NAMES[k.shape], va (k.sdd), va (k.dtor), va (k.ctor));
+
+        for (size_t v = 0; v < k.vftables.size (); v++)
+        {
+            const vftable_t &vt = k.vftables[v];
+
+            // Decorated name as the undecorated one : ??_7C3@@6B@ or ??_7C3@@6BC1@@@
+            std::string decorated = "??_7" + k.name + "@@6B";
+            if (vt.base != -1) {
+                decorated += this->classes[vt.base].name + "@@";
+            }
+            decorated += "@";
+
+            fprintf (f, "vftable %s 0x%X col 0x%X offset %u slots %u name %s\n",
+                     k.name.c_str (), va (vt.symbol), va (vt.col), vt.offset, (unsigned) vt.slots.size (), decorated.c_str ());
+
+            for (size_t i = 0; i < vt.slots.size (); i++) {
+                fprintf (f, "slot 0x%X %u 0x%X %s\n",
+                         va (vt.symbol), (unsigned) i, va (vt.slots[i].target), KIND_NAMES[vt.slots[i].kind]);
+            }
+        }
+    }
+
+    return fclose (f) == 0;
+}
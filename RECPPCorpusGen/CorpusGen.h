@@ -0,0 +1,316 @@
+﻿/*
+    ██████╗ ███████╗ ██████╗██████╗ ██████╗ 
+    ██╔══██╗██╔════╝██╔════╝██╔══██╗██╔══██╗
+    ██████╔╝█████╗  ██║     ██████╔╝██████╔╝
+    ██╔══██╗██╔══╝  ██║     ██╔═══╝ ██╔═══╝ 
+    ██║  ██║███████╗╚██████╗██║     ██║     
+    ╚═╝  ╚═╝╚══════╝ ╚═════╝╚═╝     ╚═╝     
+* @license : <license placeholder>
+*/
+
+#pragma once
+
+
+// ---------- Includes ------------
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+// ---------- Defines -------------
+#define CORPUS_IMAGE_BASE    0x400000
+#define CORPUS_SECTION_ALIGN 0x1000
+#define CORPUS_FILE_ALIGN    0x200
+#define CORPUS_HEADERS_SIZE  0x400
+#define CORPUS_ICF_POOL      8
+
+
+// ------ Class definition --------
+// Generator of synthetic x86 MSVC images, for repeatable scanner runs.
+//
+// Every class gets what the MSVC compiler would emit for it : type
+// descriptor in .data; complete object locator, class hierarchy descriptor,
+// base class array and descriptors in .rdata, followed by its vftables;
+// and in .text its methods, a constructor and destructor storing the
+// vftable pointers, and a `scalar deleting destructor' in one of the
+// shapes Vtable::checkSDD recognizes. Secondary vftables of multiple and
+// virtual inheritance go through adjustor thunks, some slots are shared
+// between classes (identical COMDAT folding).
+//
+// The expected result is written to a manifest along with the image.
+class CorpusGen
+{
+public:
+    struct options_t
+    {
+        uint32_t classes;
+        uint32_t max_depth;         // longest chain of primary bases
+        uint32_t min_methods;       // new virtual methods per class
+        uint32_t max_methods;
+        uint32_t mi_percent;        // classes with a second base
+        uint32_t vi_percent;        // of which the second base is virtual
+        uint32_t icf_percent;       // new slots pointing to a shared function
+        uint32_t override_percent;  // inherited slots overridden
+        uint32_t seed;
+        bool raw;                   // mapped image instead of a PE file
+    };
+
+    // `scalar deleting destructor' shapes, as matched by Vtable::checkSDD
+    enum dtor_shape_t
+    {
+        DTOR_CALL,          // call ~class, test flags, call delete
+        DTOR_IMPORT,        // same with a dllimport ~class
+        DTOR_FRAME,         // debug build, ebp frame
+        DTOR_FRAME_SHORT,   // same, operator delete without cdecl cleanup
+        DTOR_INLINE_TEST,   // inlined ~class, test [esp+4] first
+        DTOR_INLINE_AL,     // inlined ~class, flags read in al
+        DTOR_INLINE_CALL,   // vftable store then call to the base ~class
+        DTOR_JMP,           // incremental linking jmp to a DTOR_CALL body
+        DTOR_VECTOR,        // `vector deleting destructor'
+        DTOR_LEA8,          // virtual base adjustment, 8 bit displacements
+        DTOR_LEA32,         // same with 32 bit displacements
+        DTOR_COUNT
+    };
+
+    static void
+    default_options (
+        options_t *opt
+    );
+
+    CorpusGen (const options_t &opt);
+
+    /*
+     * @brief : Build the classes and the image
+     */
+    void
+    generate (
+        void
+    );
+
+    /*
+     * @brief : Write the image (PE, or mapped image if options_t::raw)
+     * @return false on I/O error
+     */
+    bool
+    write_image (
+        const char *path
+    ) const;
+
+    /*
+     * @brief : Write the ground truth : every class, vftable, RTTI record and slot
+     * @return false on I/O error
+     */
+    bool
+    write_manifest (
+        const char *path,
+        const char *imagePath
+    ) const;
+
+    /*
+     * @brief : Contents and address of a generated section (".text", ".rdata", ".data")
+     * @return NULL if there is no such section
+     */
+    const std::vector<uint8_t> *
+    section (
+        const char *name,
+        uint32_t *va
+    ) const;
+
+    /*
+     * @brief : Every function referenced by a vftable slot, once per slot
+     */
+    void
+    slot_targets (
+        std::vector<uint32_t> *out
+    ) const;
+
+    /*
+     * @brief : Address of every type descriptor
+     */
+    void
+    type_descriptors (
+        std::vector<uint32_t> *out
+    ) const;
+
+    static const char *
+    shape_name (
+        int shape
+    );
+
+private:
+    enum section_id_t { SEC_TEXT, SEC_RDATA, SEC_DATA, SEC_COUNT };
+
+    struct section_t
+    {
+        const char *name;
+        uint32_t characteristics;
+        uint32_t rva;
+        std::vector<uint8_t> bytes;
+    };
+
+    // Address in a section, known once the section was emitted
+    struct symbol_t
+    {
+        int sec;
+        uint32_t off;
+    };
+
+    struct fixup_t
+    {
+        int sec;
+        uint32_t off;
+        int target;     // symbol
+        bool rel;       // rel32 from the end of the field, absolute VA otherwise
+    };
+
+    enum slot_kind_t { SLOT_OWN, SLOT_INHERITED, SLOT_ICF, SLOT_THUNK, SLOT_DTOR };
+
+    struct slot_t
+    {
+        int target;     // symbol of the function
+        int kind;
+    };
+
+    struct vftable_t
+    {
+        int symbol;
+        int col;
+        uint32_t offset;    // of the subobject in the class
+        int base;           // class whose layout this vftable follows, -1 for the primary one
+        std::vector<slot_t> slots;
+    };
+
+    struct base_t
+    {
+        int cls;
+        int32_t mdisp;
+        int32_t pdisp;      // -1 unless reached through a virtual base
+        int32_t vdisp;
+    };
+
+    struct class_t
+    {
+        std::string name;
+        int primary;        // base class sharing the primary vftable, or -1
+        int second;         // second base, or -1
+        bool virtual_base;  // the second base is virtual
+        int depth;
+        int shape;
+        uint32_t size;      // object size
+
+        std::vector<vftable_t> vftables;
+        std::vector<base_t> bases;      // flattened, self first (base class array order)
+
+        int td, chd, bca;
+        int ctor, dtor, sdd, iat;
+    };
+
+    options_t opt;
+    uint32_t rng;
+
+    section_t sections[SEC_COUNT];
+    std::vector<symbol_t> symbols;
+    std::vector<fixup_t> fixups;
+    std::vector<class_t> classes;
+
+    // Shared functions
+    int op_delete, vec_iterator, type_info_vftable;
+    int icf_pool[CORPUS_ICF_POOL];
+    int entry;
+    uint32_t method_count;
+
+    uint32_t
+    next_random (
+        uint32_t range
+    );
+
+    int
+    new_symbol (
+        void
+    );
+
+    void
+    define (
+        int symbol,
+        int sec
+    );
+
+    int
+    here (
+        int sec
+    );
+
+    void
+    emit (
+        int sec,
+        const char *hex
+    );
+
+    void
+    emit32 (
+        int sec,
+        uint32_t value
+    );
+
+    void
+    emit_abs (
+        int sec,
+        int target
+    );
+
+    void
+    emit_rel (
+        int sec,
+        int target
+    );
+
+    void
+    align (
+        int sec,
+        uint32_t alignment,
+        uint8_t fill
+    );
+
+    void
+    build_class (
+        int c
+    );
+
+    int
+    emit_method (
+        void
+    );
+
+    int
+    emit_thunk (
+        uint32_t adjust,
+        int target
+    );
+
+    void
+    emit_vftable_stores (
+        int c,
+        uint8_t reg
+    );
+
+    void
+    emit_sdd (
+        int c,
+        int shape
+    );
+
+    void
+    emit_rtti (
+        int c
+    );
+
+    void
+    layout (
+        void
+    );
+
+    uint32_t
+    va (
+        int symbol
+    ) const;
+};
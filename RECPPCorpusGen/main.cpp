@@ -0,0 +1,117 @@
+﻿/*
+    ██████╗ ███████╗ ██████╗██████╗ ██████╗ 
+    ██╔══██╗██╔════╝██╔════╝██╔══██╗██╔══██╗
+    ██████╔╝█████╗  ██║     ██████╔╝██████╔╝
+    ██╔══██╗██╔══╝  ██║     ██╔═══╝ ██╔═══╝ 
+    ██║  ██║███████╗╚██████╗██║     ██║     
+    ╚═╝  ╚═╝╚══════╝ ╚═════╝╚═╝     ╚═╝     
+* @license : <license placeholder>
+*/
+
+#include "CorpusGen.h"
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+
+static void
+usage (
+    void
+) {
+    CorpusGen::options_t opt;
+    CorpusGen::default_options (&opt);
+
+    printf ("usage: RECPPCorpusGen [options] <image>\n");
+    printf ("  --classes N         number of classes (%u)\n", opt.classes);
+    printf ("  --depth N           longest primary inheritance chain (%u)\n", opt.max_depth);
+    printf ("  --methods MIN MAX   new virtual methods per class (%u %u)\n", opt.min_methods, opt.max_methods);
+    printf ("  --mi PCT            classes with a second base (%u)\n", opt.mi_percent);
+    printf ("  --vi PCT            second bases that are virtual (%u)\n", opt.vi_percent);
+    printf ("  --icf PCT           new slots folded into shared functions (%u)\n", opt.icf_percent);
+    printf ("  --override PCT      inherited slots overridden (%u)\n", opt.override_percent);
+    printf ("  --seed N            random seed (%u)\n", opt.seed);
+    printf ("  --raw               mapped image, to load as a binary file at 0x%X\n", CORPUS_IMAGE_BASE);
+    printf ("  --manifest PATH     ground truth (<image>.manifest)\n");
+}
+
+int
+main (
+    int argc,
+    char **argv
+) {
+    CorpusGen::options_t opt;
+    CorpusGen::default_options (&opt);
+
+    const char *image = NULL;
+    std::string manifest;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char *arg = argv[i];
+        bool more = i + 1 < argc;
+
+        if (!strcmp (arg, "--classes") && more) {
+            opt.classes = (uint32_t) strtoul (argv[++i], NULL, 0);
+        }
+        else if (!strcmp (arg, "--depth") && more) {
+            opt.max_depth = (uint32_t) strtoul (argv[++i], NULL, 0);
+        }
+        else if (!strcmp (arg, "--methods") && i + 2 < argc) {
+            opt.min_methods = (uint32_t) strtoul (argv[++i], NULL, 0);
+            opt.max_methods = (uint32_t) strtoul (argv[++i], NULL, 0);
+        }
+        else if (!strcmp (arg, "--mi") && more) {
+            opt.mi_percent = (uint32_t) strtoul (argv[++i], NULL, 0);
+        }
+        else if (!strcmp (arg, "--vi") && more) {
+            opt.vi_percent = (uint32_t) strtoul (argv[++i], NULL, 0);
+        }
+        else if (!strcmp (arg, "--icf") && more) {
+            opt.icf_percent = (uint32_t) strtoul (argv[++i], NULL, 0);
+        }
+        else if (!strcmp (arg, "--override") && more) {
+            opt.override_percent = (uint32_t) strtoul (argv[++i], NULL, 0);
+        }
+        else if (!strcmp (arg, "--seed") && more) {
+            opt.seed = (uint32_t) strtoul (argv[++i], NULL, 0);
+        }
+        else if (!strcmp (arg, "--raw")) {
+            opt.raw = true;
+        }
+        else if (!strcmp (arg, "--manifest") && more) {
+            manifest = argv[++i];
+        }
+        else if (arg[0] != '-' && image == NULL) {
+            image = arg;
+        }
+        else {
+            usage ();
+            return 1;
+        }
+    }
+
+    if (image == NULL || opt.classes == 0) {
+        usage ();
+        return 1;
+    }
+
+    if (manifest.empty ()) {
+        manifest = std::string (image) + ".manifest";
+    }
+
+    CorpusGen gen (opt);
+    gen.generate ();
+
+    if (!gen.write_image (image)) {
+        fprintf (stderr, "Cannot write %s\n", image);
+        return 2;
+    }
+
+    if (!gen.write_manifest (manifest.c_str (), image)) {
+        fprintf (stderr, "Cannot write %s\n", manifest.c_str ());
+        return 2;
+    }
+
+    printf ("%s : %u classes, manifest %s\n", image, opt.classes, manifest.c_str ());
+    return 0;
+}